@@ -0,0 +1,73 @@
+#pragma once
+
+#include <optional>
+#include <cstdint>
+#include <string>
+
+#include "utils.h"
+
+namespace ares {
+
+// Stable hashes of the ABI of classes and JARs, so that a build can skip the downstream modules of a JAR whose ABI
+// didn't change. The ABI is the public and protected surface: the access flags, names, superclass and interfaces of
+// a class, the access flags, names and descriptors of its public and protected members, and their generic
+// signatures, constant values, thrown exceptions, annotations and annotation defaults. Private and package-private
+// members, code, debug attributes and the order of members, interfaces and attributes don't affect the hashes.
+//
+// The hash is computed in a single pass over the class bytes, which only keeps the offsets of the constant pool
+// entries and never builds a ClassFile. Constants are hashed by value, so a different constant pool layout alone
+// gives the same hash.
+class ABIFingerprint {
+public:
+    struct ClassHash {
+        uint64_t hash{};
+        // Public classes, only they are part of the ABI of their JAR.
+        bool exported{};
+    };
+
+public:
+    // Returns std::nullopt if the bytes aren't a well-formed class file.
+    [[nodiscard]] static auto hash_class(const uint8_t *data, size_t size) -> std::optional<ClassHash>;
+
+    // Combines the hashes of the exported classes independent of their order. The classes are inflated and hashed
+    // on up to thread_count threads, each reading the archive through its own ZIP handle. Throws
+    // std::runtime_error if the archive or one of its classes can't be read.
+    [[nodiscard]] static auto hash_jar(const std::string &path, unsigned int thread_count = 0) -> uint64_t;
+
+    // Hashes the classes by the bytes they were read from. Like with a path, the classes of nested JARs are left out.
+    [[nodiscard]] static auto hash_jar(const JARFile &jar_file, unsigned int thread_count = 0) -> uint64_t;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
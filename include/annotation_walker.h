@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string_view>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace ares {
+
+// Walks the annotation attributes (JVMS 4.7.16 to 4.7.22) and reports the constant pool indices in them, for the
+// code that collects, renumbers or rewrites the constants that annotations refer to.
+class AnnotationWalker {
+public:
+    // What the u2 constant pool index at an offset stands for.
+    enum Index : uint8_t {
+        // The field descriptor of an annotation type.
+        TYPE,
+        ELEMENT_NAME,
+        // The value of a primitive element.
+        CONSTANT,
+        // The UTF-8 constant of a String element.
+        STRING,
+        // The return descriptor of a Class element, like "Ljava/lang/Object;" or "V".
+        CLASS,
+        ENUM_TYPE,
+        ENUM_CONSTANT,
+    };
+
+    // Called with the offset of the index in the attribute data.
+    using IndexVisitor = std::function<void(size_t offset, Index index)>;
+
+    [[nodiscard]] static auto handles(std::string_view name) -> bool;
+
+    // Returns false if the attribute isn't one of the annotation attributes or is malformed, the visitor may have
+    // seen a part of it by then.
+    static auto walk(std::string_view name, std::span<const uint8_t> data, const IndexVisitor &visitor) -> bool;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <initializer_list>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <span>
+
+namespace ares {
+
+// Little-endian encoding for the on-disk formats, like the parse cache and the cross-reference index. Strings are
+// prefixed by a 16 or 32 bit length.
+class BinaryWriter {
+public:
+    void write_u16(uint16_t value);
+
+    void write_u32(uint32_t value);
+
+    void write_u64(uint64_t value);
+
+    void write_string16(std::string_view value);
+
+    void write_string32(std::string_view value);
+
+    auto bytes() -> std::vector<uint8_t> &;
+
+private:
+    std::vector<uint8_t> _bytes{};
+};
+
+// Reads what the BinaryWriter wrote, each read returns false instead of running past the end of the data.
+class BinaryReader {
+public:
+    BinaryReader(const uint8_t *data, size_t size);
+
+    auto read_u16(uint16_t &value) -> bool;
+
+    auto read_u32(uint32_t &value) -> bool;
+
+    auto read_u64(uint64_t &value) -> bool;
+
+    auto read_string16(std::string &value) -> bool;
+
+    auto read_string32(std::string &value) -> bool;
+
+    // Reads a count of items that take at least the given size each, which bounds the count by the remaining data.
+    auto read_count(uint32_t &value, size_t item_size) -> bool;
+
+    [[nodiscard]] auto at_end() const -> bool;
+
+private:
+    const uint8_t *_data;
+    size_t _size, _offset{};
+};
+
+// Writes the parts to a temporary file of this writer and renames it over the path, so that readers and concurrent
+// writers never see a partial file. The temporary file is removed if anything fails, the error names the description.
+void write_file_atomically(const std::string &path, std::initializer_list<std::span<const uint8_t>> parts,
+                           const std::string &description);
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
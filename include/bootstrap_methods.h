@@ -0,0 +1,75 @@
+#pragma once
+
+#include <optional>
+#include <cstdint>
+#include <vector>
+#include <span>
+
+namespace ares {
+
+class ClassFile;
+
+// A decoded BootstrapMethods attribute (JVMS 4.7.23). The static arguments of all methods are stored back to back
+// with an offset per method, so resolving a bootstrap method is two array accesses.
+class BootstrapMethods {
+public:
+    struct Method {
+        uint16_t method_ref{};
+        std::span<const uint16_t> arguments{};
+    };
+
+public:
+    // Returns nullopt if the attribute is malformed or present more than once. A class without the attribute gives
+    // an empty table.
+    [[nodiscard]] static auto read(const ClassFile &class_file) -> std::optional<BootstrapMethods>;
+
+    [[nodiscard]] auto present() const -> bool;
+
+    [[nodiscard]] auto size() const -> size_t;
+
+    [[nodiscard]] auto method(size_t index) const -> Method;
+
+    // Resolves a DYNAMIC or INVOKE_DYNAMIC constant, like the operand of an invokedynamic instruction, to the
+    // bootstrap method it names.
+    [[nodiscard]] auto of_constant(const ClassFile &class_file, uint16_t index) const -> std::optional<Method>;
+
+private:
+    std::vector<uint16_t> _method_refs{};
+    std::vector<uint32_t> _argument_offsets{0};
+    std::vector<uint16_t> _arguments{};
+    bool _present{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
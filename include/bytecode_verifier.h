@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "vm_check.h"
+
+namespace ares {
+
+// Type checks the code of methods (JVMS 4.10): the types of the operand stack and the local variables, branch
+// targets and exception handlers. Classes from version 50 on are checked against their StackMapTable, older ones by
+// inferring the frames. Without a class hierarchy at hand, references are only checked for being references, arrays
+// and initialized objects, like the HotSpot verifier does for interfaces.
+class BytecodeVerifier {
+public:
+    // Verifies the methods of the class concurrently, reporting at most one diagnostic per method.
+    [[nodiscard]] static auto verify(ClassFile &class_file, unsigned int thread_count = 0) -> std::vector<Diagnostic>;
+
+    // Verifies the methods of all classes concurrently, the diagnostics carry the entry name of their class.
+    [[nodiscard]] static auto verify(JARFile &jar_file, unsigned int thread_count = 0) -> std::vector<Diagnostic>;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <vector>
+#include <span>
+
+#include "class_hierarchy.h"
+
+namespace ares {
+
+// A call graph over the classes of a ClassHierarchy, built from the invoke instructions in the Code attributes.
+// Static and special calls have their resolved method as the only target. Virtual and interface calls target the
+// dispatched method of every subtype of the referenced class (CHA), or only of the subtypes that are instantiated
+// somewhere in the class path (RTA). Calls into classes outside of the class path have no edges.
+//
+// invokedynamic sites are kept apart, with an edge to every method handle among their bootstrap arguments, which
+// is the implementation method of lambdas and method references.
+class CallGraph {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    enum Precision {
+        CHA,
+        RTA
+    };
+
+    struct Method {
+        uint32_t class_id{};
+        std::string_view name{};
+        std::string_view descriptor{};
+        uint16_t access_flags{};
+    };
+
+    struct DynamicSite {
+        uint32_t pc{};
+        uint16_t constant_pool_index{};
+        std::string_view name{};
+        std::string_view descriptor{};
+    };
+
+public:
+    // Scans the classes concurrently, each one writes its edges into a precomputed range of the adjacency arrays.
+    [[nodiscard]] static auto build(const ClassHierarchy &hierarchy, Precision precision = RTA,
+                                    unsigned int thread_count = 0) -> CallGraph;
+
+    [[nodiscard]] auto method_count() const -> size_t;
+
+    [[nodiscard]] auto edge_count() const -> size_t;
+
+    [[nodiscard]] auto method(uint32_t id) const -> const Method &;
+
+    // Returns NONE if the class doesn't declare the method.
+    [[nodiscard]] auto find(uint32_t class_id, std::string_view name, std::string_view descriptor) const -> uint32_t;
+
+    // The distinct methods a method may call, in ascending order.
+    [[nodiscard]] auto callees(uint32_t id) const -> std::span<const uint32_t>;
+
+    [[nodiscard]] auto dynamic_sites(uint32_t id) const -> std::span<const DynamicSite>;
+
+    [[nodiscard]] auto is_instantiated(uint32_t class_id) const -> bool;
+
+private:
+    // The methods of a class have consecutive ids, sorted by name and descriptor.
+    std::vector<uint32_t> _method_offsets{};
+    std::vector<Method> _methods{};
+
+    std::vector<uint32_t> _callee_offsets{};
+    std::vector<uint32_t> _callees{};
+    std::vector<uint32_t> _site_offsets{};
+    std::vector<DynamicSite> _sites{};
+
+    std::vector<uint8_t> _instantiated{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
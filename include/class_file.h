@@ -1,8 +1,10 @@
 #pragma once
 
 #include <unordered_map>
+#include <string_view>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <optional>
 #include <memory>
 #include <vector>
 #include <list>
@@ -19,6 +21,14 @@ class FieldInfo;
 
 class ClassFile {
 public:
+    // A field, method or dynamic reference resolved through its name and type. Dynamic references have no owner.
+    struct MemberRef {
+        std::string_view owner{};
+        std::string_view name{};
+        std::string_view descriptor{};
+        uint16_t descriptor_index{};
+    };
+
     enum AccessFlag : uint16_t {
         PUBLIC = 0x0001,
         FINAL = 0x0010,
@@ -57,6 +67,16 @@ public:
 
     [[nodiscard]] auto size() const -> unsigned int;
 
+    // Returns the bytes of the UTF-8 constant at the index, or an empty view if it isn't one.
+    [[nodiscard]] auto utf8(unsigned int index) const -> std::string_view;
+
+    // Returns the internal name of the class constant at the index, or an empty view if it isn't one.
+    [[nodiscard]] auto class_name(unsigned int index) const -> std::string_view;
+
+    // Resolves the field, method, interface method or dynamic reference at the index. Returns nullopt if it isn't
+    // one or its class, name or descriptor isn't valid.
+    [[nodiscard]] auto member_ref(unsigned int index) const -> std::optional<MemberRef>;
+
 public:
     std::vector<uint8_t> byte_code{};
 
@@ -77,6 +97,10 @@ public:
     std::vector <MethodInfo> methods{};
     uint16_t attributes_count{};
     std::vector <AttributeInfo> attributes{};
+
+    // Buffers for attributes and constants that were rewritten after reading, which point into them. They may be
+    // shared with other classes that contain the same rewritten bytes.
+    std::vector <std::shared_ptr<std::vector<uint8_t>>> owned_data{};
 };
 
 } // namespace ares
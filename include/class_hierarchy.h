@@ -0,0 +1,151 @@
+#pragma once
+
+#include <unordered_map>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include "vm_check.h"
+
+namespace ares {
+
+// An index over the this_class, super_class and interfaces of every class in a set of JARs, for the checks that
+// VMCheck can't do per class: final classes being extended, interfaces used as superclasses and classes as
+// interfaces, inheritance cycles and classes defined more than once. Classes that are only referenced (e.g. the ones
+// of the JDK) get nodes without a definition and aren't checked.
+//
+// The classes have dense ids, the interface and subtype edges are stored as CSR arrays. Classes are numbered in
+// preorder of the superclass tree, so the subclasses of a class form an interval and checking for a superclass takes
+// constant time. Each class has a sorted set of the interfaces it implements that its superclass doesn't, so checking
+// for an interface takes a binary search per superclass and the sets only take memory for what a class adds.
+class ClassHierarchy {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        std::string_view name{};
+        // The JAR and entry which defined the class first, like "app.jar!/a/B.class".
+        std::string source{};
+        uint16_t access_flags{};
+        bool defined{};
+        uint32_t super_class{NONE};
+        // The defining class file, which has to outlive the index.
+        const ClassFile *class_file{};
+    };
+
+public:
+    // Indexes the JARs, including their nested JARs, in class path order: later definitions of a class are reported
+    // as duplicates of the first one. The JARs are named by the first element of each pair.
+    [[nodiscard]] static auto build(const std::vector<std::pair<std::string, JARFile *>> &class_path,
+                                    unsigned int thread_count = 0) -> ClassHierarchy;
+
+    [[nodiscard]] auto size() const -> size_t;
+
+    [[nodiscard]] auto node(uint32_t id) const -> const Node &;
+
+    // Returns NONE for unknown names.
+    [[nodiscard]] auto find(std::string_view name) const -> uint32_t;
+
+    // Classes that are declared as interface or, if not defined, are implemented by another class.
+    [[nodiscard]] auto is_interface(uint32_t id) const -> bool;
+
+    [[nodiscard]] auto interfaces(uint32_t id) const -> std::span<const uint32_t>;
+
+    // The classes which extend or implement the class directly.
+    [[nodiscard]] auto direct_subtypes(uint32_t id) const -> std::span<const uint32_t>;
+
+    // Returns true if the first class is the second one, extends it or implements it. Inheritance cycles give
+    // arbitrary but consistent answers.
+    [[nodiscard]] auto is_subtype(uint32_t id, uint32_t super_id) const -> bool;
+
+    // All classes which are subtypes of the class, including itself, in ascending id order.
+    [[nodiscard]] auto subtypes(uint32_t id) const -> std::vector<uint32_t>;
+
+    // Runs all checks in time linear to the size of the index and returns the violations sorted by class name.
+    [[nodiscard]] auto check(unsigned int thread_count = 0) const -> std::vector<Diagnostic>;
+
+private:
+    auto _intern(std::string_view name) -> uint32_t;
+
+    void _build_index(std::vector<std::vector<uint32_t>> interfaces);
+
+    void _check_node(uint32_t id, std::vector<Diagnostic> &report) const;
+
+    void _check_cycles(std::vector<Diagnostic> &report) const;
+
+    [[nodiscard]] auto _diagnostic(uint32_t id, std::string message) const -> Diagnostic;
+
+    [[nodiscard]] auto _implements(uint32_t id, uint32_t interface) const -> bool;
+
+private:
+    // Lets find look names up by their view, instead of copying every queried name into a string first.
+    struct NameHash {
+        using is_transparent = void;
+
+        auto operator()(std::string_view name) const -> size_t {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+private:
+    // The map owns the names, its keys stay at the same address while it grows.
+    std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> _ids{};
+    std::vector<Node> _nodes{};
+    std::vector<Diagnostic> _duplicates{};
+
+    std::vector<uint32_t> _interface_offsets{0};
+    std::vector<uint32_t> _interfaces{};
+    std::vector<uint32_t> _subtype_offsets{0};
+    std::vector<uint32_t> _subtypes{};
+    std::vector<bool> _is_interface{};
+
+    // The preorder interval [_preorder[id], _preorder_end[id]) of each class in the superclass tree and the classes
+    // in preorder.
+    std::vector<uint32_t> _preorder{};
+    std::vector<uint32_t> _preorder_end{};
+    std::vector<uint32_t> _by_preorder{};
+
+    // The interfaces [_interface_set_begin[id], _interface_set_end[id]) of _interface_sets that the class implements
+    // on top of the ones of _interface_parent[id], which is its superclass or NONE on an inheritance cycle.
+    std::vector<uint32_t> _interface_sets{};
+    std::vector<uint32_t> _interface_set_begin{};
+    std::vector<uint32_t> _interface_set_end{};
+    std::vector<uint32_t> _interface_parent{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
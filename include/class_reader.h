@@ -10,13 +10,16 @@
 #include "attribute_info.h"
 #include "constant_info.h"
 #include "class_file.h"
+#include "vm_check.h"
 #include "visitor.h"
 
 namespace ares {
 
 class ClassReader : Visitor {
 public:
-    explicit ClassReader(unsigned int offset = 0u);
+    // With verify set, the structural rules of the VMCheck are applied to each section right after it got decoded,
+    // instead of traversing the whole class file a second time afterwards.
+    explicit ClassReader(unsigned int offset = 0u, bool verify = false);
 
 public:
     void visit_class(ClassFile &class_info) override;
@@ -94,7 +97,9 @@ private:
     auto read_u8_array(uint8_t *data, unsigned int length, ClassFile &class_info) -> bool;
 
 private:
+    VMCheck _vm_check{};
     unsigned int _offset{};
+    bool _verify{};
 };
 
 } // namespace ares
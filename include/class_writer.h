@@ -13,6 +13,9 @@ public:
 
     [[nodiscard]] auto byte_code() const -> const std::vector<uint8_t > &;
 
+    // Serializes the class into its byte_code, so that the byte based APIs see a transformed class.
+    static void update_byte_code(ClassFile &class_file);
+
 private:
     void visit_classpool_info(ClassFile &class_info, ConstantPoolInfo &info) override;
 
@@ -29,13 +32,13 @@ private:
     void visit_method_attribute(ClassFile &class_info, MethodInfo &method_info, AttributeInfo &attribute_info) override;
 
 private:
-    auto write_u8(uint8_t & data, ClassFile &class_file) -> bool;
+    auto write_u8(uint8_t & data) -> bool;
 
-    auto write_u32(uint32_t & data, ClassFile &class_file) -> bool;
+    auto write_u32(uint32_t & data) -> bool;
 
-    auto write_u16(uint16_t & data, ClassFile &class_file) -> bool;
+    auto write_u16(uint16_t & data) -> bool;
 
-    auto write_u8_array(uint8_t *data, unsigned int data_size, ClassFile &class_file) -> bool;
+    auto write_u8_array(uint8_t *data, unsigned int data_size) -> bool;
 
 private:
     unsigned int _offset{}, _size{};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string_view>
+#include <functional>
+#include <cstdint>
+#include <span>
+
+namespace ares {
+
+class ClassFile;
+
+// Removes unreferenced constant pool entries and renumbers the rest. The indices stored inside of attributes are
+// found by decoding the attributes, so classes with attributes that aren't known here keep their constant pool.
+class ConstantPoolCompactor {
+public:
+    // Called with the offset of a constant pool index in the attribute data. Indices are u2, except for the u1
+    // operand of ldc.
+    using IndexVisitor = std::function<void(size_t offset, bool wide)>;
+
+    // Visits the indices of an attribute, including the names of nested attributes. Returns false if the attribute
+    // isn't known or is malformed.
+    static auto visit_indices(const ClassFile &class_file, std::string_view name, std::span<const uint8_t> data,
+                              const IndexVisitor &visitor) -> bool;
+
+    // Returns the number of removed constant pool slots. The byte_code of the class is refreshed if any were.
+    static auto compact(ClassFile &class_file) -> size_t;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
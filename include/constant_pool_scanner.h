@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace ares {
+
+// Locates the constant pool entries in the bytes of a class without decoding them, for the paths that read classes
+// straight from their bytes.
+class ConstantPoolScanner {
+public:
+    [[nodiscard]] static auto read_u16(const uint8_t *data) -> uint16_t {
+        return static_cast<uint16_t>(data[0] << 8 | data[1]);
+    }
+
+    // Scans the pool whose count is at the offset. Returns the offset past the pool, or nullopt if it is malformed.
+    [[nodiscard]] auto scan(const uint8_t *data, size_t size, size_t offset = 8) -> std::optional<size_t>;
+
+    [[nodiscard]] auto count() const -> size_t {
+        return _offsets.size();
+    }
+
+    // The tag of the entry, 0 for index 0, indices past the pool and the second slots of LONG and DOUBLE entries.
+    [[nodiscard]] auto tag(size_t index) const -> uint8_t {
+        return index < _offsets.size() && _offsets[index] != 0 ? _data[_offsets[index]] : 0;
+    }
+
+    // The bytes of the entry after its tag.
+    [[nodiscard]] auto payload(size_t index) const -> const uint8_t * {
+        return _data + _offsets[index] + 1;
+    }
+
+    // The u2 at the position of the entry, like the name index of a CLASS or the descriptor index of a NAME_AND_TYPE.
+    [[nodiscard]] auto operand(size_t index, size_t position) const -> uint16_t {
+        return read_u16(payload(index) + position * 2);
+    }
+
+    // Returns false if the entry isn't UTF-8.
+    auto utf8(size_t index, std::string_view &value) const -> bool;
+
+    // The internal name of the class constant, empty for index 0 like the superclass of java/lang/Object.
+    auto class_name(size_t index, std::string_view &value) const -> bool;
+
+private:
+    const uint8_t *_data{};
+    std::vector<uint32_t> _offsets{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
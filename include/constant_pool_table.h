@@ -0,0 +1,101 @@
+#pragma once
+
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ares {
+
+class ConstantPoolInfo;
+
+class ClassFile;
+
+// The constant pool as packed arrays: a tag byte and two reference operands per entry, indexed like the constant
+// pool itself. Index 0 and the second slots of LONG and DOUBLE entries are UNDEFINED. Validating the references is
+// then a bulk range check, gather and compare over the arrays instead of a switch per entry, which runs eight
+// entries at a time with AVX2 where the CPU supports it.
+class ConstantPoolTable {
+public:
+    enum Violation : uint8_t {
+        FIRST = 0x01,
+        SECOND = 0x02
+    };
+
+    struct Result {
+        uint16_t index{};
+        uint8_t violations{};
+    };
+
+public:
+    explicit ConstantPoolTable(const ClassFile &class_file);
+
+    // Returns true for the tags whose references are covered by validate().
+    [[nodiscard]] static auto covers(uint8_t tag) -> bool;
+
+    // Checks the references of a single entry like validate(), without building the table.
+    [[nodiscard]] static auto validate_entry(const ClassFile &class_file, const ConstantPoolInfo &info) -> uint8_t;
+
+    // The number of entries including the unused index 0, i.e. the constant pool count.
+    [[nodiscard]] auto size() const -> size_t;
+
+    [[nodiscard]] auto tag(uint16_t index) const -> uint8_t;
+
+    [[nodiscard]] auto first(uint16_t index) const -> uint16_t;
+
+    [[nodiscard]] auto second(uint16_t index) const -> uint16_t;
+
+    // Checks that CLASS, STRING, METHOD_TYPE, MODULE and PACKAGE entries reference a UTF_8 entry, NAME_AND_TYPE
+    // entries two UTF_8 entries and FIELD_REF, METHOD_REF and INTERFACE_METHOD_REF entries a CLASS and a
+    // NAME_AND_TYPE entry. Returns the entries with broken references in ascending order.
+    [[nodiscard]] auto validate() const -> std::vector<Result>;
+
+    // The portable kernel which validate() falls back to.
+    [[nodiscard]] auto validate_scalar() const -> std::vector<Result>;
+
+private:
+    [[nodiscard]] static auto _references(const ConstantPoolInfo &info) -> std::pair<uint16_t, uint16_t>;
+
+    [[nodiscard]] auto _validate_avx2() const -> std::vector<Result>;
+
+private:
+    // The arrays are padded with UNDEFINED entries, so that the vector kernel can read whole blocks past the end.
+    std::vector<uint8_t> _tags{};
+    std::vector<uint16_t> _first{};
+    std::vector<uint16_t> _second{};
+    size_t _size{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
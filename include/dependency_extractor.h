@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace ares {
+
+// The class and package dependencies of a JAR, like jdeps reports them. The names are interned into sorted tables
+// which the edges index into, no class or package depends on itself.
+struct DependencyGraph {
+    struct Edge {
+        uint32_t from{};
+        uint32_t to{};
+
+        auto operator<=>(const Edge &other) const = default;
+    };
+
+    static constexpr uint32_t MISSING = UINT32_MAX;
+
+    // Returns MISSING if the name isn't part of the graph.
+    [[nodiscard]] auto find_class(std::string_view name) const -> uint32_t;
+
+    [[nodiscard]] auto find_package(std::string_view name) const -> uint32_t;
+
+    // Internal names like "java/lang/String" and their packages like "java/lang", the unnamed package is empty.
+    std::vector<std::string> classes{};
+    std::vector<std::string> packages{};
+    // Sorted and without duplicates.
+    std::vector<Edge> class_edges{};
+    std::vector<Edge> package_edges{};
+};
+
+// Extracts the dependencies of classes from their constant pool alone, for when a full ClassReader pass is more
+// than needed. The pool is decoded straight from the class bytes into an offset table, fields, methods and
+// attributes are skipped entirely. Dependencies come from the CLASS entries, the descriptors of NAME_AND_TYPE and
+// METHOD_TYPE entries, and every other UTF-8 entry that is a valid descriptor, which covers the descriptors of the
+// own fields and methods. UTF-8 entries of string literals are left out, generic signatures aren't parsed.
+class DependencyExtractor {
+public:
+    struct ClassDependencies {
+        std::string_view name{};
+        // Sorted, without duplicates and without the class itself. The names are views into the class bytes.
+        std::vector<std::string_view> referenced_classes{};
+    };
+
+public:
+    // Returns std::nullopt if the bytes don't start with a class file header and a complete constant pool.
+    [[nodiscard]] static auto extract_class(const uint8_t *data, size_t size) -> std::optional<ClassDependencies>;
+
+    // Reads the classes of the JAR file without loading it as a JARFile. The workers inflate the classes through a
+    // ZIP handle each and intern the names locally, the tables are merged once at the end. Throws
+    // std::runtime_error if the archive or one of its classes can't be read.
+    [[nodiscard]] static auto extract_jar(const std::string &path, unsigned int thread_count = 0) -> DependencyGraph;
+
+    // Extracts the dependencies from the loaded bytes of the classes, including those of nested JARs.
+    [[nodiscard]] static auto extract_jar(JARFile &jar_file, unsigned int thread_count = 0) -> DependencyGraph;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
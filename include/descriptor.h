@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <vector>
+#include <deque>
+
+namespace ares {
+
+class ClassFile;
+
+// The compact form of a field or method descriptor (JVMS 4.3). For fields the return kind is the kind of the field
+// type itself. The referenced class names borrow from the parsed string, so they live as long as the constant pool.
+struct Descriptor {
+    enum Kind : char {
+        BYTE = 'B',
+        CHAR = 'C',
+        DOUBLE = 'D',
+        FLOAT = 'F',
+        INT = 'I',
+        LONG = 'J',
+        SHORT = 'S',
+        BOOLEAN = 'Z',
+        VOID = 'V',
+        OBJECT = 'L',
+        ARRAY = '[',
+    };
+
+    bool method{};
+    uint16_t parameter_count{};
+    uint16_t parameter_slots{};
+    Kind return_kind{VOID};
+    std::vector<std::string_view> referenced_classes{};
+
+    [[nodiscard]] static auto parse_field(std::string_view descriptor) -> std::optional<Descriptor>;
+
+    [[nodiscard]] static auto parse_method(std::string_view descriptor) -> std::optional<Descriptor>;
+
+    // Picks the field or method syntax depending on the first character.
+    [[nodiscard]] static auto parse(std::string_view descriptor) -> std::optional<Descriptor>;
+
+private:
+    static auto _parse_type(std::string_view descriptor, size_t &offset, Descriptor &result) -> std::optional<Kind>;
+};
+
+// Parses every descriptor of a class at most once, keyed by the index of its UTF-8 constant.
+class DescriptorCache {
+public:
+    // Drops all entries, the cache has to be reset before it is used with another class file.
+    void reset(const ClassFile &class_file);
+
+    // Parses every UTF-8 constant up front, so that the const lookups can be shared between threads afterward.
+    void prepare(const ClassFile &class_file);
+
+    // Returns nullptr if the index doesn't point at a valid descriptor of the requested kind.
+    [[nodiscard]] auto field(const ClassFile &class_file, uint16_t index) -> const Descriptor *;
+
+    [[nodiscard]] auto method(const ClassFile &class_file, uint16_t index) -> const Descriptor *;
+
+    // Lookups into a prepared cache.
+    [[nodiscard]] auto field(const ClassFile &class_file, uint16_t index) const -> const Descriptor *;
+
+    [[nodiscard]] auto method(const ClassFile &class_file, uint16_t index) const -> const Descriptor *;
+
+private:
+    auto _lookup(const ClassFile &class_file, uint16_t index) -> const Descriptor *;
+
+    [[nodiscard]] auto _find(const ClassFile &class_file, uint16_t index) const -> const Descriptor *;
+
+private:
+    enum State : uint8_t {
+        UNPARSED,
+        INVALID,
+        VALID
+    };
+
+    // A deque keeps the handed out pointers stable while more descriptors are parsed.
+    std::deque<Descriptor> _descriptors{};
+    std::vector<uint32_t> _slots{};
+    std::vector<State> _states{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
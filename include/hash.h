@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <array>
+
+namespace ares {
+
+// 64-bit xxHash of the given bytes. Stable across runs and platforms, so it can be used for on-disk keys.
+[[nodiscard]] auto hash64(const uint8_t *data, size_t size, uint64_t seed = 0) -> uint64_t;
+
+[[nodiscard]] auto hash64(std::string_view data, uint64_t seed = 0) -> uint64_t;
+
+// SHA-256 (FIPS 180-4) for digests that have to match the ones of other tools, like the JAR signature digests.
+class SHA256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+public:
+    void update(const uint8_t *data, size_t size);
+
+    void update(std::string_view data);
+
+    // Pads the message and returns its digest, the instance can't be updated afterward.
+    [[nodiscard]] auto finish() -> Digest;
+
+    [[nodiscard]] static auto digest(const uint8_t *data, size_t size) -> Digest;
+
+    [[nodiscard]] static auto digest(std::string_view data) -> Digest;
+
+private:
+    void _compress(const uint8_t *block);
+
+private:
+    std::array<uint32_t, 8> _state{0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                                   0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+    std::array<uint8_t, 64> _buffer{};
+    size_t _buffered{};
+    uint64_t _length{};
+};
+
+// Standard base64 with padding (RFC 4648).
+[[nodiscard]] auto base64_encode(const uint8_t *data, size_t size) -> std::string;
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace ares {
+
+// The structural differences between two versions of a JAR, down to single members and attributes. Entries with
+// identical bytes are skipped without parsing them. Changed classes are compared by what their constants mean
+// instead of by their constant pool indices, so a reordered constant pool alone is no change. The indices inside of
+// attributes are found like the ConstantPoolCompactor finds them, unknown attributes are compared byte by byte.
+class JARDiff {
+public:
+    enum Kind : uint8_t {
+        ADDED,
+        REMOVED,
+        CHANGED,
+    };
+
+    struct Change {
+        Kind kind{};
+        // The entry name like "a/B.class".
+        std::string entry{};
+        // Empty for changes of the entry itself. Methods are named like "run(I)V" and fields like "count:I".
+        std::string member{};
+        // What differs: "version", "access_flags", "name", "super_class", "interfaces", or an attribute like
+        // "attribute Code", which may also be added or removed. Empty for added and removed entries and members and
+        // for changed resources.
+        std::string detail{};
+
+        auto operator<=>(const Change &other) const = default;
+    };
+
+public:
+    // Compares the entries by the CRC-32 and size of the ZIP directories first, only the entries that differ are
+    // inflated. Those are read and compared concurrently, each worker through its own ZIP handles. Throws
+    // std::runtime_error if an archive or one of its entries can't be read.
+    [[nodiscard]] static auto diff_files(const std::string &old_path, const std::string &new_path,
+                                         unsigned int thread_count = 0) -> std::vector<Change>;
+
+    // Compares the classes by the bytes they were read from first, classes modified since aren't detected unless
+    // they have been written and read again. Nested JARs are compared as entries.
+    [[nodiscard]] static auto diff(const JARFile &old_jar, const JARFile &new_jar,
+                                   unsigned int thread_count = 0) -> std::vector<Change>;
+
+    // Compares two versions of a class member by member, the changes are sorted.
+    [[nodiscard]] static auto diff_class(const std::string &entry, const ClassFile &old_class,
+                                         const ClassFile &new_class) -> std::vector<Change>;
+
+    // One line per change with the kind, entry, member and detail separated by tabs, like
+    // "CHANGED\ta/B.class\trun(I)V\tattribute Code".
+    [[nodiscard]] static auto format(const std::vector<Change> &changes) -> std::string;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
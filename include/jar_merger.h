@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace ares {
+
+// Merges JARs into one, like the dependencies of an application into a fat JAR. Only the central directories of the
+// inputs are read: entries are compared by their CRC-32 and size and stay in their origin as streamed entries, whose
+// compressed data write_file copies as is. Only service files and manifests are read to merge them.
+class JARMerger {
+public:
+    enum DuplicatePolicy {
+        // The entry of the first JAR that contains it is kept.
+        KEEP_FIRST,
+        // Throws std::runtime_error on an entry that differs between JARs.
+        FAIL,
+    };
+
+    struct Options {
+        DuplicatePolicy duplicates{KEEP_FIRST};
+        // Compares the SHA-256 digests of duplicates whose CRC-32 and size match instead of trusting them.
+        bool compare_contents{};
+        unsigned int thread_count{};
+    };
+
+    // An entry that differs between JARs, the paths of the JAR it was taken from and of the one that was dropped.
+    struct Conflict {
+        std::string name{};
+        std::string kept{};
+        std::string dropped{};
+    };
+
+    struct Result {
+        JARFile jar_file{};
+        size_t identical_duplicates{};
+        std::vector<Conflict> conflicts{};
+    };
+
+public:
+    // Merges the JARs in order. The main attributes of the manifests are combined, of an attribute set by several
+    // JARs the first one wins. Providers of META-INF/services files are joined without duplicates, signature files,
+    // per-entry manifest sections and INDEX.LIST are dropped, as they don't hold for the merged JAR.
+    [[nodiscard]] static auto merge(const std::vector<std::string> &paths, const Options &options) -> Result;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
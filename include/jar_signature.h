@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace ares {
+
+// Checks the digests of a signed JAR: every entry against the SHA-256 digest of its manifest section, and the
+// manifest against the digests of every signature (.SF) file. Digests of other algorithms (e.g. SHA1-Digest) still
+// count as covering an entry, but aren't verified. The signature blocks themselves (PKCS #7) aren't validated, so
+// this detects tampering with the contents but doesn't establish who signed them.
+class JARSignature {
+public:
+    struct Issue {
+        std::string entry{};
+        std::string message{};
+
+        auto operator<=>(const Issue &other) const = default;
+    };
+
+public:
+    // Hashes the entries concurrently from their loaded data, streamed entries from the archive. Returns the issues
+    // sorted by entry name, an unsigned JAR without digests has none.
+    [[nodiscard]] static auto verify(const JARFile &jar_file, unsigned int thread_count = 0) -> std::vector<Issue>;
+
+    // Returns true for the manifest and the signature related files in META-INF, which aren't signed themselves.
+    [[nodiscard]] static auto is_signature_file(const std::string &name) -> bool;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
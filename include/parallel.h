@@ -0,0 +1,104 @@
+#pragma once
+
+#include <exception>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+
+namespace ares {
+
+// Calls function(index) for every index in [0, count) on up to thread_count threads (0 means one per hardware
+// thread). The calling thread takes part in the work. The first exception thrown by a worker is rethrown here.
+template<typename Function>
+void parallel_for(size_t count, Function &&function, unsigned int thread_count = 0) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    thread_count = static_cast<unsigned int>(std::min<size_t>(thread_count, count));
+    if (thread_count <= 1) {
+        for (size_t index = 0; index < count; index++) {
+            function(index);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_index{0};
+    std::exception_ptr error{};
+    std::mutex error_mutex{};
+
+    auto worker = [&]() {
+        while (true) {
+            auto index = next_index.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count) return;
+
+            try {
+                function(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+                next_index.store(count, std::memory_order_relaxed);
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    for (unsigned int index = 0; index < thread_count - 1; index++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// The number of strided chunks to split count items into, one per worker of thread_count (0 means one per hardware
+// thread). Chunk k takes the items k, k + chunk_count and so on, so that a worker can open an archive once for all.
+[[nodiscard]] inline auto chunk_count(size_t count, unsigned int thread_count) -> size_t {
+    size_t chunks = thread_count != 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(chunks, count));
+}
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
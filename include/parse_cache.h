@@ -0,0 +1,94 @@
+#pragma once
+
+#include <unordered_map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "class_file.h"
+
+namespace ares {
+
+// The parts of a class that are needed to analyze it without parsing it again.
+struct ClassSummary {
+    struct Member {
+        uint16_t access_flags{};
+        std::string name{};
+        std::string descriptor{};
+
+        auto operator==(const Member &other) const -> bool = default;
+    };
+
+    static auto from_class(const ClassFile &class_file) -> ClassSummary;
+
+    auto operator==(const ClassSummary &other) const -> bool = default;
+
+    uint16_t access_flags{};
+    std::string name{};
+    std::string super_name{};
+    std::vector<std::string> interfaces{};
+    std::vector<Member> fields{};
+    std::vector<Member> methods{};
+    std::vector<std::string> referenced_classes{};
+};
+
+// An on-disk cache of class summaries, addressed by the content of the class. Every entry is a single file that is
+// written to a temporary file and renamed into place, so concurrent writers never expose a partial entry. Entries
+// are read through mmap and verified with a checksum, damaged entries count as a miss.
+class ParseCache {
+public:
+    explicit ParseCache(std::string directory);
+
+    [[nodiscard]] static auto key_of(const std::vector<uint8_t> &data) -> uint64_t;
+
+    // A key that is known before an entry is inflated, the CRC-32 and size stored in the ZIP directory.
+    [[nodiscard]] static auto key_of(uint32_t crc, uint64_t size) -> uint64_t;
+
+    [[nodiscard]] auto lookup(uint64_t key) const -> std::optional<ClassSummary>;
+
+    void store(uint64_t key, const ClassSummary &summary) const;
+
+    // Summarizes every class of the JAR file. Cached classes are neither inflated nor parsed, and summaries that
+    // can't be stored are still returned.
+    auto summarize_jar(const std::string &path) const -> std::unordered_map<std::string, ClassSummary>;
+
+private:
+    [[nodiscard]] auto _path_of(uint64_t key) const -> std::string;
+
+private:
+    std::string _directory{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <unordered_map>
+#include <string_view>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+
+#include "utils.h"
+
+namespace ares {
+
+// Renames classes, fields and methods of a JAR after a mapping, like a ProGuard mapping file, and relocates packages.
+// Class names are rewritten wherever they appear: class constants, descriptors, generic signatures, local variable
+// tables, annotations and the names of the entries. Member references are renamed after the declaration they
+// resolve to within the JAR, so a reference through a subclass is renamed too.
+class Remapper {
+public:
+    // Reads the class and member lines of a ProGuard mapping, inlining information and comments are skipped. Throws
+    // std::invalid_argument on a malformed line.
+    [[nodiscard]] static auto read_proguard(std::string_view mapping) -> Remapper;
+
+    // Names are internal names like "a/b/C", descriptors are those of the original names.
+    void add_class(std::string_view name, std::string_view new_name);
+
+    void add_field(std::string_view owner, std::string_view name, std::string_view descriptor,
+                   std::string_view new_name);
+
+    void add_method(std::string_view owner, std::string_view name, std::string_view descriptor,
+                    std::string_view new_name);
+
+    // Moves every class whose name starts with the prefix, like "com/google/" to "shaded/com/google/". Explicitly
+    // mapped classes take precedence, of several matching prefixes the longest one applies.
+    void add_relocation(std::string_view prefix, std::string_view new_prefix);
+
+    // The functions return the input if nothing changes.
+    [[nodiscard]] auto map_class(std::string_view name) const -> std::string;
+
+    [[nodiscard]] auto map_descriptor(std::string_view descriptor) const -> std::string;
+
+    [[nodiscard]] auto map_signature(std::string_view signature) const -> std::string;
+
+    // Append the mapped form to the output and return true if it differs from the input, the output is left alone
+    // otherwise. Nothing is allocated for names that stay the same.
+    auto map_class(std::string_view name, std::string &output) const -> bool;
+
+    auto map_descriptor(std::string_view descriptor, std::string &output) const -> bool;
+
+    auto map_signature(std::string_view signature, std::string &output) const -> bool;
+
+    // The new name of a member declared in the class, or an empty view if it isn't renamed.
+    [[nodiscard]] auto map_member(std::string_view owner, std::string_view name, std::string_view descriptor,
+                                  bool method) const -> std::string_view;
+
+    // Remaps the classes of the JAR concurrently and renames their entries, the resources of relocated packages,
+    // the service provider files and the Main-Class. Nested JARs are left as they are.
+    void apply(JARFile &jar_file, unsigned int thread_count = 0) const;
+
+private:
+    auto _store(std::string value) -> std::string_view;
+
+private:
+    // Shared, so that copies of the remapper keep the views valid.
+    std::shared_ptr<std::deque<std::string>> _storage{std::make_shared<std::deque<std::string>>()};
+    std::unordered_map<std::string_view, std::string_view> _classes{};
+    std::unordered_map<std::string_view, std::string_view> _members{};
+    // Sorted by descending prefix length.
+    std::vector<std::pair<std::string_view, std::string_view>> _relocations{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
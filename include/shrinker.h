@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace ares {
+
+// Removes the classes, methods and fields of a JAR that can't be reached from its roots, and the constants only
+// they used. The roots are the main method of the Main-Class, the kept classes and, as reflection hints, the classes
+// named by string constants in live code and by the provider files in META-INF/services. Classes found through
+// roots other than the Main-Class are kept with all of their members.
+//
+// Reachability is class hierarchy based: a live virtual method keeps its overriding methods in every live subclass,
+// and classes with supertypes outside of the JAR keep all of their virtual methods, since the library may call any of
+// them. Nested JARs are left as they are.
+class Shrinker {
+public:
+    struct Options {
+        // Internal class names, "a/b/*" matches the classes of a package and "a/b/**" those of its subpackages too.
+        std::vector<std::string> keep{};
+        bool reflection_hints{true};
+        unsigned int thread_count{};
+    };
+
+    struct Result {
+        size_t removed_classes{};
+        size_t removed_fields{};
+        size_t removed_methods{};
+        size_t removed_constants{};
+    };
+
+public:
+    // Throws if the JAR has neither a Main-Class nor kept classes.
+    static auto shrink(JARFile &jar_file, const Options &options) -> Result;
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
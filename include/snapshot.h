@@ -0,0 +1,204 @@
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <string>
+#include <span>
+
+#include "constant_info.h"
+#include "class_file.h"
+#include "utils.h"
+
+namespace ares {
+
+// The records of a snapshot file. They are stored in native byte order, aligned to 8 bytes and only refer to each
+// other with offsets, so a mapped snapshot can be used in place. Offsets inside a class record are relative to the
+// start of the file, offsets inside the constant, member and attribute records are relative to the class bytes.
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t file_size;
+    uint64_t class_count;
+    uint64_t classes_offset;
+    uint64_t entry_count;
+    uint64_t entries_offset;
+    uint64_t manifest_offset;
+    uint64_t manifest_size;
+};
+
+struct SnapshotClassRecord {
+    uint64_t name_offset;
+    uint64_t byte_code_offset;
+    uint64_t constant_pool_offset;
+    uint64_t interfaces_offset;
+    uint64_t members_offset;
+    uint64_t attributes_offset;
+    uint32_t name_size;
+    uint32_t byte_code_size;
+    uint32_t attribute_total;
+    uint16_t minor_version;
+    uint16_t major_version;
+    uint16_t constant_pool_count;
+    uint16_t access_flags;
+    uint16_t this_class;
+    uint16_t super_class;
+    uint16_t interfaces_count;
+    uint16_t fields_count;
+    uint16_t method_count;
+    uint16_t attributes_count;
+};
+
+struct SnapshotConstant {
+    uint32_t offset;
+    uint8_t tag;
+    uint8_t reserved[3];
+};
+
+struct SnapshotMember {
+    uint16_t access_flags;
+    uint16_t name_index;
+    uint16_t descriptor_index;
+    uint16_t attributes_count;
+    uint32_t first_attribute;
+    uint32_t reserved;
+};
+
+struct SnapshotAttribute {
+    uint16_t name_index;
+    uint16_t reserved;
+    uint32_t length;
+    uint32_t data_offset;
+    uint32_t reserved_2;
+};
+
+struct SnapshotEntryRecord {
+    uint64_t name_offset;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint32_t name_size;
+    uint32_t reserved;
+};
+
+// A class inside a mapped snapshot. It only points into the mapping and is valid as long as the snapshot is.
+class SnapshotClass {
+public:
+    SnapshotClass(const uint8_t *base, const SnapshotClassRecord *record);
+
+    [[nodiscard]] auto record() const -> const SnapshotClassRecord &;
+
+    [[nodiscard]] auto name() const -> std::string_view;
+
+    [[nodiscard]] auto byte_code() const -> std::span<const uint8_t>;
+
+    [[nodiscard]] auto is_valid_index(unsigned int index) const -> bool;
+
+    [[nodiscard]] auto tag(unsigned int index) const -> ConstantPoolInfo::ConstantTag;
+
+    // The operand at the given byte position after the tag, e.g. 0 is the name index of a class constant.
+    [[nodiscard]] auto constant_u16(unsigned int index, unsigned int position) const -> uint16_t;
+
+    [[nodiscard]] auto utf8(unsigned int index) const -> std::string_view;
+
+    [[nodiscard]] auto class_name(unsigned int index) const -> std::string_view;
+
+    [[nodiscard]] auto interfaces() const -> std::span<const uint16_t>;
+
+    [[nodiscard]] auto fields() const -> std::span<const SnapshotMember>;
+
+    [[nodiscard]] auto methods() const -> std::span<const SnapshotMember>;
+
+    [[nodiscard]] auto attributes() const -> std::span<const SnapshotAttribute>;
+
+    [[nodiscard]] auto attributes(const SnapshotMember &member) const -> std::span<const SnapshotAttribute>;
+
+    [[nodiscard]] auto attribute_data(const SnapshotAttribute &attribute) const -> std::span<const uint8_t>;
+
+    // Parses the class into a regular, mutable class file.
+    [[nodiscard]] auto to_class_file() const -> ClassFile;
+
+private:
+    const uint8_t *_base;
+    const SnapshotClassRecord *_record;
+};
+
+// A parsed JAR file laid out so that it can be mapped and used without deserializing it. The mapping is shared
+// and read only, so every process using the same snapshot shares its pages.
+class Snapshot {
+public:
+    static void write(JARFile &jar_file, const std::string &path);
+
+    static auto open(const std::string &path) -> Snapshot;
+
+    Snapshot(Snapshot &&other) noexcept;
+
+    auto operator=(Snapshot &&other) noexcept -> Snapshot &;
+
+    Snapshot(const Snapshot &) = delete;
+
+    auto operator=(const Snapshot &) -> Snapshot & = delete;
+
+    ~Snapshot();
+
+public:
+    [[nodiscard]] auto class_count() const -> size_t;
+
+    [[nodiscard]] auto class_at(size_t index) const -> SnapshotClass;
+
+    // Finds a class by its entry name, e.g. "org/example/Main.class", with a binary search.
+    [[nodiscard]] auto find_class(std::string_view name) const -> std::optional<SnapshotClass>;
+
+    [[nodiscard]] auto entry_count() const -> size_t;
+
+    [[nodiscard]] auto entry_name(size_t index) const -> std::string_view;
+
+    [[nodiscard]] auto entry_data(size_t index) const -> std::span<const uint8_t>;
+
+    [[nodiscard]] auto manifest() const -> std::string_view;
+
+    [[nodiscard]] auto to_jar_file() const -> JARFile;
+
+private:
+    Snapshot(const uint8_t *data, size_t size);
+
+    [[nodiscard]] auto _header() const -> const SnapshotHeader &;
+
+    [[nodiscard]] auto _entry(size_t index) const -> const SnapshotEntryRecord &;
+
+private:
+    const uint8_t *_data{};
+    size_t _size{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
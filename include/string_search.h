@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+
+#include "utils.h"
+
+namespace ares {
+
+// Searches the UTF-8 constants of classes for many patterns at once, like URLs or algorithm names in an audit. The
+// patterns are compiled into an Aho-Corasick automaton over byte classes, which runs over the constant bytes in
+// place. Outside of a partial match, the text is skipped up to the next byte that starts a pattern, 32 bytes at a
+// time with AVX2 where the CPU supports it.
+class StringSearch {
+public:
+    struct Match {
+        // The entry name of the class, empty when searching a single class.
+        std::string class_name{};
+        uint16_t constant_index{};
+        uint32_t pattern{};
+        // Where the match starts within the constant.
+        uint32_t offset{};
+
+        auto operator<=>(const Match &other) const = default;
+    };
+
+public:
+    // Throws std::invalid_argument if a pattern is empty. Patterns are matched byte for byte against the modified
+    // UTF-8 of the constants, which equals UTF-8 for text without NUL and supplementary characters.
+    explicit StringSearch(const std::vector<std::string> &patterns);
+
+    [[nodiscard]] auto pattern_count() const -> size_t;
+
+    // All matches including overlapping ones, ordered by constant index, pattern and offset.
+    [[nodiscard]] auto search(const ClassFile &class_file) const -> std::vector<Match>;
+
+    // Searches the classes of the JAR and of nested JARs concurrently, the matches are ordered by class name first.
+    [[nodiscard]] auto search(JARFile &jar_file, unsigned int thread_count = 0) const -> std::vector<Match>;
+
+private:
+    template<typename Function>
+    void _scan(const uint8_t *data, size_t size, Function &&function) const;
+
+    [[nodiscard]] auto _skip(const uint8_t *data, size_t position, size_t size) const -> size_t;
+
+    [[nodiscard]] auto _skip_avx2(const uint8_t *data, size_t position, size_t size) const -> size_t;
+
+private:
+    // Bytes which appear in no pattern share class 0.
+    std::array<uint8_t, 256> _classes{};
+    size_t _class_count{1};
+    // The complete transition function, by state times class count plus class.
+    std::vector<uint32_t> _transitions{};
+    // The patterns ending in each state, including those of its suffix states, as ranges into _outputs.
+    std::vector<uint32_t> _output_offsets{};
+    std::vector<uint32_t> _outputs{};
+    std::vector<uint32_t> _lengths{};
+    // The bytes which leave the start state, and the same set as nibble tables for the vector kernel, a byte is a
+    // candidate if the entries of its low and high nibble share a bit.
+    std::array<bool, 256> _first_bytes{};
+    std::array<uint8_t, 16> _low_nibbles{};
+    std::array<uint8_t, 16> _high_nibbles{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
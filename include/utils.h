@@ -1,39 +1,163 @@
 #pragma once
 
 #include <unordered_map>
+#include <string_view>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <memory>
+#include <deque>
 
 #include <zip.h>
 
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
 #include "class_file.h"
+#include "field_info.h"
 
 namespace ares {
 
+// Strips leading and trailing whitespace.
+[[nodiscard]] auto trim(std::string_view value) -> std::string_view;
+
+// A JAR manifest (JAR File Specification). The attributes are views into the manifest bytes, values spread over
+// continuation lines are joined into separate storage. The main section comes first, followed by the per-entry
+// sections in file order. Unmodified manifests are written back byte for byte.
 class Manifest {
 public:
-    static auto read_manifest(std::string &content) -> Manifest;
+    struct Attribute {
+        std::string_view name{};
+        std::string_view value{};
+        // The lines of the attribute including continuations and line breaks, empty for set attributes.
+        std::string_view raw{};
+    };
 
-    [[nodiscard]] auto content() const -> std::string;
+    struct Section {
+        std::vector<Attribute> attributes{};
+        // The blank lines which end the section.
+        std::string_view trailer{};
+        // All bytes of the section as read, including the trailer, which is what signature files digest.
+        std::string_view raw{};
+
+        // Names are compared case-insensitively, returns nullptr if the attribute is missing.
+        [[nodiscard]] auto find(std::string_view name) const -> const Attribute *;
+
+        // The value of the "Name" attribute of a per-entry section.
+        [[nodiscard]] auto name() const -> std::string_view;
+    };
 
 public:
-    std::unordered_map <std::string, std::string> data{};
+    static auto read_manifest(std::string content) -> Manifest;
+
+    [[nodiscard]] auto content() const -> std::string;
+
+    [[nodiscard]] auto empty() const -> bool;
+
+    [[nodiscard]] auto main_section() const -> const Section &;
+
+    [[nodiscard]] auto sections() const -> const std::vector<Section> &;
+
+    // The section of an entry like "a/B.class", or nullptr if there is none.
+    [[nodiscard]] auto entry(std::string_view name) const -> const Section *;
+
+    // Looks up an attribute of the main section.
+    [[nodiscard]] auto value(std::string_view name) const -> std::optional<std::string_view>;
+
+    // Replaces or appends an attribute of the main section, the attribute is written wrapped to 72 bytes lines.
+    void set(std::string_view name, std::string_view value);
+
+private:
+    auto _store(std::string value) -> std::string_view;
+
+    void _detach();
+
+    void _index_entries();
+
+    static void _write_attribute(std::string &content, const Attribute &attribute, std::string_view line_break);
+
+private:
+    // Shared, so that copies of the manifest keep the views valid. The storage is only shared until a copy changes.
+    std::shared_ptr<const std::string> _content{};
+    std::shared_ptr<std::deque<std::string>> _storage{};
+    std::vector<Section> _sections{Section{}};
+    std::unordered_map<std::string_view, size_t> _entries{};
+    std::string_view _line_break{"\r\n"};
+    bool _modified{};
 };
 
 class JARFile {
 public:
-    static auto read_file(const std::string &path) -> JARFile;
+    // An entry whose data stays on disk, either inside an archive or as a plain file (index -1).
+    struct StreamedEntry {
+        std::string path{};
+        zip_int64_t index{-1};
+        zip_uint64_t size{};
+    };
+
+    static constexpr zip_uint64_t DEFAULT_STREAMING_THRESHOLD = 64 * 1024 * 1024;
+
+public:
+    JARFile() = default;
+
+    // Copies start without the views of nested JARs, which would otherwise be shared with the original.
+    JARFile(const JARFile &other);
+
+    JARFile(JARFile &&other) noexcept = default;
+
+    auto operator=(const JARFile &other) -> JARFile &;
+
+    auto operator=(JARFile &&other) noexcept -> JARFile & = default;
+
+public:
+    // Entries that are neither classes nor the manifest and are larger than the threshold aren't loaded, but
+    // streamed from the archive when they are read or written.
+    static auto read_file(const std::string &path,
+                          zip_uint64_t streaming_threshold = DEFAULT_STREAMING_THRESHOLD) -> JARFile;
+
+    static auto read_memory(const std::vector<uint8_t> &data) -> JARFile;
 
     auto write_file(const std::string &path) -> void;
 
+    static auto read_class(std::vector<uint8_t> data, bool verify = false) -> ClassFile;
+
+    void add_entry(const std::string &name, std::vector<uint8_t> data);
+
+    // Adds a file from disk as an entry without loading it.
+    void add_file(const std::string &name, const std::string &path);
+
+    // Passes the data of any entry to the consumer, streamed entries in chunks of at most one MiB.
+    void read_entry(const std::string &name,
+                    const std::function<void(const uint8_t *, size_t)> &consumer) const;
+
+    [[nodiscard]] auto nested_names() const -> std::vector<std::string>;
+
+    // Drops the cached view of a nested JAR, or of all of them if the name is empty.
+    void invalidate_nested(const std::string &name = {});
+
+    // Opens a JAR stored inside this one (e.g. "BOOT-INF/lib/x.jar") from the entry bytes, a streamed entry is
+    // loaded for it. The view is parsed on the first access and cached afterward, changes to it are not written back
+    // by write_file. It is a snapshot of the entry: add_entry and add_file drop it, but changes made to others
+    // directly are only seen after invalidate_nested.
+    auto nested(const std::string &name) -> JARFile &;
+
+    // Visits the classes of this JAR and of all nested JARs, which are named like "lib/x.jar!/a/B.class".
+    void visit_classes(const std::function<void(const std::string &, ClassFile &)> &function);
+
 private:
+    static auto _read_zip(zip_t *zip, const std::string &path, zip_uint64_t streaming_threshold) -> JARFile;
+
     static void _add_to_zip(zip_t *zip, const std::string &file_name, const std::vector<uint8_t> &data);
 
 public:
     std::unordered_map <std::string, std::vector<uint8_t>> others{};
     std::unordered_map <std::string, ClassFile> classes{};
+    std::unordered_map <std::string, StreamedEntry> streamed{};
     Manifest manifest{};
+
+private:
+    std::unordered_map <std::string, std::shared_ptr<JARFile>> _nested{};
 };
 
 } // namespace ares
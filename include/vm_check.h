@@ -1,18 +1,75 @@
 #pragma once
 
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "attribute_info.h"
 #include "constant_info.h"
 #include "method_info.h"
+#include "descriptor.h"
 #include "class_file.h"
 #include "field_info.h"
 #include "visitor.h"
+#include "utils.h"
 
 namespace ares {
 
+// A single violated rule. The member is the name and descriptor of the field or method the rule was checked for,
+// and the constant pool index points at the offending entry (0 if there is none). The entry is the JAR entry that
+// holds the class, like "a/B.class", for the checks that run over whole JARs and sort by it.
+struct Diagnostic {
+    std::string entry{};
+    std::string class_name{};
+    std::string member{};
+    uint16_t constant_pool_index{};
+    std::string message{};
+
+    auto operator<=>(const Diagnostic &other) const = default;
+};
+
 class VMCheck : Visitor {
+public:
+    enum Mode {
+        ABORT,
+        COLLECT
+    };
+
+    enum UTF8Flag {
+        IS_INIT = 0x01,
+        IS_CLINIT = 0x02
+    };
+
+public:
+    // In the COLLECT mode the check doesn't abort at the first violation, but records it and keeps going.
+    explicit VMCheck(Mode mode = ABORT);
+
+    // Checks all classes of the JAR concurrently and returns every violation, sorted by the class entry name.
+    static auto verify(JARFile &jar_file, unsigned int thread_count = 0) -> std::vector<Diagnostic>;
+
+    [[nodiscard]] auto diagnostics() const -> const std::vector<Diagnostic> &;
+
 public:
     void visit_class(ClassFile &class_file) override;
 
+    // The section checks only depend on the parts of the class file which precede them, so that the ClassReader
+    // can run them right after decoding each section.
+    void check_magic_number(ClassFile &class_file);
+
+    void check_class_version(ClassFile &class_file);
+
+    void check_constant_pool(ClassFile &class_file);
+
+    void check_access_flags(ClassFile &class_file);
+
+    void check_this_class(ClassFile &class_file);
+
+    void check_super_class(ClassFile &class_file);
+
+    // Checks the BootstrapMethods attribute and every dynamic constant pointing into it.
+    void check_bootstrap_methods(ClassFile &class_file);
+
     void visit_classpool_info(ClassFile &class_file, ConstantPoolInfo &constantPoolInfo) override;
 
     void visit_class_interface(ClassFile &class_file, uint16_t interface) override;
@@ -27,21 +84,33 @@ public:
 
     void visit_method_attribute(ClassFile &class_file, MethodInfo &method_info, AttributeInfo &attribute_info) override;
 
-    static void visit_class_info(ares::ClassFile &class_file, ares::ConstantInfo::ClassInfo &info);
+    void visit_method_handle_info(ClassFile &class_file, ConstantInfo::MethodHandleInfo &info);
+
+    void visit_dynamic_info(ClassFile &class_file, ConstantInfo::DynamicInfo &info);
+
+private:
+    static auto _compute_utf8_flags(std::string_view utf8) -> uint8_t;
 
-    static void visit_field_method_info(ares::ClassFile &class_file, ConstantInfo::FieldMethodInfo &info);
+    [[nodiscard]] auto _utf8_flags_of(ClassFile &class_file, uint16_t index) const -> uint8_t;
 
-    static void visit_name_and_type_info(ClassFile &class_file, ConstantInfo::NameAndTypeInfo &info);
+    void _report_references(ClassFile &class_file, uint8_t tag, uint8_t violations);
 
-    static void visit_string_info(ClassFile &class_file, ConstantInfo::StringInfo &info);
+    void _reset(ClassFile &class_file);
 
-    static void visit_method_type_info(ClassFile &class_file, ConstantInfo::MethodTypeInfo &info);
+    void _enter_class(ClassFile &class_file);
 
-    static void visit_method_handle_info(ClassFile &class_file, ConstantInfo::MethodHandleInfo &info);
+    void _enter_member(ClassFile &class_file, uint16_t name_index, uint16_t descriptor_index);
 
-    static void visit_dynamic_info(ClassFile &class_file, ConstantInfo::DynamicInfo &info);
+    void _report(ClassFile &class_file, uint16_t constant_pool_index, const char *message);
 
-    static void visit_module_package_info(ClassFile &class_file, ConstantInfo::ModulePackageInfo &info);
+private:
+    std::vector<Diagnostic> _diagnostics{};
+    std::vector<uint8_t> _utf8_flags{};
+    DescriptorCache _descriptors{};
+    const ClassFile *_class_file{};
+    std::string _member{};
+    uint16_t _constant_pool_index{};
+    Mode _mode{};
 };
 
 } // namespace ares
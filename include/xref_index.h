@@ -0,0 +1,147 @@
+#pragma once
+
+#include <unordered_map>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace ares {
+
+// An inverted index from the classes, fields and methods referenced in the constant pool to the classes that
+// reference them. References made by instructions are attributed to the method and, if enabled, to the offset of the
+// instruction, other ones (the superclass, interfaces, bootstrap arguments) to the class alone. References are
+// symbolic: a call to B.run()V that resolves to A.run()V is found under B.run()V.
+//
+// Every class is indexed under a source name, usually its entry name, so a changed class only replaces its own
+// references.
+class XrefIndex {
+public:
+    static constexpr uint32_t NO_OFFSET = UINT32_MAX;
+
+    struct Usage {
+        std::string_view source{};
+        // The name and descriptor of the referencing method, like "main([Ljava/lang/String;)V".
+        std::string_view member{};
+        uint32_t offset{NO_OFFSET};
+
+        auto operator<=>(const Usage &other) const = default;
+    };
+
+public:
+    explicit XrefIndex(bool record_offsets = true);
+
+    [[nodiscard]] static auto class_key(std::string_view class_name) -> std::string;
+
+    // Keys like "a/B.name:I".
+    [[nodiscard]] static auto field_key(std::string_view class_name, std::string_view name,
+                                        std::string_view descriptor) -> std::string;
+
+    // Keys like "a/B.name(I)V".
+    [[nodiscard]] static auto method_key(std::string_view class_name, std::string_view name,
+                                         std::string_view descriptor) -> std::string;
+
+    // Replaces the references of the source with the ones of the class.
+    void update(const std::string &source, const ClassFile &class_file);
+
+    // Indexes all classes of the JAR and its nested JARs concurrently, under their entry names.
+    void update(JARFile &jar_file, unsigned int thread_count = 0);
+
+    void remove(const std::string &source);
+
+    // The usages are sorted and stay valid until the index changes.
+    [[nodiscard]] auto usages(const std::string &key) const -> std::vector<Usage>;
+
+    [[nodiscard]] auto contains(const std::string &source) const -> bool;
+
+    [[nodiscard]] auto source_count() const -> size_t;
+
+    [[nodiscard]] auto key_count() const -> size_t;
+
+    // Writes the index to a temporary file that is renamed into place, like the entries of the ParseCache.
+    void save(const std::string &path) const;
+
+    // Returns nullopt if the file is missing, damaged or of another version.
+    [[nodiscard]] static auto load(const std::string &path) -> std::optional<XrefIndex>;
+
+private:
+    struct Posting {
+        uint32_t source{};
+        uint32_t member{};
+        uint32_t offset{};
+
+        auto operator<=>(const Posting &other) const = default;
+    };
+
+    struct Source {
+        std::string name{};
+        std::vector<std::string> members{};
+        // The keys that the source has postings under, with their number.
+        std::vector<std::pair<std::string, uint32_t>> keys{};
+        // A removed source keeps its id until the last of its postings is compacted away.
+        bool removed{};
+        uint32_t stale_postings{};
+    };
+
+    // Postings of removed sources are skipped, and dropped once they make up more than half of the list, so that
+    // removing a source doesn't scan the long lists of common keys every time.
+    struct Postings {
+        std::vector<Posting> postings{};
+        uint32_t stale{};
+    };
+
+    struct Scan {
+        std::vector<std::string> members{};
+        std::vector<std::pair<std::string, Posting>> references{};
+    };
+
+    [[nodiscard]] static auto _scan(const ClassFile &class_file, bool record_offsets) -> Scan;
+
+    void _insert(const std::string &source, Scan scan);
+
+    void _compact(std::unordered_map<std::string, Postings>::iterator found);
+
+private:
+    bool _record_offsets{};
+    std::unordered_map<std::string, Postings> _postings{};
+    std::unordered_map<std::string, uint32_t> _source_ids{};
+    std::vector<Source> _sources{};
+    std::vector<uint32_t> _free_ids{};
+};
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
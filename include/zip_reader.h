@@ -0,0 +1,98 @@
+#pragma once
+
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <zip.h>
+
+#include "parallel.h"
+
+namespace ares {
+
+// An entry of the central directory of a ZIP file.
+struct ZipEntry {
+    std::string name{};
+    zip_int64_t index{};
+    zip_uint64_t size{};
+    std::optional<uint32_t> crc{};
+};
+
+// Opens the ZIP file read-only, the handle is released with zip_discard. Throws std::runtime_error on failure.
+[[nodiscard]] auto open_zip(const std::string &path) -> zip_t *;
+
+// Reads the central directory of the ZIP file in order, without the entries of directories.
+[[nodiscard]] auto read_directory(zip_t *zip) -> std::vector<ZipEntry>;
+
+[[nodiscard]] auto read_directory(const std::string &path) -> std::vector<ZipEntry>;
+
+// Inflates the entry into the buffer, which may be reused across entries. Throws std::runtime_error on failure.
+void read_entry(zip_t *zip, const ZipEntry &entry, const std::string &path, std::vector<uint8_t> &data);
+
+[[nodiscard]] auto read_entry(zip_t *zip, const ZipEntry &entry, const std::string &path) -> std::vector<uint8_t>;
+
+// Reads the central directory of the JAR, only the .class entries.
+[[nodiscard]] auto read_class_directory(const std::string &path) -> std::vector<ZipEntry>;
+
+// Reads the .class entries of the JAR on up to thread_count threads, one strided chunk per worker (see chunk_count).
+// Calls function(entry, data, result) with the result of the chunk and returns the results of all chunks.
+template<typename Result, typename Function>
+auto read_class_chunks(const std::string &path, unsigned int thread_count, Function &&function) -> std::vector<Result> {
+    auto entries = read_class_directory(path);
+    std::vector<Result> results(chunk_count(entries.size(), thread_count));
+
+    parallel_for(entries.empty() ? 0 : results.size(), [&](size_t chunk) {
+        zip_t *zip = open_zip(path);
+        std::vector<uint8_t> data;
+
+        try {
+            for (auto index = chunk; index < entries.size(); index += results.size()) {
+                read_entry(zip, entries[index], path, data);
+                function(entries[index], std::span<const uint8_t>(data), results[chunk]);
+            }
+        } catch (...) {
+            zip_discard(zip);
+            throw;
+        }
+
+        zip_discard(zip);
+    }, thread_count);
+
+    return results;
+}
+
+} // namespace ares
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "abi_fingerprint.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <span>
+
+#include "constant_pool_scanner.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "zip_reader.h"
+#include "parallel.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+// Access flags that don't change how other classes compile against a class or method.
+constexpr uint16_t IGNORED_CLASS_FLAGS = ClassFile::SUPER;
+constexpr uint16_t IGNORED_METHOD_FLAGS = MethodInfo::SYNCHRONIZED | MethodInfo::NATIVE | MethodInfo::STRICT;
+constexpr uint16_t VISIBLE_FLAGS = MethodInfo::PUBLIC | MethodInfo::PROTECTED;
+
+// Annotations nested deeper than this are treated as malformed, which bounds the recursion.
+constexpr int MAX_DEPTH = 64;
+
+class ByteCursor {
+public:
+    ByteCursor(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+    auto u8(uint8_t &value) -> bool {
+        if (_offset + 1 > _size) return false;
+        value = _data[_offset++];
+        return true;
+    }
+
+    auto u16(uint16_t &value) -> bool {
+        if (_offset + 2 > _size) return false;
+        value = ConstantPoolScanner::read_u16(_data + _offset);
+        _offset += 2;
+        return true;
+    }
+
+    auto u32(uint32_t &value) -> bool {
+        uint16_t high, low;
+        if (!u16(high) || !u16(low)) return false;
+        value = static_cast<uint32_t>(high) << 16 | low;
+        return true;
+    }
+
+    auto bytes(size_t count, std::span<const uint8_t> &value) -> bool {
+        if (count > _size - _offset) return false;
+        value = {_data + _offset, count};
+        _offset += count;
+        return true;
+    }
+
+    [[nodiscard]] auto offset() const -> size_t {
+        return _offset;
+    }
+
+    [[nodiscard]] auto at_end() const -> bool {
+        return _offset == _size;
+    }
+
+private:
+    const uint8_t *_data;
+    size_t _size, _offset{};
+};
+
+void append_u16(std::string &buffer, uint16_t value) {
+    buffer += static_cast<char>(value >> 8);
+    buffer += static_cast<char>(value & 0xFF);
+}
+
+void append_u64(std::string &buffer, uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) buffer += static_cast<char>((value >> shift) & 0xFF);
+}
+
+// Length prefixed, so that concatenated texts stay unambiguous.
+void append_text(std::string &buffer, std::string_view text) {
+    append_u64(buffer, text.size());
+    buffer += text;
+}
+
+// Appends the value of a constant of an attribute, which are UTF-8, numeric, STRING and CLASS constants.
+auto append_constant(const ConstantPoolScanner &pool, uint16_t index, std::string &buffer) -> bool {
+    auto tag = pool.tag(index);
+    buffer += static_cast<char>(tag);
+
+    std::string_view text;
+    switch (tag) {
+        case ConstantPoolInfo::UTF_8:
+            if (!pool.utf8(index, text)) return false;
+            break;
+        case ConstantPoolInfo::INTEGER:
+        case ConstantPoolInfo::FLOAT:
+            text = {reinterpret_cast<const char *>(pool.payload(index)), 4};
+            break;
+        case ConstantPoolInfo::LONG:
+        case ConstantPoolInfo::DOUBLE:
+            text = {reinterpret_cast<const char *>(pool.payload(index)), 8};
+            break;
+        case ConstantPoolInfo::STRING:
+        case ConstantPoolInfo::CLASS:
+            if (!pool.utf8(pool.operand(index, 0), text)) return false;
+            break;
+        default:
+            return false;
+    }
+
+    append_text(buffer, text);
+    return true;
+}
+
+auto append_annotation(ByteCursor &cursor, const ConstantPoolScanner &pool, std::string &buffer, int depth) -> bool;
+
+auto append_element_value(ByteCursor &cursor, const ConstantPoolScanner &pool, std::string &buffer, int depth) -> bool {
+    uint8_t tag;
+    if (!cursor.u8(tag)) return false;
+    buffer += static_cast<char>(tag);
+
+    uint16_t index, other_index;
+    switch (tag) {
+        case 'B':
+        case 'C':
+        case 'D':
+        case 'F':
+        case 'I':
+        case 'J':
+        case 'S':
+        case 'Z':
+        case 's':
+        case 'c':
+            return cursor.u16(index) && append_constant(pool, index, buffer);
+        case 'e':
+            return cursor.u16(index) && cursor.u16(other_index) && append_constant(pool, index, buffer)
+                   && append_constant(pool, other_index, buffer);
+        case '@':
+            return append_annotation(cursor, pool, buffer, depth + 1);
+        case '[': {
+            uint16_t count;
+            if (!cursor.u16(count)) return false;
+
+            append_u16(buffer, count);
+            for (uint16_t value = 0; value < count; value++) {
+                if (!append_element_value(cursor, pool, buffer, depth + 1)) return false;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+auto append_annotation(ByteCursor &cursor, const ConstantPoolScanner &pool, std::string &buffer, int depth) -> bool {
+    uint16_t type_index, pair_count;
+    if (depth > MAX_DEPTH || !cursor.u16(type_index) || !append_constant(pool, type_index, buffer)
+        || !cursor.u16(pair_count)) {
+        return false;
+    }
+
+    append_u16(buffer, pair_count);
+    for (uint16_t pair = 0; pair < pair_count; pair++) {
+        uint16_t name_index;
+        if (!cursor.u16(name_index) || !append_constant(pool, name_index, buffer)
+            || !append_element_value(cursor, pool, buffer, depth)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Appends a list of annotations in a canonical order.
+auto append_annotations(ByteCursor &cursor, const ConstantPoolScanner &pool, std::string &buffer) -> bool {
+    uint16_t count;
+    if (!cursor.u16(count)) return false;
+
+    std::vector<std::string> annotations(count);
+    for (auto &annotation: annotations) {
+        if (!append_annotation(cursor, pool, annotation, 0)) return false;
+    }
+
+    std::sort(annotations.begin(), annotations.end());
+    append_u16(buffer, count);
+    for (const auto &annotation: annotations) append_text(buffer, annotation);
+    return true;
+}
+
+// Appends the attributes which are part of the ABI, others are skipped. Returns false if one is malformed.
+auto append_attribute(std::string_view name, std::span<const uint8_t> data, const ConstantPoolScanner &pool,
+                      std::string &buffer) -> bool {
+    ByteCursor cursor(data.data(), data.size());
+    uint16_t index, count;
+
+    if (name == "Signature" || name == "ConstantValue") {
+        append_text(buffer, name);
+        return cursor.u16(index) && append_constant(pool, index, buffer) && cursor.at_end();
+    }
+
+    if (name == "Exceptions") {
+        if (!cursor.u16(count)) return false;
+
+        std::vector<std::string> exceptions(count);
+        for (auto &exception: exceptions) {
+            if (!cursor.u16(index) || !append_constant(pool, index, exception)) return false;
+        }
+        std::sort(exceptions.begin(), exceptions.end());
+
+        append_text(buffer, name);
+        for (const auto &exception: exceptions) append_text(buffer, exception);
+        return cursor.at_end();
+    }
+
+    if (name == "RuntimeVisibleAnnotations" || name == "RuntimeInvisibleAnnotations") {
+        append_text(buffer, name);
+        return append_annotations(cursor, pool, buffer) && cursor.at_end();
+    }
+
+    if (name == "RuntimeVisibleParameterAnnotations" || name == "RuntimeInvisibleParameterAnnotations") {
+        uint8_t parameter_count;
+        if (!cursor.u8(parameter_count)) return false;
+
+        append_text(buffer, name);
+        buffer += static_cast<char>(parameter_count);
+        for (uint8_t parameter = 0; parameter < parameter_count; parameter++) {
+            if (!append_annotations(cursor, pool, buffer)) return false;
+        }
+        return cursor.at_end();
+    }
+
+    if (name == "AnnotationDefault") {
+        append_text(buffer, name);
+        return append_element_value(cursor, pool, buffer, 0) && cursor.at_end();
+    }
+
+    return true;
+}
+
+// Reads the attributes and, unless rendered is nullptr, collects the canonical forms of those of the ABI.
+auto read_attributes(ByteCursor &cursor, const ConstantPoolScanner &pool, std::vector<std::string> *rendered) -> bool {
+    uint16_t count;
+    if (!cursor.u16(count)) return false;
+
+    for (uint16_t attribute = 0; attribute < count; attribute++) {
+        uint16_t name_index;
+        uint32_t length;
+        std::span<const uint8_t> data;
+        if (!cursor.u16(name_index) || !cursor.u32(length) || !cursor.bytes(length, data)) return false;
+        if (!rendered) continue;
+
+        std::string_view name;
+        std::string buffer;
+        if (!pool.utf8(name_index, name) || !append_attribute(name, data, pool, buffer)) return false;
+        if (!buffer.empty()) rendered->push_back(std::move(buffer));
+    }
+
+    if (rendered) std::sort(rendered->begin(), rendered->end());
+    return true;
+}
+
+// Hashes the public and protected fields or methods one by one, so that their order doesn't matter.
+auto hash_members(ByteCursor &cursor, const ConstantPoolScanner &pool, char kind, uint16_t ignored_flags,
+                  std::vector<uint64_t> &hashes) -> bool {
+    uint16_t count;
+    if (!cursor.u16(count)) return false;
+
+    std::string buffer;
+    std::vector<std::string> attributes;
+    for (uint16_t member = 0; member < count; member++) {
+        uint16_t access_flags, name_index, descriptor_index;
+        if (!cursor.u16(access_flags) || !cursor.u16(name_index) || !cursor.u16(descriptor_index)) return false;
+
+        // Private and package-private members are skipped along with their attributes.
+        auto visible = (access_flags & VISIBLE_FLAGS) != 0;
+        attributes.clear();
+        if (!read_attributes(cursor, pool, visible ? &attributes : nullptr)) return false;
+        if (!visible) continue;
+
+        std::string_view name, descriptor;
+        if (!pool.utf8(name_index, name) || !pool.utf8(descriptor_index, descriptor)) return false;
+
+        buffer.assign(1, kind);
+        append_u16(buffer, access_flags & ~ignored_flags);
+        append_text(buffer, name);
+        append_text(buffer, descriptor);
+        for (const auto &attribute: attributes) append_text(buffer, attribute);
+
+        hashes.push_back(hash64(buffer));
+    }
+
+    return true;
+}
+
+auto combine(std::vector<uint64_t> &hashes) -> uint64_t {
+    std::sort(hashes.begin(), hashes.end());
+
+    std::string buffer;
+    for (auto hash: hashes) append_u64(buffer, hash);
+    return hash64(buffer);
+}
+
+} // namespace
+
+auto ABIFingerprint::hash_class(const uint8_t *data, size_t size) -> std::optional<ClassHash> {
+    ByteCursor cursor(data, size);
+
+    uint32_t magic_number;
+    std::span<const uint8_t> version;
+    if (!cursor.u32(magic_number) || magic_number != 0xCAFEBABE || !cursor.bytes(4, version)) return std::nullopt;
+
+    ConstantPoolScanner pool;
+    auto end = pool.scan(data, size, cursor.offset());
+    std::span<const uint8_t> entries;
+    if (!end || !cursor.bytes(*end - cursor.offset(), entries)) return std::nullopt;
+
+    uint16_t access_flags, this_class, super_class, interface_count;
+    if (!cursor.u16(access_flags) || !cursor.u16(this_class) || !cursor.u16(super_class)
+        || !cursor.u16(interface_count)) {
+        return std::nullopt;
+    }
+
+    std::string_view name, super_name;
+    if (!pool.class_name(this_class, name) || !pool.class_name(super_class, super_name)) return std::nullopt;
+
+    std::vector<std::string_view> interfaces(interface_count);
+    for (auto &interface: interfaces) {
+        uint16_t index;
+        if (!cursor.u16(index) || index == 0 || !pool.class_name(index, interface)) return std::nullopt;
+    }
+    std::sort(interfaces.begin(), interfaces.end());
+
+    std::vector<uint64_t> member_hashes;
+    std::vector<std::string> attributes;
+    if (!hash_members(cursor, pool, 'F', 0, member_hashes)
+        || !hash_members(cursor, pool, 'M', IGNORED_METHOD_FLAGS, member_hashes)
+        || !read_attributes(cursor, pool, &attributes) || !cursor.at_end()) {
+        return std::nullopt;
+    }
+
+    std::string buffer;
+    append_u16(buffer, access_flags & ~IGNORED_CLASS_FLAGS);
+    append_text(buffer, name);
+    append_text(buffer, super_name);
+    append_u16(buffer, interface_count);
+    for (auto interface: interfaces) append_text(buffer, interface);
+    append_u16(buffer, static_cast<uint16_t>(attributes.size()));
+    for (const auto &attribute: attributes) append_text(buffer, attribute);
+    append_u64(buffer, combine(member_hashes));
+
+    return ClassHash{hash64(buffer), (access_flags & ClassFile::PUBLIC) != 0};
+}
+
+auto ABIFingerprint::hash_jar(const std::string &path, unsigned int thread_count) -> uint64_t {
+    auto hash = [&](const ZipEntry &entry, std::span<const uint8_t> data, std::vector<uint64_t> &hashes) {
+        auto class_hash = hash_class(data.data(), data.size());
+        if (!class_hash) throw std::runtime_error("Warning: Couldn't hash the ABI of: " + path + "!/" + entry.name);
+
+        if (class_hash->exported) hashes.push_back(class_hash->hash);
+    };
+
+    auto results = read_class_chunks<std::vector<uint64_t>>(path, thread_count, hash);
+
+    std::vector<uint64_t> hashes;
+    for (const auto &result: results) hashes.insert(hashes.end(), result.begin(), result.end());
+    return combine(hashes);
+}
+
+auto ABIFingerprint::hash_jar(const JARFile &jar_file, unsigned int thread_count) -> uint64_t {
+    std::vector<std::pair<const std::string *, const ClassFile *>> classes;
+    for (const auto &[name, class_file]: jar_file.classes) classes.emplace_back(&name, &class_file);
+
+    std::vector<std::optional<ClassHash>> results(classes.size());
+    parallel_for(classes.size(), [&](size_t index) {
+        const auto &byte_code = classes[index].second->byte_code;
+        results[index] = hash_class(byte_code.data(), byte_code.size());
+        if (!results[index]) {
+            throw std::runtime_error("Warning: Couldn't hash the ABI of: " + *classes[index].first);
+        }
+    }, thread_count);
+
+    std::vector<uint64_t> hashes;
+    for (const auto &result: results) {
+        if (result->exported) hashes.push_back(result->hash);
+    }
+    return combine(hashes);
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "annotation_walker.h"
+
+#include "bytecode.h"
+
+using namespace ares;
+
+namespace {
+
+class AnnotationCursor {
+public:
+    AnnotationCursor(std::span<const uint8_t> data, const AnnotationWalker::IndexVisitor &visitor)
+            : _data(data), _visitor(visitor) {}
+
+    auto attribute(std::string_view name) -> bool {
+        if (name == "RuntimeVisibleAnnotations" || name == "RuntimeInvisibleAnnotations") {
+            return annotations() && at_end();
+        }
+
+        if (name == "RuntimeVisibleParameterAnnotations" || name == "RuntimeInvisibleParameterAnnotations") {
+            uint8_t count;
+            if (!u8(count)) return false;
+            for (uint8_t item = 0; item < count; item++) if (!annotations()) return false;
+            return at_end();
+        }
+
+        if (name == "RuntimeVisibleTypeAnnotations" || name == "RuntimeInvisibleTypeAnnotations") {
+            uint16_t count;
+            if (!u16(count)) return false;
+            for (uint16_t item = 0; item < count; item++) if (!type_annotation()) return false;
+            return at_end();
+        }
+
+        if (name == "AnnotationDefault") return element_value(0) && at_end();
+
+        return false;
+    }
+
+private:
+    auto annotations() -> bool {
+        uint16_t count;
+        if (!u16(count)) return false;
+        for (uint16_t item = 0; item < count; item++) if (!annotation(0)) return false;
+        return true;
+    }
+
+    auto annotation(unsigned int depth) -> bool {
+        uint16_t pair_count;
+        if (!index(AnnotationWalker::TYPE) || !u16(pair_count)) return false;
+
+        for (uint16_t item = 0; item < pair_count; item++) {
+            if (!index(AnnotationWalker::ELEMENT_NAME) || !element_value(depth + 1)) return false;
+        }
+        return true;
+    }
+
+    // Skips the target and the type path, which hold no constant pool indices, then walks the annotation.
+    auto type_annotation() -> bool {
+        uint8_t target_type;
+        if (!u8(target_type)) return false;
+
+        switch (target_type) {
+            case 0x00:
+            case 0x01:
+            case 0x16:
+                if (!skip(1)) return false;
+                break;
+            case 0x10:
+            case 0x11:
+            case 0x12:
+            case 0x17:
+            case 0x42:
+            case 0x43:
+            case 0x44:
+            case 0x45:
+            case 0x46:
+                if (!skip(2)) return false;
+                break;
+            case 0x13:
+            case 0x14:
+            case 0x15:
+                break;
+            case 0x40:
+            case 0x41: {
+                uint16_t count;
+                if (!u16(count) || !skip(count * size_t(6))) return false;
+                break;
+            }
+            case 0x47:
+            case 0x48:
+            case 0x49:
+            case 0x4A:
+            case 0x4B:
+                if (!skip(3)) return false;
+                break;
+            default:
+                return false;
+        }
+
+        uint8_t path_length;
+        return u8(path_length) && skip(path_length * size_t(2)) && annotation(0);
+    }
+
+    auto element_value(unsigned int depth) -> bool {
+        uint8_t tag;
+        if (depth > 256 || !u8(tag)) return false;
+
+        switch (tag) {
+            case 'B':
+            case 'C':
+            case 'D':
+            case 'F':
+            case 'I':
+            case 'J':
+            case 'S':
+            case 'Z':
+                return index(AnnotationWalker::CONSTANT);
+            case 's':
+                return index(AnnotationWalker::STRING);
+            case 'c':
+                return index(AnnotationWalker::CLASS);
+            case 'e':
+                return index(AnnotationWalker::ENUM_TYPE) && index(AnnotationWalker::ENUM_CONSTANT);
+            case '@':
+                return annotation(depth + 1);
+            case '[': {
+                uint16_t count;
+                if (!u16(count)) return false;
+                for (uint16_t item = 0; item < count; item++) if (!element_value(depth + 1)) return false;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    auto index(AnnotationWalker::Index index) -> bool {
+        if (_offset + 2 > _data.size()) return false;
+        _visitor(_offset, index);
+        _offset += 2;
+        return true;
+    }
+
+    auto u8(uint8_t &value) -> bool {
+        if (_offset + 1 > _data.size()) return false;
+        value = _data[_offset++];
+        return true;
+    }
+
+    auto u16(uint16_t &value) -> bool {
+        if (_offset + 2 > _data.size()) return false;
+        value = Bytecode::read_u16(_data, _offset);
+        _offset += 2;
+        return true;
+    }
+
+    auto skip(size_t count) -> bool {
+        if (count > _data.size() - _offset) return false;
+        _offset += count;
+        return true;
+    }
+
+    [[nodiscard]] auto at_end() const -> bool {
+        return _offset == _data.size();
+    }
+
+private:
+    std::span<const uint8_t> _data;
+    const AnnotationWalker::IndexVisitor &_visitor;
+    size_t _offset{};
+};
+
+} // namespace
+
+auto AnnotationWalker::handles(std::string_view name) -> bool {
+    return name == "RuntimeVisibleAnnotations" || name == "RuntimeInvisibleAnnotations"
+           || name == "RuntimeVisibleParameterAnnotations" || name == "RuntimeInvisibleParameterAnnotations"
+           || name == "RuntimeVisibleTypeAnnotations" || name == "RuntimeInvisibleTypeAnnotations"
+           || name == "AnnotationDefault";
+}
+
+auto AnnotationWalker::walk(std::string_view name, std::span<const uint8_t> data, const IndexVisitor &visitor) -> bool {
+    return AnnotationCursor(data, visitor).attribute(name);
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
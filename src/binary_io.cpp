@@ -0,0 +1,148 @@
+#include "binary_io.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <fstream>
+#include <thread>
+#include <atomic>
+
+#include <unistd.h>
+
+using namespace ares;
+
+void BinaryWriter::write_u16(uint16_t value) {
+    _bytes.push_back(value & 0xFF);
+    _bytes.push_back((value >> 8) & 0xFF);
+}
+
+void BinaryWriter::write_u32(uint32_t value) {
+    write_u16(value & 0xFFFF);
+    write_u16(value >> 16);
+}
+
+void BinaryWriter::write_u64(uint64_t value) {
+    write_u32(value & 0xFFFFFFFF);
+    write_u32(value >> 32);
+}
+
+void BinaryWriter::write_string16(std::string_view value) {
+    write_u16(static_cast<uint16_t>(value.size()));
+    _bytes.insert(_bytes.end(), value.begin(), value.end());
+}
+
+void BinaryWriter::write_string32(std::string_view value) {
+    write_u32(static_cast<uint32_t>(value.size()));
+    _bytes.insert(_bytes.end(), value.begin(), value.end());
+}
+
+auto BinaryWriter::bytes() -> std::vector<uint8_t> & {
+    return _bytes;
+}
+
+BinaryReader::BinaryReader(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+auto BinaryReader::read_u16(uint16_t &value) -> bool {
+    if (_size - _offset < 2) return false;
+    value = _data[_offset] | (_data[_offset + 1] << 8);
+    _offset += 2;
+    return true;
+}
+
+auto BinaryReader::read_u32(uint32_t &value) -> bool {
+    uint16_t low, high;
+    if (!read_u16(low) || !read_u16(high)) return false;
+    value = low | (static_cast<uint32_t>(high) << 16);
+    return true;
+}
+
+auto BinaryReader::read_u64(uint64_t &value) -> bool {
+    uint32_t low, high;
+    if (!read_u32(low) || !read_u32(high)) return false;
+    value = low | (static_cast<uint64_t>(high) << 32);
+    return true;
+}
+
+auto BinaryReader::read_string16(std::string &value) -> bool {
+    uint16_t length;
+    if (!read_u16(length) || length > _size - _offset) return false;
+    value.assign(reinterpret_cast<const char *>(_data + _offset), length);
+    _offset += length;
+    return true;
+}
+
+auto BinaryReader::read_string32(std::string &value) -> bool {
+    uint32_t length;
+    if (!read_u32(length) || length > _size - _offset) return false;
+    value.assign(reinterpret_cast<const char *>(_data + _offset), length);
+    _offset += length;
+    return true;
+}
+
+auto BinaryReader::read_count(uint32_t &value, size_t item_size) -> bool {
+    return read_u32(value) && value <= (_size - _offset) / item_size;
+}
+
+auto BinaryReader::at_end() const -> bool {
+    return _offset == _size;
+}
+
+void ares::write_file_atomically(const std::string &path, std::initializer_list<std::span<const uint8_t>> parts,
+                                 const std::string &description) {
+    // Every writer uses its own temporary file, the rename then atomically replaces whatever file was there.
+    static std::atomic<uint64_t> counter{0};
+    auto temporary_path = path + "." + std::to_string(getpid()) + "."
+                          + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "."
+                          + std::to_string(counter.fetch_add(1)) + ".tmp";
+
+    {
+        std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+        for (const auto &part: parts) {
+            stream.write(reinterpret_cast<const char *>(part.data()), static_cast<std::streamsize>(part.size()));
+        }
+
+        if (!stream) {
+            stream.close();
+            std::filesystem::remove(temporary_path);
+            throw std::runtime_error("Warning: Couldn't write the " + description + ": " + temporary_path);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        std::filesystem::remove(temporary_path, error);
+        throw std::runtime_error("Warning: Couldn't replace the " + description + ": " + path);
+    }
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "bootstrap_methods.h"
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "class_file.h"
+#include "field_info.h"
+
+using namespace ares;
+
+auto BootstrapMethods::read(const ClassFile &class_file) -> std::optional<BootstrapMethods> {
+    BootstrapMethods table;
+
+    for (const auto &attribute_info: class_file.attributes) {
+        if (class_file.utf8(attribute_info.attribute_name_index) != "BootstrapMethods") continue;
+        if (table._present) return std::nullopt;
+
+        table._present = true;
+
+        const auto *info = attribute_info.info;
+        size_t length = attribute_info.attribute_length;
+        size_t offset = 0;
+
+        auto read_u16 = [&](uint16_t &value) {
+            if (offset + 2 > length) return false;
+
+            value = static_cast<uint16_t>((info[offset] << 8) | info[offset + 1]);
+            offset += 2;
+            return true;
+        };
+
+        uint16_t count{};
+        if (!read_u16(count)) return std::nullopt;
+
+        table._method_refs.reserve(count);
+        table._argument_offsets.reserve(count + 1);
+
+        for (uint16_t index = 0; index < count; index++) {
+            uint16_t method_ref{}, argument_count{};
+            if (!read_u16(method_ref) || !read_u16(argument_count)) return std::nullopt;
+
+            table._method_refs.push_back(method_ref);
+            for (uint16_t argument = 0; argument < argument_count; argument++) {
+                if (!read_u16(table._arguments.emplace_back())) return std::nullopt;
+            }
+
+            table._argument_offsets.push_back(static_cast<uint32_t>(table._arguments.size()));
+        }
+
+        if (offset != length) return std::nullopt;
+    }
+
+    return table;
+}
+
+auto BootstrapMethods::present() const -> bool {
+    return _present;
+}
+
+auto BootstrapMethods::size() const -> size_t {
+    return _method_refs.size();
+}
+
+auto BootstrapMethods::method(size_t index) const -> Method {
+    auto begin = _argument_offsets[index];
+    auto end = _argument_offsets[index + 1];
+
+    return {_method_refs[index], std::span<const uint16_t>(_arguments.data() + begin, end - begin)};
+}
+
+auto BootstrapMethods::of_constant(const ClassFile &class_file, uint16_t index) const -> std::optional<Method> {
+    if (!class_file.is_valid_index(index)) return std::nullopt;
+
+    const auto &info = class_file.constant_pool[index - 1];
+    if (info.tag != ConstantPoolInfo::DYNAMIC && info.tag != ConstantPoolInfo::INVOKE_DYNAMIC) {
+        return std::nullopt;
+    }
+
+    auto method_index = info.info.dynamic_info.boostrap_method_attr_index;
+    if (method_index >= size()) return std::nullopt;
+
+    return method(method_index);
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "bytecode.h"
+
+#include "constant_info.h"
+#include "method_info.h"
+#include "class_file.h"
+#include "field_info.h"
+
+using namespace ares;
+
+auto Bytecode::info(uint8_t opcode) -> const OpcodeInfo & {
+    static constexpr OpcodeInfo infos[256] = {
+        {"nop", 1}, {"aconst_null", 1}, {"iconst_m1", 1}, {"iconst_0", 1},
+        {"iconst_1", 1}, {"iconst_2", 1}, {"iconst_3", 1}, {"iconst_4", 1},
+        {"iconst_5", 1}, {"lconst_0", 1}, {"lconst_1", 1}, {"fconst_0", 1},
+        {"fconst_1", 1}, {"fconst_2", 1}, {"dconst_0", 1}, {"dconst_1", 1},
+        {"bipush", 2}, {"sipush", 3}, {"ldc", 2}, {"ldc_w", 3},
+        {"ldc2_w", 3}, {"iload", 2}, {"lload", 2}, {"fload", 2},
+        {"dload", 2}, {"aload", 2}, {"iload_0", 1}, {"iload_1", 1},
+        {"iload_2", 1}, {"iload_3", 1}, {"lload_0", 1}, {"lload_1", 1},
+        {"lload_2", 1}, {"lload_3", 1}, {"fload_0", 1}, {"fload_1", 1},
+        {"fload_2", 1}, {"fload_3", 1}, {"dload_0", 1}, {"dload_1", 1},
+        {"dload_2", 1}, {"dload_3", 1}, {"aload_0", 1}, {"aload_1", 1},
+        {"aload_2", 1}, {"aload_3", 1}, {"iaload", 1}, {"laload", 1},
+        {"faload", 1}, {"daload", 1}, {"aaload", 1}, {"baload", 1},
+        {"caload", 1}, {"saload", 1}, {"istore", 2}, {"lstore", 2},
+        {"fstore", 2}, {"dstore", 2}, {"astore", 2}, {"istore_0", 1},
+        {"istore_1", 1}, {"istore_2", 1}, {"istore_3", 1}, {"lstore_0", 1},
+        {"lstore_1", 1}, {"lstore_2", 1}, {"lstore_3", 1}, {"fstore_0", 1},
+        {"fstore_1", 1}, {"fstore_2", 1}, {"fstore_3", 1}, {"dstore_0", 1},
+        {"dstore_1", 1}, {"dstore_2", 1}, {"dstore_3", 1}, {"astore_0", 1},
+        {"astore_1", 1}, {"astore_2", 1}, {"astore_3", 1}, {"iastore", 1},
+        {"lastore", 1}, {"fastore", 1}, {"dastore", 1}, {"aastore", 1},
+        {"bastore", 1}, {"castore", 1}, {"sastore", 1}, {"pop", 1},
+        {"pop2", 1}, {"dup", 1}, {"dup_x1", 1}, {"dup_x2", 1},
+        {"dup2", 1}, {"dup2_x1", 1}, {"dup2_x2", 1}, {"swap", 1},
+        {"iadd", 1}, {"ladd", 1}, {"fadd", 1}, {"dadd", 1},
+        {"isub", 1}, {"lsub", 1}, {"fsub", 1}, {"dsub", 1},
+        {"imul", 1}, {"lmul", 1}, {"fmul", 1}, {"dmul", 1},
+        {"idiv", 1}, {"ldiv", 1}, {"fdiv", 1}, {"ddiv", 1},
+        {"irem", 1}, {"lrem", 1}, {"frem", 1}, {"drem", 1},
+        {"ineg", 1}, {"lneg", 1}, {"fneg", 1}, {"dneg", 1},
+        {"ishl", 1}, {"lshl", 1}, {"ishr", 1}, {"lshr", 1},
+        {"iushr", 1}, {"lushr", 1}, {"iand", 1}, {"land", 1},
+        {"ior", 1}, {"lor", 1}, {"ixor", 1}, {"lxor", 1},
+        {"iinc", 3}, {"i2l", 1}, {"i2f", 1}, {"i2d", 1},
+        {"l2i", 1}, {"l2f", 1}, {"l2d", 1}, {"f2i", 1},
+        {"f2l", 1}, {"f2d", 1}, {"d2i", 1}, {"d2l", 1},
+        {"d2f", 1}, {"i2b", 1}, {"i2c", 1}, {"i2s", 1},
+        {"lcmp", 1}, {"fcmpl", 1}, {"fcmpg", 1}, {"dcmpl", 1},
+        {"dcmpg", 1}, {"ifeq", 3}, {"ifne", 3}, {"iflt", 3},
+        {"ifge", 3}, {"ifgt", 3}, {"ifle", 3}, {"if_icmpeq", 3},
+        {"if_icmpne", 3}, {"if_icmplt", 3}, {"if_icmpge", 3}, {"if_icmpgt", 3},
+        {"if_icmple", 3}, {"if_acmpeq", 3}, {"if_acmpne", 3}, {"goto", 3},
+        {"jsr", 3}, {"ret", 2}, {"tableswitch", 0}, {"lookupswitch", 0},
+        {"ireturn", 1}, {"lreturn", 1}, {"freturn", 1}, {"dreturn", 1},
+        {"areturn", 1}, {"return", 1}, {"getstatic", 3}, {"putstatic", 3},
+        {"getfield", 3}, {"putfield", 3}, {"invokevirtual", 3}, {"invokespecial", 3},
+        {"invokestatic", 3}, {"invokeinterface", 5}, {"invokedynamic", 5}, {"new", 3},
+        {"newarray", 2}, {"anewarray", 3}, {"arraylength", 1}, {"athrow", 1},
+        {"checkcast", 3}, {"instanceof", 3}, {"monitorenter", 1}, {"monitorexit", 1},
+        {"wide", 0}, {"multianewarray", 4}, {"ifnull", 3}, {"ifnonnull", 3},
+        {"goto_w", 5}, {"jsr_w", 5}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0},
+    };
+
+    return infos[opcode];
+}
+
+auto Bytecode::instruction_length(std::span<const uint8_t> code, size_t offset) -> size_t {
+    if (offset >= code.size()) return 0;
+
+    auto opcode = code[offset];
+    const auto &opcode_info = Bytecode::info(opcode);
+    if (!opcode_info.name) return 0;
+
+    size_t length = opcode_info.length;
+    if (opcode == Bytecode::WIDE) {
+        if (offset + 1 >= code.size()) return 0;
+        length = code[offset + 1] == Bytecode::IINC ? 6 : 4;
+    } else if (opcode == Bytecode::TABLESWITCH || opcode == Bytecode::LOOKUPSWITCH) {
+        // The operands are aligned to four bytes relative to the start of the code.
+        auto operands = (offset + 4) & ~size_t(3);
+        if (operands + 12 > code.size()) return 0;
+
+        if (opcode == Bytecode::TABLESWITCH) {
+            int64_t low = read_s32(code, operands + 4);
+            int64_t high = read_s32(code, operands + 8);
+            if (high < low) return 0;
+
+            length = operands - offset + 12 + 4 * size_t(high - low + 1);
+        } else {
+            int64_t pairs = read_s32(code, operands + 4);
+            if (pairs < 0) return 0;
+
+            length = operands - offset + 8 + 8 * size_t(pairs);
+        }
+    }
+
+    return offset + length <= code.size() ? length : 0;
+}
+
+auto Bytecode::read_u16(std::span<const uint8_t> code, size_t offset) -> uint16_t {
+    return static_cast<uint16_t>((code[offset] << 8) | code[offset + 1]);
+}
+
+auto Bytecode::read_s32(std::span<const uint8_t> code, size_t offset) -> int32_t {
+    return static_cast<int32_t>((uint32_t(code[offset]) << 24) | (uint32_t(code[offset + 1]) << 16)
+                                | (uint32_t(code[offset + 2]) << 8) | uint32_t(code[offset + 3]));
+}
+
+auto CodeAttribute::find(const ClassFile &class_file, const MethodInfo &method_info) -> const AttributeInfo * {
+    for (const auto &attribute_info: method_info.attributes) {
+        if (class_file.utf8(attribute_info.attribute_name_index) == "Code") return &attribute_info;
+    }
+
+    return nullptr;
+}
+
+auto CodeAttribute::read(const AttributeInfo &attribute_info) -> std::optional<CodeAttribute> {
+    auto data = std::span<const uint8_t>(attribute_info.info, attribute_info.attribute_length);
+    if (data.size() < 8) return std::nullopt;
+
+    CodeAttribute code_attribute;
+    code_attribute.max_stack = Bytecode::read_u16(data, 0);
+    code_attribute.max_locals = Bytecode::read_u16(data, 2);
+
+    size_t code_length = static_cast<uint32_t>(Bytecode::read_s32(data, 4));
+    size_t offset = 8;
+    if (code_length == 0 || code_length >= 65536 || offset + code_length + 2 > data.size()) return std::nullopt;
+
+    code_attribute.code = data.subspan(offset, code_length);
+    offset += code_length;
+
+    size_t exception_count = Bytecode::read_u16(data, offset);
+    offset += 2;
+    if (offset + 8 * exception_count + 2 > data.size()) return std::nullopt;
+
+    code_attribute.exception_table.resize(exception_count);
+    for (auto &entry: code_attribute.exception_table) {
+        entry.start_pc = Bytecode::read_u16(data, offset);
+        entry.end_pc = Bytecode::read_u16(data, offset + 2);
+        entry.handler_pc = Bytecode::read_u16(data, offset + 4);
+        entry.catch_type = Bytecode::read_u16(data, offset + 6);
+        offset += 8;
+    }
+
+    size_t attributes_count = Bytecode::read_u16(data, offset);
+    offset += 2;
+
+    code_attribute.attributes.resize(attributes_count);
+    for (auto &attribute: code_attribute.attributes) {
+        if (offset + 6 > data.size()) return std::nullopt;
+
+        attribute.name_index = Bytecode::read_u16(data, offset);
+        size_t length = static_cast<uint32_t>(Bytecode::read_s32(data, offset + 2));
+        offset += 6;
+
+        if (offset + length > data.size()) return std::nullopt;
+
+        attribute.data = data.subspan(offset, length);
+        offset += length;
+    }
+
+    if (offset != data.size()) return std::nullopt;
+
+    return code_attribute;
+}
+
+auto CodeAttribute::attribute(const ClassFile &class_file, std::string_view name) const -> const Attribute * {
+    for (const auto &item: attributes) {
+        if (class_file.utf8(item.name_index) == name) return &item;
+    }
+
+    return nullptr;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,1637 @@
+#include "bytecode_verifier.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <deque>
+
+#include "descriptor.h"
+#include "parallel.h"
+#include "bytecode.h"
+
+using namespace ares;
+
+namespace {
+
+struct VerifyError {
+    size_t pc{};
+    uint16_t constant_pool_index{};
+    std::string message{};
+};
+
+// Thrown for code the verifier can't check, which is the case for subroutines in classes before version 51.
+struct Unsupported {
+};
+
+struct Type {
+    enum Tag : uint8_t {
+        TOP,
+        INTEGER,
+        FLOAT,
+        LONG,
+        DOUBLE,
+        NULL_TYPE,
+        UNINITIALIZED_THIS,
+        UNINITIALIZED,
+        OBJECT,
+    };
+
+    Tag tag{TOP};
+    // The interned name of objects and the offset of the creating "new" instruction of uninitialized objects.
+    uint32_t data{};
+
+    [[nodiscard]] auto is_category2() const -> bool {
+        return tag == LONG || tag == DOUBLE;
+    }
+
+    [[nodiscard]] auto is_reference() const -> bool {
+        return tag >= NULL_TYPE;
+    }
+
+    [[nodiscard]] auto is_initialized_reference() const -> bool {
+        return tag == NULL_TYPE || tag == OBJECT;
+    }
+
+    auto operator==(const Type &other) const -> bool = default;
+};
+
+// Long and double values take two entries in the locals and on the stack, the second one being TOP.
+struct Frame {
+    std::vector<Type> locals{};
+    std::vector<Type> stack{};
+    bool this_uninitialized{};
+
+    auto operator==(const Frame &other) const -> bool = default;
+};
+
+// Object types are named like the CLASS constants: internal names for classes and descriptors for arrays.
+class Names {
+public:
+    auto intern(std::string_view name) -> uint32_t {
+        auto found = _indices.find(name);
+        if (found != _indices.end()) return found->second;
+
+        const auto &stored = _names.emplace_back(name);
+        auto index = static_cast<uint32_t>(_names.size() - 1);
+        _indices.emplace(stored, index);
+        return index;
+    }
+
+    [[nodiscard]] auto name(uint32_t index) const -> std::string_view {
+        return _names[index];
+    }
+
+private:
+    std::deque<std::string> _names{};
+    std::unordered_map<std::string_view, uint32_t> _indices{};
+};
+
+class MethodVerifier {
+public:
+    MethodVerifier(const ClassFile &class_file, const MethodInfo &method_info, const CodeAttribute &code,
+                   const DescriptorCache &descriptors)
+            : _class_file(class_file), _method_info(method_info), _code(code), _descriptors(descriptors) {
+        _this_class = _names.intern(class_file.class_name(class_file.this_class));
+        _name = class_file.utf8(method_info.name_index);
+        _descriptor = class_file.utf8(method_info.descriptor_index);
+    }
+
+    void verify() {
+        _decode();
+
+        auto initial = _initial_frame();
+        auto stack_map = _code.attribute(_class_file, "StackMapTable");
+
+        // Version 50 classes without a StackMapTable fall back to inference, just like HotSpot does.
+        if (_class_file.major_version >= 51 || (_class_file.major_version == 50 && stack_map)) {
+            _read_stack_map(initial, stack_map);
+            _type_check(initial);
+        } else {
+            _infer(initial);
+        }
+    }
+
+private:
+    [[noreturn]] void _fail(size_t pc, const std::string &message, uint16_t constant_pool_index = 0) {
+        throw VerifyError{pc, constant_pool_index, message};
+    }
+
+    // Decoding
+
+    void _decode() {
+        auto code = _code.code;
+        _starts.assign(code.size() + 1, false);
+
+        size_t pc = 0;
+        while (pc < code.size()) {
+            auto length = Bytecode::instruction_length(code, pc);
+            if (length == 0) _fail(pc, "The instruction is unknown or truncated.");
+
+            auto opcode = code[pc];
+            if (opcode == Bytecode::JSR || opcode == Bytecode::JSR_W || opcode == Bytecode::RET
+                || (opcode == Bytecode::WIDE && code[pc + 1] == Bytecode::RET)) {
+                if (_class_file.major_version >= 51) _fail(pc, "Subroutines aren't allowed since version 51.");
+                throw Unsupported{};
+            }
+
+            _starts[pc] = true;
+            pc += length;
+        }
+
+        _starts[code.size()] = true;
+
+        for (const auto &entry: _code.exception_table) {
+            if (entry.start_pc >= entry.end_pc || !_is_start(entry.start_pc) || entry.end_pc > code.size()
+                || !_starts[entry.end_pc] || !_is_start(entry.handler_pc)) {
+                _fail(entry.handler_pc, "The exception handler range or target is invalid.");
+            }
+
+            if (entry.catch_type != 0 && _class_file.class_name(entry.catch_type).empty()) {
+                _fail(entry.handler_pc, "The catch type is not a class constant pool info.", entry.catch_type);
+            }
+        }
+    }
+
+    [[nodiscard]] auto _is_start(size_t pc) const -> bool {
+        return pc < _code.code.size() && _starts[pc];
+    }
+
+    auto _initial_frame() -> Frame {
+        Frame frame;
+
+        if (!_method_info.has_access_flag(MethodInfo::STATIC)) {
+            if (_name == "<init>" && _names.name(_this_class) != "java/lang/Object") {
+                frame.locals.push_back({Type::UNINITIALIZED_THIS});
+                frame.this_uninitialized = true;
+            } else {
+                frame.locals.push_back({Type::OBJECT, _this_class});
+            }
+        }
+
+        for (auto parameter: _parameters(_descriptor)) {
+            _push_type(frame.locals, _type_of(parameter));
+        }
+
+        if (frame.locals.size() > _code.max_locals) _fail(0, "The parameters don't fit into the local variables.");
+        frame.locals.resize(_code.max_locals);
+
+        return frame;
+    }
+
+    // Types
+
+    static auto _parameters(std::string_view descriptor) -> std::vector<std::string_view> {
+        std::vector<std::string_view> parameters;
+
+        size_t offset = 1;
+        while (offset < descriptor.size() && descriptor[offset] != ')') {
+            auto start = offset;
+            while (descriptor[offset] == '[') offset++;
+            offset = descriptor[offset] == 'L' ? descriptor.find(';', offset) + 1 : offset + 1;
+
+            parameters.push_back(descriptor.substr(start, offset - start));
+        }
+
+        return parameters;
+    }
+
+    static auto _return_type(std::string_view descriptor) -> std::string_view {
+        return descriptor.substr(descriptor.find(')') + 1);
+    }
+
+    auto _type_of(std::string_view field_descriptor) -> Type {
+        switch (field_descriptor[0]) {
+            case 'B':
+            case 'C':
+            case 'I':
+            case 'S':
+            case 'Z':
+                return {Type::INTEGER};
+            case 'F':
+                return {Type::FLOAT};
+            case 'J':
+                return {Type::LONG};
+            case 'D':
+                return {Type::DOUBLE};
+            case 'L':
+                return {Type::OBJECT, _names.intern(field_descriptor.substr(1, field_descriptor.size() - 2))};
+            case '[':
+                return {Type::OBJECT, _names.intern(field_descriptor)};
+            default:
+                return {Type::TOP};
+        }
+    }
+
+    auto _class_type(uint16_t index, size_t pc) -> Type {
+        auto name = _class_file.class_name(index);
+        if (name.empty()) _fail(pc, "The operand is not a class constant pool info.", index);
+
+        return {Type::OBJECT, _names.intern(name)};
+    }
+
+    [[nodiscard]] auto _is_array(const Type &type) const -> bool {
+        return type.tag == Type::OBJECT && _names.name(type.data)[0] == '[';
+    }
+
+    auto _is_assignable(const Type &from, const Type &to) -> bool {
+        if (from == to || to.tag == Type::TOP) return true;
+        if (to.tag != Type::OBJECT) return false;
+        if (from.tag == Type::NULL_TYPE) return true;
+        if (from.tag != Type::OBJECT) return false;
+
+        return _is_name_assignable(_names.name(from.data), _names.name(to.data));
+    }
+
+    static auto _is_name_assignable(std::string_view from, std::string_view to) -> bool {
+        if (from == to || to == "java/lang/Object") return true;
+
+        if (to[0] == '[') {
+            if (from[0] != '[') return false;
+
+            auto from_component = from.substr(1);
+            auto to_component = to.substr(1);
+            if (!_is_reference_descriptor(from_component) || !_is_reference_descriptor(to_component)) {
+                return from_component == to_component;
+            }
+
+            return _is_name_assignable(_unwrap(from_component), _unwrap(to_component));
+        }
+
+        // Arrays only implement these two, the relations between classes are unknown and assumed to hold.
+        if (from[0] == '[') return to == "java/lang/Cloneable" || to == "java/io/Serializable";
+        return true;
+    }
+
+    static auto _is_reference_descriptor(std::string_view descriptor) -> bool {
+        return descriptor[0] == 'L' || descriptor[0] == '[';
+    }
+
+    static auto _unwrap(std::string_view descriptor) -> std::string_view {
+        return descriptor[0] == 'L' ? descriptor.substr(1, descriptor.size() - 2) : descriptor;
+    }
+
+    static auto _wrap(std::string_view name) -> std::string {
+        return name[0] == '[' ? std::string(name) : "L" + std::string(name) + ";";
+    }
+
+    auto _merge(const Type &first, const Type &second) -> Type {
+        if (first == second) return first;
+
+        if (!first.is_initialized_reference() || !second.is_initialized_reference()) return {Type::TOP};
+        if (first.tag == Type::NULL_TYPE) return second;
+        if (second.tag == Type::NULL_TYPE) return first;
+
+        return {Type::OBJECT, _names.intern(_merge_names(_names.name(first.data), _names.name(second.data)))};
+    }
+
+    auto _merge_names(std::string_view first, std::string_view second) -> std::string {
+        if (first == second) return std::string(first);
+
+        if (first[0] == '[' && second[0] == '[') {
+            auto first_component = first.substr(1);
+            auto second_component = second.substr(1);
+
+            if (_is_reference_descriptor(first_component) && _is_reference_descriptor(second_component)) {
+                return "[" + _wrap(_merge_names(_unwrap(first_component), _unwrap(second_component)));
+            }
+        }
+
+        return "java/lang/Object";
+    }
+
+    // Frames
+
+    static void _push_type(std::vector<Type> &types, const Type &type) {
+        types.push_back(type);
+        if (type.is_category2()) types.push_back({Type::TOP});
+    }
+
+    void _push(Frame &frame, const Type &type, size_t pc) {
+        _push_type(frame.stack, type);
+        if (frame.stack.size() > _code.max_stack) _fail(pc, "The operand stack exceeds its maximum size.");
+    }
+
+    auto _pop(Frame &frame, size_t pc) -> Type {
+        if (frame.stack.empty()) _fail(pc, "The operand stack underflows.");
+
+        auto type = frame.stack.back();
+        frame.stack.pop_back();
+        return type;
+    }
+
+    void _pop(Frame &frame, const Type &expected, size_t pc) {
+        if (expected.is_category2()) {
+            auto upper = _pop(frame, pc);
+            auto lower = _pop(frame, pc);
+            if (upper.tag != Type::TOP || lower.tag != expected.tag) _fail(pc, "The operand stack has a wrong type.");
+            return;
+        }
+
+        auto type = _pop(frame, pc);
+        if (!_is_assignable(type, expected)) _fail(pc, "The operand stack has a wrong type.");
+    }
+
+    auto _pop_reference(Frame &frame, size_t pc) -> Type {
+        auto type = _pop(frame, pc);
+        if (!type.is_initialized_reference()) _fail(pc, "The operand stack doesn't hold an initialized reference.");
+        return type;
+    }
+
+    auto _pop_array(Frame &frame, std::string_view first, std::string_view second, size_t pc) -> Type {
+        auto type = _pop(frame, pc);
+        if (type.tag == Type::NULL_TYPE) return type;
+
+        if (type.tag == Type::OBJECT) {
+            auto name = _names.name(type.data);
+            if (name == first || name == second) return type;
+        }
+
+        _fail(pc, "The operand stack doesn't hold an array of the right type.");
+    }
+
+    // Word based stack operations may only cut between values, never through a long or double.
+    void _check_cut(const Frame &frame, size_t depth, size_t pc) {
+        auto size = frame.stack.size();
+        if (size < depth) _fail(pc, "The operand stack underflows.");
+
+        if (depth < size && frame.stack[size - depth].tag == Type::TOP
+            && frame.stack[size - depth - 1].is_category2()) {
+            _fail(pc, "The instruction splits a long or double value.");
+        }
+    }
+
+    // Moves copies of the top words of the stack below the given depth.
+    void _duplicate(Frame &frame, size_t words, size_t depth, size_t pc) {
+        _check_cut(frame, words, pc);
+        _check_cut(frame, depth, pc);
+
+        std::vector<Type> copied(frame.stack.end() - words, frame.stack.end());
+        frame.stack.insert(frame.stack.end() - depth, copied.begin(), copied.end());
+        if (frame.stack.size() > _code.max_stack) _fail(pc, "The operand stack exceeds its maximum size.");
+    }
+
+    void _load(Frame &frame, size_t index, Type::Tag tag, size_t pc) {
+        auto size = tag == Type::LONG || tag == Type::DOUBLE ? 2 : 1;
+        if (index + size > frame.locals.size()) _fail(pc, "The local variable index is out of range.");
+
+        const auto &type = frame.locals[index];
+        if (tag == Type::OBJECT) {
+            if (!type.is_reference() || type.tag == Type::TOP) _fail(pc, "The local variable doesn't hold a reference.");
+        } else if (type.tag != tag || (size == 2 && frame.locals[index + 1].tag != Type::TOP)) {
+            _fail(pc, "The local variable has a wrong type.");
+        }
+
+        _push(frame, type, pc);
+    }
+
+    void _store(Frame &frame, size_t index, Type::Tag tag, size_t pc) {
+        Type type;
+        if (tag == Type::OBJECT) {
+            type = _pop(frame, pc);
+            if (!type.is_reference()) _fail(pc, "The operand stack doesn't hold a reference.");
+        } else {
+            type = {tag};
+            _pop(frame, type, pc);
+        }
+
+        _set_local(frame, index, type, pc);
+    }
+
+    void _set_local(Frame &frame, size_t index, const Type &type, size_t pc) {
+        auto size = type.is_category2() ? 2 : 1;
+        if (index + size > frame.locals.size()) _fail(pc, "The local variable index is out of range.");
+
+        // Overwriting the second half of a long or double invalidates the whole value.
+        if (index > 0 && frame.locals[index - 1].is_category2()) frame.locals[index - 1] = {Type::TOP};
+
+        frame.locals[index] = type;
+        if (size == 2) frame.locals[index + 1] = {Type::TOP};
+    }
+
+    void _replace_uninitialized(Frame &frame, const Type &uninitialized, const Type &initialized) {
+        for (auto &type: frame.locals) {
+            if (type == uninitialized) type = initialized;
+        }
+
+        for (auto &type: frame.stack) {
+            if (type == uninitialized) type = initialized;
+        }
+    }
+
+    auto _is_frame_assignable(const Frame &from, const Frame &to) -> bool {
+        if (from.stack.size() != to.stack.size() || from.locals.size() != to.locals.size()) return false;
+        if (from.this_uninitialized && !to.this_uninitialized) return false;
+
+        for (size_t index = 0; index < from.locals.size(); index++) {
+            if (!_is_assignable(from.locals[index], to.locals[index])) return false;
+        }
+
+        for (size_t index = 0; index < from.stack.size(); index++) {
+            if (!_is_assignable(from.stack[index], to.stack[index])) return false;
+        }
+
+        return true;
+    }
+
+    auto _handler_frame(const Frame &frame, const AttributeType::ExceptionEntry &entry) -> Frame {
+        Frame handler;
+        handler.locals = frame.locals;
+        handler.this_uninitialized = frame.this_uninitialized;
+        handler.stack.push_back(entry.catch_type == 0 ? Type{Type::OBJECT, _names.intern("java/lang/Throwable")}
+                                                      : _class_type(entry.catch_type, entry.handler_pc));
+        return handler;
+    }
+
+    // Stack maps
+
+    auto _read_verification_type(std::span<const uint8_t> data, size_t &offset) -> Type {
+        if (offset >= data.size()) _fail(0, "The StackMapTable is truncated.");
+
+        auto tag = data[offset++];
+        if (tag <= 6) {
+            constexpr Type::Tag tags[] = {Type::TOP, Type::INTEGER, Type::FLOAT, Type::DOUBLE, Type::LONG,
+                                          Type::NULL_TYPE, Type::UNINITIALIZED_THIS};
+            return {tags[tag]};
+        }
+
+        if (tag > 8 || offset + 2 > data.size()) _fail(0, "The StackMapTable has an invalid verification type.");
+
+        auto value = Bytecode::read_u16(data, offset);
+        offset += 2;
+
+        if (tag == 7) return _class_type(value, 0);
+
+        if (!_is_start(value) || _code.code[value] != Bytecode::NEW) {
+            _fail(0, "The uninitialized type doesn't point at a new instruction.");
+        }
+
+        return {Type::UNINITIALIZED, value};
+    }
+
+    void _read_types(std::span<const uint8_t> data, size_t &offset, size_t count, std::vector<Type> &types) {
+        for (size_t index = 0; index < count; index++) {
+            _push_type(types, _read_verification_type(data, offset));
+        }
+    }
+
+    void _read_stack_map(const Frame &initial, const CodeAttribute::Attribute *stack_map) {
+        _frame_indices.assign(_code.code.size(), -1);
+        if (!stack_map) return;
+
+        auto data = stack_map->data;
+        if (data.size() < 2) _fail(0, "The StackMapTable is truncated.");
+
+        // The locals are tracked without their trailing TOP entries, as chop and append frames count from there.
+        auto locals = initial.locals;
+        while (!locals.empty() && locals.back().tag == Type::TOP
+               && !(locals.size() >= 2 && locals[locals.size() - 2].is_category2())) {
+            locals.pop_back();
+        }
+
+        size_t offset = 2;
+        int64_t pc = -1;
+
+        for (size_t count = Bytecode::read_u16(data, 0); count > 0; count--) {
+            if (offset >= data.size()) _fail(0, "The StackMapTable is truncated.");
+
+            auto type = data[offset++];
+            size_t delta;
+            std::vector<Type> stack;
+
+            auto read_delta = [&]() {
+                if (offset + 2 > data.size()) _fail(0, "The StackMapTable is truncated.");
+                delta = Bytecode::read_u16(data, offset);
+                offset += 2;
+            };
+
+            if (type <= 63) {
+                delta = type;
+            } else if (type <= 127) {
+                delta = type - 64;
+                _read_types(data, offset, 1, stack);
+            } else if (type == 247) {
+                read_delta();
+                _read_types(data, offset, 1, stack);
+            } else if (type >= 248 && type <= 250) {
+                read_delta();
+                for (auto chopped = 251 - type; chopped > 0; chopped--) {
+                    if (locals.empty()) _fail(0, "The StackMapTable chops more locals than there are.");
+
+                    auto removed = locals.back();
+                    locals.pop_back();
+                    if (removed.tag == Type::TOP && !locals.empty() && locals.back().is_category2()) locals.pop_back();
+                }
+            } else if (type == 251) {
+                read_delta();
+            } else if (type >= 252 && type <= 254) {
+                read_delta();
+                _read_types(data, offset, type - 251, locals);
+            } else if (type == 255) {
+                read_delta();
+
+                if (offset + 2 > data.size()) _fail(0, "The StackMapTable is truncated.");
+                auto locals_count = Bytecode::read_u16(data, offset);
+                offset += 2;
+
+                locals.clear();
+                _read_types(data, offset, locals_count, locals);
+
+                if (offset + 2 > data.size()) _fail(0, "The StackMapTable is truncated.");
+                auto stack_count = Bytecode::read_u16(data, offset);
+                offset += 2;
+
+                _read_types(data, offset, stack_count, stack);
+            } else {
+                _fail(0, "The StackMapTable has an invalid frame type.");
+            }
+
+            pc += static_cast<int64_t>(delta) + 1;
+            if (!_is_start(static_cast<size_t>(pc))) _fail(0, "The stack map frame isn't at an instruction.");
+
+            if (locals.size() > _code.max_locals) _fail(pc, "The stack map frame has too many locals.");
+            if (stack.size() > _code.max_stack) _fail(pc, "The stack map frame has too many stack entries.");
+
+            Frame frame;
+            frame.locals = locals;
+            frame.locals.resize(_code.max_locals);
+            frame.stack = std::move(stack);
+            frame.this_uninitialized = std::any_of(frame.locals.begin(), frame.locals.end(), [](const Type &local) {
+                return local.tag == Type::UNINITIALIZED_THIS;
+            });
+
+            _frame_indices[pc] = static_cast<int32_t>(_frames.size());
+            _frames.push_back(std::move(frame));
+        }
+
+        if (offset != data.size()) _fail(0, "The StackMapTable has trailing bytes.");
+    }
+
+    void _check_target(const Frame &frame, size_t target, size_t pc) {
+        if (_frame_indices[target] < 0) _fail(pc, "There is no stack map frame at the branch target.");
+        if (!_is_frame_assignable(frame, _frames[_frame_indices[target]])) {
+            _fail(pc, "The frame isn't assignable to the stack map frame of the branch target.");
+        }
+    }
+
+    void _type_check(const Frame &initial) {
+        auto code = _code.code;
+        auto frame = initial;
+        auto reachable = true;
+        std::vector<size_t> targets;
+
+        for (size_t pc = 0; pc < code.size(); pc += Bytecode::instruction_length(code, pc)) {
+            if (_frame_indices[pc] >= 0) {
+                const auto &stack_map_frame = _frames[_frame_indices[pc]];
+                if (reachable && !_is_frame_assignable(frame, stack_map_frame)) {
+                    _fail(pc, "The frame isn't assignable to the stack map frame.");
+                }
+
+                frame = stack_map_frame;
+            } else if (!reachable) {
+                _fail(pc, "There is no stack map frame after an unconditional branch.");
+            }
+
+            auto incoming = frame;
+            targets.clear();
+            reachable = _execute(pc, frame, targets);
+
+            for (auto target: targets) {
+                _check_target(frame, target, pc);
+            }
+
+            for (const auto &entry: _code.exception_table) {
+                if (pc < entry.start_pc || pc >= entry.end_pc) continue;
+
+                _check_target(_handler_frame(incoming, entry), entry.handler_pc, pc);
+                if (frame.locals != incoming.locals) _check_target(_handler_frame(frame, entry), entry.handler_pc, pc);
+            }
+        }
+
+        if (reachable) _fail(code.size(), "The execution falls off the end of the code.");
+    }
+
+    void _infer(const Frame &initial) {
+        auto code = _code.code;
+        _frame_indices.assign(code.size(), -1);
+
+        std::vector<size_t> work;
+        std::vector<size_t> targets;
+
+        auto merge_into = [&](size_t target, const Frame &frame, size_t pc) {
+            auto &index = _frame_indices[target];
+            if (index < 0) {
+                index = static_cast<int32_t>(_frames.size());
+                _frames.push_back(frame);
+                work.push_back(target);
+                return;
+            }
+
+            auto &existing = _frames[index];
+            if (existing.stack.size() != frame.stack.size()) _fail(pc, "The operand stack heights don't match.");
+
+            Frame merged;
+            merged.this_uninitialized = existing.this_uninitialized || frame.this_uninitialized;
+            for (size_t local = 0; local < existing.locals.size(); local++) {
+                merged.locals.push_back(_merge(existing.locals[local], frame.locals[local]));
+            }
+            for (size_t entry = 0; entry < existing.stack.size(); entry++) {
+                merged.stack.push_back(_merge(existing.stack[entry], frame.stack[entry]));
+            }
+
+            if (merged != existing) {
+                existing = std::move(merged);
+                work.push_back(target);
+            }
+        };
+
+        merge_into(0, initial, 0);
+
+        while (!work.empty()) {
+            auto pc = work.back();
+            work.pop_back();
+
+            auto frame = _frames[_frame_indices[pc]];
+            auto incoming = frame;
+
+            targets.clear();
+            auto falls_through = _execute(pc, frame, targets);
+
+            for (const auto &entry: _code.exception_table) {
+                if (pc < entry.start_pc || pc >= entry.end_pc) continue;
+
+                merge_into(entry.handler_pc, _handler_frame(incoming, entry), pc);
+                if (frame.locals != incoming.locals) merge_into(entry.handler_pc, _handler_frame(frame, entry), pc);
+            }
+
+            for (auto target: targets) {
+                merge_into(target, frame, pc);
+            }
+
+            if (falls_through) {
+                auto next = pc + Bytecode::instruction_length(code, pc);
+                if (next >= code.size()) _fail(pc, "The execution falls off the end of the code.");
+
+                merge_into(next, frame, pc);
+            }
+        }
+    }
+
+    // Instructions
+
+    void _branch(size_t pc, int64_t offset, std::vector<size_t> &targets) {
+        auto target = static_cast<int64_t>(pc) + offset;
+        if (target < 0 || !_is_start(static_cast<size_t>(target))) _fail(pc, "The branch target isn't an instruction.");
+
+        targets.push_back(static_cast<size_t>(target));
+    }
+
+    auto _member_ref(uint16_t index, size_t pc) -> ClassFile::MemberRef {
+        auto member_ref = _class_file.member_ref(index);
+        if (!member_ref) _fail(pc, "The reference has an invalid class, name or descriptor.", index);
+        return *member_ref;
+    }
+
+    auto _expect_tag(uint16_t index, std::initializer_list<ConstantPoolInfo::ConstantTag> tags, size_t pc)
+    -> ConstantPoolInfo::ConstantTag {
+        if (!_class_file.is_valid_index(index)) _fail(pc, "The operand is not a valid constant pool index.", index);
+
+        auto tag = _class_file.constant_pool[index - 1].tag;
+        if (std::find(tags.begin(), tags.end(), tag) == tags.end()) {
+            _fail(pc, "The operand points at a constant pool info of the wrong kind.", index);
+        }
+
+        return tag;
+    }
+
+    void _field_instruction(uint8_t opcode, uint16_t index, Frame &frame, size_t pc) {
+        _expect_tag(index, {ConstantPoolInfo::FIELD_REF}, pc);
+        auto member_ref = _member_ref(index, pc);
+
+        if (!_descriptors.field(_class_file, member_ref.descriptor_index)) {
+            _fail(pc, "The field reference has an invalid descriptor.", index);
+        }
+
+        auto type = _type_of(member_ref.descriptor);
+        Type owner{Type::OBJECT, _names.intern(member_ref.owner)};
+
+        switch (opcode) {
+            case Bytecode::GETSTATIC:
+                _push(frame, type, pc);
+                break;
+            case Bytecode::PUTSTATIC:
+                _pop(frame, type, pc);
+                break;
+            case Bytecode::GETFIELD:
+                _pop(frame, owner, pc);
+                _push(frame, type, pc);
+                break;
+            default: {
+                _pop(frame, type, pc);
+
+                // Constructors may assign the fields of their own class before calling the super constructor.
+                auto receiver = _pop(frame, pc);
+                if (receiver.tag == Type::UNINITIALIZED_THIS && owner.data == _this_class) break;
+                if (!_is_assignable(receiver, owner)) _fail(pc, "The field receiver has a wrong type.", index);
+            }
+        }
+    }
+
+    void _invoke_instruction(uint8_t opcode, uint16_t index, Frame &frame, size_t pc) {
+        auto code = _code.code;
+        auto interface_allowed = _class_file.major_version >= 52;
+
+        switch (opcode) {
+            case Bytecode::INVOKEVIRTUAL:
+                _expect_tag(index, {ConstantPoolInfo::METHOD_REF}, pc);
+                break;
+            case Bytecode::INVOKESPECIAL:
+            case Bytecode::INVOKESTATIC:
+                if (interface_allowed) {
+                    _expect_tag(index, {ConstantPoolInfo::METHOD_REF, ConstantPoolInfo::INTERFACE_METHOD_REF}, pc);
+                } else {
+                    _expect_tag(index, {ConstantPoolInfo::METHOD_REF}, pc);
+                }
+                break;
+            case Bytecode::INVOKEINTERFACE:
+                _expect_tag(index, {ConstantPoolInfo::INTERFACE_METHOD_REF}, pc);
+                break;
+            default:
+                _expect_tag(index, {ConstantPoolInfo::INVOKE_DYNAMIC}, pc);
+                if (code[pc + 3] != 0 || code[pc + 4] != 0) _fail(pc, "The invokedynamic operands aren't zero.");
+        }
+
+        auto member_ref = _member_ref(index, pc);
+        auto descriptor = _descriptors.method(_class_file, member_ref.descriptor_index);
+        if (!descriptor) _fail(pc, "The method reference has an invalid descriptor.", index);
+
+        auto is_init = member_ref.name == "<init>";
+        if (member_ref.name == "<clinit>" || (is_init && opcode != Bytecode::INVOKESPECIAL)) {
+            _fail(pc, "The instruction can't invoke an initialization method.", index);
+        }
+
+        if (opcode == Bytecode::INVOKEINTERFACE
+            && (code[pc + 3] != descriptor->parameter_slots + 1 || code[pc + 4] != 0)) {
+            _fail(pc, "The invokeinterface count doesn't match the descriptor.", index);
+        }
+
+        auto method_descriptor = member_ref.descriptor;
+        auto parameters = _parameters(method_descriptor);
+        for (auto parameter = parameters.rbegin(); parameter != parameters.rend(); parameter++) {
+            _pop(frame, _type_of(*parameter), pc);
+        }
+
+        if (opcode != Bytecode::INVOKESTATIC && opcode != Bytecode::INVOKEDYNAMIC) {
+            Type owner{Type::OBJECT, _names.intern(member_ref.owner)};
+            auto receiver = _pop(frame, pc);
+
+            if (is_init) {
+                if (descriptor->return_kind != Descriptor::VOID) _fail(pc, "Initialization methods return void.", index);
+
+                Type initialized;
+                if (receiver.tag == Type::UNINITIALIZED_THIS) {
+                    initialized = {Type::OBJECT, _this_class};
+                    frame.this_uninitialized = false;
+                } else if (receiver.tag == Type::UNINITIALIZED) {
+                    initialized = _class_type(Bytecode::read_u16(code, receiver.data + 1), pc);
+                } else {
+                    _fail(pc, "The constructor receiver is already initialized.", index);
+                }
+
+                _replace_uninitialized(frame, receiver, initialized);
+            } else if (!receiver.is_initialized_reference() || !_is_assignable(receiver, owner)) {
+                _fail(pc, "The method receiver has a wrong type.", index);
+            }
+        }
+
+        auto return_type = _return_type(method_descriptor);
+        if (return_type != "V") _push(frame, _type_of(return_type), pc);
+    }
+
+    void _ldc_instruction(uint8_t opcode, uint16_t index, Frame &frame, size_t pc) {
+        auto version = _class_file.major_version;
+
+        if (opcode == Bytecode::LDC2_W) {
+            auto tag = _expect_tag(index, {ConstantPoolInfo::LONG, ConstantPoolInfo::DOUBLE,
+                                           ConstantPoolInfo::DYNAMIC}, pc);
+            if (tag == ConstantPoolInfo::DYNAMIC) {
+                auto type = _dynamic_type(index, pc);
+                if (!type.is_category2()) _fail(pc, "The ldc2_w constant is not a long or double.", index);
+
+                _push(frame, type, pc);
+            } else {
+                _push(frame, {tag == ConstantPoolInfo::LONG ? Type::LONG : Type::DOUBLE}, pc);
+            }
+            return;
+        }
+
+        auto tag = _expect_tag(index, {ConstantPoolInfo::INTEGER, ConstantPoolInfo::FLOAT, ConstantPoolInfo::STRING,
+                                       ConstantPoolInfo::CLASS, ConstantPoolInfo::METHOD_TYPE,
+                                       ConstantPoolInfo::METHOD_HANDLE, ConstantPoolInfo::DYNAMIC}, pc);
+
+        switch (tag) {
+            case ConstantPoolInfo::INTEGER:
+                _push(frame, {Type::INTEGER}, pc);
+                break;
+            case ConstantPoolInfo::FLOAT:
+                _push(frame, {Type::FLOAT}, pc);
+                break;
+            case ConstantPoolInfo::STRING:
+                _push(frame, {Type::OBJECT, _names.intern("java/lang/String")}, pc);
+                break;
+            case ConstantPoolInfo::CLASS:
+                if (version < 49) _fail(pc, "Class constants can only be loaded since version 49.", index);
+                _push(frame, {Type::OBJECT, _names.intern("java/lang/Class")}, pc);
+                break;
+            case ConstantPoolInfo::METHOD_TYPE:
+                if (version < 51) _fail(pc, "Method types can only be loaded since version 51.", index);
+                _push(frame, {Type::OBJECT, _names.intern("java/lang/invoke/MethodType")}, pc);
+                break;
+            case ConstantPoolInfo::METHOD_HANDLE:
+                if (version < 51) _fail(pc, "Method handles can only be loaded since version 51.", index);
+                _push(frame, {Type::OBJECT, _names.intern("java/lang/invoke/MethodHandle")}, pc);
+                break;
+            default: {
+                auto type = _dynamic_type(index, pc);
+                if (type.is_category2()) _fail(pc, "The ldc constant is a long or double.", index);
+
+                _push(frame, type, pc);
+            }
+        }
+    }
+
+    auto _dynamic_type(uint16_t index, size_t pc) -> Type {
+        if (_class_file.major_version < 55) _fail(pc, "Dynamic constants can only be loaded since version 55.", index);
+
+        auto member_ref = _member_ref(index, pc);
+        if (!_descriptors.field(_class_file, member_ref.descriptor_index)) {
+            _fail(pc, "The dynamic constant has an invalid descriptor.", index);
+        }
+
+        return _type_of(member_ref.descriptor);
+    }
+
+    void _return_instruction(Type::Tag tag, Frame &frame, size_t pc) {
+        auto return_type = _return_type(_descriptor);
+
+        if (tag == Type::TOP) {
+            if (return_type != "V") _fail(pc, "The method needs to return a value.");
+            if (frame.this_uninitialized) _fail(pc, "The constructor returns without initializing this.");
+            return;
+        }
+
+        auto expected = _type_of(return_type);
+        if (expected.tag != tag) _fail(pc, "The return instruction doesn't match the return type.");
+
+        _pop(frame, expected, pc);
+    }
+
+    // Executes the instruction on the frame and collects its branch targets. Returns false if the execution doesn't
+    // continue with the next instruction.
+    auto _execute(size_t pc, Frame &frame, std::vector<size_t> &targets) -> bool {
+        auto code = _code.code;
+        auto opcode = code[pc];
+
+        const Type integer{Type::INTEGER}, floating{Type::FLOAT}, long_type{Type::LONG}, double_type{Type::DOUBLE};
+
+        auto binary = [&](const Type &type) {
+            _pop(frame, type, pc);
+            _pop(frame, type, pc);
+            _push(frame, type, pc);
+        };
+
+        auto convert = [&](const Type &from, const Type &to) {
+            _pop(frame, from, pc);
+            _push(frame, to, pc);
+        };
+
+        switch (opcode) {
+            case Bytecode::NOP:
+                break;
+            case Bytecode::ACONST_NULL:
+                _push(frame, {Type::NULL_TYPE}, pc);
+                break;
+            case Bytecode::ICONST_M1:
+            case Bytecode::ICONST_0:
+            case Bytecode::ICONST_1:
+            case Bytecode::ICONST_2:
+            case Bytecode::ICONST_3:
+            case Bytecode::ICONST_4:
+            case Bytecode::ICONST_5:
+            case Bytecode::BIPUSH:
+            case Bytecode::SIPUSH:
+                _push(frame, integer, pc);
+                break;
+            case Bytecode::LCONST_0:
+            case Bytecode::LCONST_1:
+                _push(frame, long_type, pc);
+                break;
+            case Bytecode::FCONST_0:
+            case Bytecode::FCONST_1:
+            case Bytecode::FCONST_2:
+                _push(frame, floating, pc);
+                break;
+            case Bytecode::DCONST_0:
+            case Bytecode::DCONST_1:
+                _push(frame, double_type, pc);
+                break;
+            case Bytecode::LDC:
+                _ldc_instruction(opcode, code[pc + 1], frame, pc);
+                break;
+            case Bytecode::LDC_W:
+            case Bytecode::LDC2_W:
+                _ldc_instruction(opcode, Bytecode::read_u16(code, pc + 1), frame, pc);
+                break;
+            case Bytecode::ILOAD:
+                _load(frame, code[pc + 1], Type::INTEGER, pc);
+                break;
+            case Bytecode::LLOAD:
+                _load(frame, code[pc + 1], Type::LONG, pc);
+                break;
+            case Bytecode::FLOAD:
+                _load(frame, code[pc + 1], Type::FLOAT, pc);
+                break;
+            case Bytecode::DLOAD:
+                _load(frame, code[pc + 1], Type::DOUBLE, pc);
+                break;
+            case Bytecode::ALOAD:
+                _load(frame, code[pc + 1], Type::OBJECT, pc);
+                break;
+            case Bytecode::ILOAD_0:
+            case Bytecode::ILOAD_1:
+            case Bytecode::ILOAD_2:
+            case Bytecode::ILOAD_3:
+                _load(frame, opcode - Bytecode::ILOAD_0, Type::INTEGER, pc);
+                break;
+            case Bytecode::LLOAD_0:
+            case Bytecode::LLOAD_1:
+            case Bytecode::LLOAD_2:
+            case Bytecode::LLOAD_3:
+                _load(frame, opcode - Bytecode::LLOAD_0, Type::LONG, pc);
+                break;
+            case Bytecode::FLOAD_0:
+            case Bytecode::FLOAD_1:
+            case Bytecode::FLOAD_2:
+            case Bytecode::FLOAD_3:
+                _load(frame, opcode - Bytecode::FLOAD_0, Type::FLOAT, pc);
+                break;
+            case Bytecode::DLOAD_0:
+            case Bytecode::DLOAD_1:
+            case Bytecode::DLOAD_2:
+            case Bytecode::DLOAD_3:
+                _load(frame, opcode - Bytecode::DLOAD_0, Type::DOUBLE, pc);
+                break;
+            case Bytecode::ALOAD_0:
+            case Bytecode::ALOAD_1:
+            case Bytecode::ALOAD_2:
+            case Bytecode::ALOAD_3:
+                _load(frame, opcode - Bytecode::ALOAD_0, Type::OBJECT, pc);
+                break;
+            case Bytecode::IALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[I", "[I", pc);
+                _push(frame, integer, pc);
+                break;
+            case Bytecode::LALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[J", "[J", pc);
+                _push(frame, long_type, pc);
+                break;
+            case Bytecode::FALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[F", "[F", pc);
+                _push(frame, floating, pc);
+                break;
+            case Bytecode::DALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[D", "[D", pc);
+                _push(frame, double_type, pc);
+                break;
+            case Bytecode::BALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[B", "[Z", pc);
+                _push(frame, integer, pc);
+                break;
+            case Bytecode::CALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[C", "[C", pc);
+                _push(frame, integer, pc);
+                break;
+            case Bytecode::SALOAD:
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[S", "[S", pc);
+                _push(frame, integer, pc);
+                break;
+            case Bytecode::AALOAD: {
+                _pop(frame, integer, pc);
+                auto array = _pop(frame, pc);
+                if (array.tag == Type::NULL_TYPE) {
+                    _push(frame, array, pc);
+                    break;
+                }
+
+                if (!_is_array(array) || !_is_reference_descriptor(_names.name(array.data).substr(1))) {
+                    _fail(pc, "The operand stack doesn't hold an array of references.");
+                }
+
+                _push(frame, _type_of(_names.name(array.data).substr(1)), pc);
+                break;
+            }
+            case Bytecode::ISTORE:
+                _store(frame, code[pc + 1], Type::INTEGER, pc);
+                break;
+            case Bytecode::LSTORE:
+                _store(frame, code[pc + 1], Type::LONG, pc);
+                break;
+            case Bytecode::FSTORE:
+                _store(frame, code[pc + 1], Type::FLOAT, pc);
+                break;
+            case Bytecode::DSTORE:
+                _store(frame, code[pc + 1], Type::DOUBLE, pc);
+                break;
+            case Bytecode::ASTORE:
+                _store(frame, code[pc + 1], Type::OBJECT, pc);
+                break;
+            case Bytecode::ISTORE_0:
+            case Bytecode::ISTORE_1:
+            case Bytecode::ISTORE_2:
+            case Bytecode::ISTORE_3:
+                _store(frame, opcode - Bytecode::ISTORE_0, Type::INTEGER, pc);
+                break;
+            case Bytecode::LSTORE_0:
+            case Bytecode::LSTORE_1:
+            case Bytecode::LSTORE_2:
+            case Bytecode::LSTORE_3:
+                _store(frame, opcode - Bytecode::LSTORE_0, Type::LONG, pc);
+                break;
+            case Bytecode::FSTORE_0:
+            case Bytecode::FSTORE_1:
+            case Bytecode::FSTORE_2:
+            case Bytecode::FSTORE_3:
+                _store(frame, opcode - Bytecode::FSTORE_0, Type::FLOAT, pc);
+                break;
+            case Bytecode::DSTORE_0:
+            case Bytecode::DSTORE_1:
+            case Bytecode::DSTORE_2:
+            case Bytecode::DSTORE_3:
+                _store(frame, opcode - Bytecode::DSTORE_0, Type::DOUBLE, pc);
+                break;
+            case Bytecode::ASTORE_0:
+            case Bytecode::ASTORE_1:
+            case Bytecode::ASTORE_2:
+            case Bytecode::ASTORE_3:
+                _store(frame, opcode - Bytecode::ASTORE_0, Type::OBJECT, pc);
+                break;
+            case Bytecode::IASTORE:
+                _pop(frame, integer, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[I", "[I", pc);
+                break;
+            case Bytecode::LASTORE:
+                _pop(frame, long_type, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[J", "[J", pc);
+                break;
+            case Bytecode::FASTORE:
+                _pop(frame, floating, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[F", "[F", pc);
+                break;
+            case Bytecode::DASTORE:
+                _pop(frame, double_type, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[D", "[D", pc);
+                break;
+            case Bytecode::BASTORE:
+                _pop(frame, integer, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[B", "[Z", pc);
+                break;
+            case Bytecode::CASTORE:
+                _pop(frame, integer, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[C", "[C", pc);
+                break;
+            case Bytecode::SASTORE:
+                _pop(frame, integer, pc);
+                _pop(frame, integer, pc);
+                _pop_array(frame, "[S", "[S", pc);
+                break;
+            case Bytecode::AASTORE: {
+                // The component type of the stored value is checked at runtime.
+                _pop_reference(frame, pc);
+                _pop(frame, integer, pc);
+
+                auto array = _pop(frame, pc);
+                if (array.tag != Type::NULL_TYPE
+                    && (!_is_array(array) || !_is_reference_descriptor(_names.name(array.data).substr(1)))) {
+                    _fail(pc, "The operand stack doesn't hold an array of references.");
+                }
+                break;
+            }
+            case Bytecode::POP:
+                _check_cut(frame, 1, pc);
+                frame.stack.pop_back();
+                break;
+            case Bytecode::POP2:
+                _check_cut(frame, 2, pc);
+                frame.stack.resize(frame.stack.size() - 2);
+                break;
+            case Bytecode::DUP:
+                _duplicate(frame, 1, 1, pc);
+                break;
+            case Bytecode::DUP_X1:
+                _duplicate(frame, 1, 2, pc);
+                break;
+            case Bytecode::DUP_X2:
+                _duplicate(frame, 1, 3, pc);
+                break;
+            case Bytecode::DUP2:
+                _duplicate(frame, 2, 2, pc);
+                break;
+            case Bytecode::DUP2_X1:
+                _duplicate(frame, 2, 3, pc);
+                break;
+            case Bytecode::DUP2_X2:
+                _duplicate(frame, 2, 4, pc);
+                break;
+            case Bytecode::SWAP:
+                _check_cut(frame, 1, pc);
+                _check_cut(frame, 2, pc);
+                std::swap(frame.stack[frame.stack.size() - 1], frame.stack[frame.stack.size() - 2]);
+                break;
+            case Bytecode::IADD:
+            case Bytecode::ISUB:
+            case Bytecode::IMUL:
+            case Bytecode::IDIV:
+            case Bytecode::IREM:
+            case Bytecode::ISHL:
+            case Bytecode::ISHR:
+            case Bytecode::IUSHR:
+            case Bytecode::IAND:
+            case Bytecode::IOR:
+            case Bytecode::IXOR:
+                binary(integer);
+                break;
+            case Bytecode::LADD:
+            case Bytecode::LSUB:
+            case Bytecode::LMUL:
+            case Bytecode::LDIV:
+            case Bytecode::LREM:
+            case Bytecode::LAND:
+            case Bytecode::LOR:
+            case Bytecode::LXOR:
+                binary(long_type);
+                break;
+            case Bytecode::FADD:
+            case Bytecode::FSUB:
+            case Bytecode::FMUL:
+            case Bytecode::FDIV:
+            case Bytecode::FREM:
+                binary(floating);
+                break;
+            case Bytecode::DADD:
+            case Bytecode::DSUB:
+            case Bytecode::DMUL:
+            case Bytecode::DDIV:
+            case Bytecode::DREM:
+                binary(double_type);
+                break;
+            case Bytecode::INEG:
+            case Bytecode::I2B:
+            case Bytecode::I2C:
+            case Bytecode::I2S:
+                convert(integer, integer);
+                break;
+            case Bytecode::LNEG:
+                convert(long_type, long_type);
+                break;
+            case Bytecode::FNEG:
+                convert(floating, floating);
+                break;
+            case Bytecode::DNEG:
+                convert(double_type, double_type);
+                break;
+            case Bytecode::LSHL:
+            case Bytecode::LSHR:
+            case Bytecode::LUSHR:
+                _pop(frame, integer, pc);
+                convert(long_type, long_type);
+                break;
+            case Bytecode::IINC: {
+                auto index = code[pc + 1];
+                if (index >= frame.locals.size() || frame.locals[index].tag != Type::INTEGER) {
+                    _fail(pc, "The local variable isn't an int.");
+                }
+                break;
+            }
+            case Bytecode::I2L:
+                convert(integer, long_type);
+                break;
+            case Bytecode::I2F:
+                convert(integer, floating);
+                break;
+            case Bytecode::I2D:
+                convert(integer, double_type);
+                break;
+            case Bytecode::L2I:
+                convert(long_type, integer);
+                break;
+            case Bytecode::L2F:
+                convert(long_type, floating);
+                break;
+            case Bytecode::L2D:
+                convert(long_type, double_type);
+                break;
+            case Bytecode::F2I:
+                convert(floating, integer);
+                break;
+            case Bytecode::F2L:
+                convert(floating, long_type);
+                break;
+            case Bytecode::F2D:
+                convert(floating, double_type);
+                break;
+            case Bytecode::D2I:
+                convert(double_type, integer);
+                break;
+            case Bytecode::D2L:
+                convert(double_type, long_type);
+                break;
+            case Bytecode::D2F:
+                convert(double_type, floating);
+                break;
+            case Bytecode::LCMP:
+                _pop(frame, long_type, pc);
+                convert(long_type, integer);
+                break;
+            case Bytecode::FCMPL:
+            case Bytecode::FCMPG:
+                _pop(frame, floating, pc);
+                convert(floating, integer);
+                break;
+            case Bytecode::DCMPL:
+            case Bytecode::DCMPG:
+                _pop(frame, double_type, pc);
+                convert(double_type, integer);
+                break;
+            case Bytecode::IFEQ:
+            case Bytecode::IFNE:
+            case Bytecode::IFLT:
+            case Bytecode::IFGE:
+            case Bytecode::IFGT:
+            case Bytecode::IFLE:
+                _pop(frame, integer, pc);
+                _branch(pc, static_cast<int16_t>(Bytecode::read_u16(code, pc + 1)), targets);
+                break;
+            case Bytecode::IF_ICMPEQ:
+            case Bytecode::IF_ICMPNE:
+            case Bytecode::IF_ICMPLT:
+            case Bytecode::IF_ICMPGE:
+            case Bytecode::IF_ICMPGT:
+            case Bytecode::IF_ICMPLE:
+                _pop(frame, integer, pc);
+                _pop(frame, integer, pc);
+                _branch(pc, static_cast<int16_t>(Bytecode::read_u16(code, pc + 1)), targets);
+                break;
+            case Bytecode::IF_ACMPEQ:
+            case Bytecode::IF_ACMPNE:
+                _pop_reference(frame, pc);
+                _pop_reference(frame, pc);
+                _branch(pc, static_cast<int16_t>(Bytecode::read_u16(code, pc + 1)), targets);
+                break;
+            case Bytecode::IFNULL:
+            case Bytecode::IFNONNULL:
+                _pop_reference(frame, pc);
+                _branch(pc, static_cast<int16_t>(Bytecode::read_u16(code, pc + 1)), targets);
+                break;
+            case Bytecode::GOTO:
+                _branch(pc, static_cast<int16_t>(Bytecode::read_u16(code, pc + 1)), targets);
+                return false;
+            case Bytecode::GOTO_W:
+                _branch(pc, Bytecode::read_s32(code, pc + 1), targets);
+                return false;
+            case Bytecode::TABLESWITCH:
+            case Bytecode::LOOKUPSWITCH: {
+                _pop(frame, integer, pc);
+
+                auto operands = (pc + 4) & ~size_t(3);
+                _branch(pc, Bytecode::read_s32(code, operands), targets);
+
+                if (opcode == Bytecode::TABLESWITCH) {
+                    int64_t low = Bytecode::read_s32(code, operands + 4);
+                    int64_t high = Bytecode::read_s32(code, operands + 8);
+                    for (int64_t index = 0; index <= high - low; index++) {
+                        _branch(pc, Bytecode::read_s32(code, operands + 12 + 4 * index), targets);
+                    }
+                } else {
+                    auto pairs = Bytecode::read_s32(code, operands + 4);
+                    for (int32_t index = 0; index < pairs; index++) {
+                        auto pair = operands + 8 + 8 * size_t(index);
+                        if (index > 0 && Bytecode::read_s32(code, pair) <= Bytecode::read_s32(code, pair - 8)) {
+                            _fail(pc, "The lookupswitch keys aren't sorted.");
+                        }
+
+                        _branch(pc, Bytecode::read_s32(code, pair + 4), targets);
+                    }
+                }
+                return false;
+            }
+            case Bytecode::IRETURN:
+                _return_instruction(Type::INTEGER, frame, pc);
+                return false;
+            case Bytecode::LRETURN:
+                _return_instruction(Type::LONG, frame, pc);
+                return false;
+            case Bytecode::FRETURN:
+                _return_instruction(Type::FLOAT, frame, pc);
+                return false;
+            case Bytecode::DRETURN:
+                _return_instruction(Type::DOUBLE, frame, pc);
+                return false;
+            case Bytecode::ARETURN:
+                _return_instruction(Type::OBJECT, frame, pc);
+                return false;
+            case Bytecode::RETURN:
+                _return_instruction(Type::TOP, frame, pc);
+                return false;
+            case Bytecode::GETSTATIC:
+            case Bytecode::PUTSTATIC:
+            case Bytecode::GETFIELD:
+            case Bytecode::PUTFIELD:
+                _field_instruction(opcode, Bytecode::read_u16(code, pc + 1), frame, pc);
+                break;
+            case Bytecode::INVOKEVIRTUAL:
+            case Bytecode::INVOKESPECIAL:
+            case Bytecode::INVOKESTATIC:
+            case Bytecode::INVOKEINTERFACE:
+            case Bytecode::INVOKEDYNAMIC:
+                _invoke_instruction(opcode, Bytecode::read_u16(code, pc + 1), frame, pc);
+                break;
+            case Bytecode::NEW: {
+                auto type = _class_type(Bytecode::read_u16(code, pc + 1), pc);
+                if (_is_array(type)) _fail(pc, "The new instruction can't create arrays.", Bytecode::read_u16(code, pc + 1));
+
+                Type uninitialized{Type::UNINITIALIZED, static_cast<uint32_t>(pc)};
+                if (std::find(frame.stack.begin(), frame.stack.end(), uninitialized) != frame.stack.end()) {
+                    _fail(pc, "The object of this new instruction is still uninitialized on the stack.");
+                }
+
+                _replace_uninitialized(frame, uninitialized, {Type::TOP});
+                _push(frame, uninitialized, pc);
+                break;
+            }
+            case Bytecode::NEWARRAY: {
+                constexpr std::string_view arrays[] = {"[Z", "[C", "[F", "[D", "[B", "[S", "[I", "[J"};
+
+                auto array_type = code[pc + 1];
+                if (array_type < 4 || array_type > 11) _fail(pc, "The newarray type is invalid.");
+
+                _pop(frame, integer, pc);
+                _push(frame, {Type::OBJECT, _names.intern(arrays[array_type - 4])}, pc);
+                break;
+            }
+            case Bytecode::ANEWARRAY: {
+                auto index = Bytecode::read_u16(code, pc + 1);
+                auto component = _names.name(_class_type(index, pc).data);
+                if (component.size() > 254 && component[254] == '[') _fail(pc, "The array has too many dimensions.", index);
+
+                _pop(frame, integer, pc);
+                _push(frame, {Type::OBJECT, _names.intern("[" + _wrap(component))}, pc);
+                break;
+            }
+            case Bytecode::ARRAYLENGTH: {
+                auto array = _pop(frame, pc);
+                if (array.tag != Type::NULL_TYPE && !_is_array(array)) _fail(pc, "The operand stack doesn't hold an array.");
+
+                _push(frame, integer, pc);
+                break;
+            }
+            case Bytecode::ATHROW:
+                _pop(frame, {Type::OBJECT, _names.intern("java/lang/Throwable")}, pc);
+                return false;
+            case Bytecode::CHECKCAST:
+                _pop_reference(frame, pc);
+                _push(frame, _class_type(Bytecode::read_u16(code, pc + 1), pc), pc);
+                break;
+            case Bytecode::INSTANCEOF:
+                _pop_reference(frame, pc);
+                (void) _class_type(Bytecode::read_u16(code, pc + 1), pc);
+                _push(frame, integer, pc);
+                break;
+            case Bytecode::MONITORENTER:
+            case Bytecode::MONITOREXIT:
+                _pop_reference(frame, pc);
+                break;
+            case Bytecode::WIDE: {
+                auto wide_opcode = code[pc + 1];
+                auto index = Bytecode::read_u16(code, pc + 2);
+
+                switch (wide_opcode) {
+                    case Bytecode::ILOAD:
+                        _load(frame, index, Type::INTEGER, pc);
+                        break;
+                    case Bytecode::LLOAD:
+                        _load(frame, index, Type::LONG, pc);
+                        break;
+                    case Bytecode::FLOAD:
+                        _load(frame, index, Type::FLOAT, pc);
+                        break;
+                    case Bytecode::DLOAD:
+                        _load(frame, index, Type::DOUBLE, pc);
+                        break;
+                    case Bytecode::ALOAD:
+                        _load(frame, index, Type::OBJECT, pc);
+                        break;
+                    case Bytecode::ISTORE:
+                        _store(frame, index, Type::INTEGER, pc);
+                        break;
+                    case Bytecode::LSTORE:
+                        _store(frame, index, Type::LONG, pc);
+                        break;
+                    case Bytecode::FSTORE:
+                        _store(frame, index, Type::FLOAT, pc);
+                        break;
+                    case Bytecode::DSTORE:
+                        _store(frame, index, Type::DOUBLE, pc);
+                        break;
+                    case Bytecode::ASTORE:
+                        _store(frame, index, Type::OBJECT, pc);
+                        break;
+                    case Bytecode::IINC:
+                        if (index >= frame.locals.size() || frame.locals[index].tag != Type::INTEGER) {
+                            _fail(pc, "The local variable isn't an int.");
+                        }
+                        break;
+                    default:
+                        _fail(pc, "The instruction can't be widened.");
+                }
+                break;
+            }
+            case Bytecode::MULTIANEWARRAY: {
+                auto index = Bytecode::read_u16(code, pc + 1);
+                auto type = _class_type(index, pc);
+                auto dimensions = code[pc + 3];
+
+                auto name = _names.name(type.data);
+                if (dimensions == 0 || name.find_first_not_of('[') < dimensions) {
+                    _fail(pc, "The multianewarray dimensions don't match the array type.", index);
+                }
+
+                for (auto dimension = 0; dimension < dimensions; dimension++) {
+                    _pop(frame, integer, pc);
+                }
+
+                _push(frame, type, pc);
+                break;
+            }
+            default:
+                _fail(pc, "The instruction is not supported.");
+        }
+
+        return true;
+    }
+
+private:
+    const ClassFile &_class_file;
+    const MethodInfo &_method_info;
+    const CodeAttribute &_code;
+    const DescriptorCache &_descriptors;
+
+    Names _names{};
+    uint32_t _this_class{};
+    std::string_view _name{};
+    std::string_view _descriptor{};
+
+    std::vector<bool> _starts{};
+    std::vector<int32_t> _frame_indices{};
+    std::vector<Frame> _frames{};
+};
+
+auto verify_method(const ClassFile &class_file, const MethodInfo &method_info, const DescriptorCache &descriptors)
+-> std::optional<Diagnostic> {
+    auto diagnostic = [&](size_t pc, uint16_t constant_pool_index, const std::string &message) {
+        Diagnostic result;
+        result.class_name = class_file.class_name(class_file.this_class);
+        result.member.append(class_file.utf8(method_info.name_index));
+        result.member.append(class_file.utf8(method_info.descriptor_index));
+        result.constant_pool_index = constant_pool_index;
+        result.message = "pc " + std::to_string(pc) + ": " + message;
+        return result;
+    };
+
+    const auto *attribute_info = CodeAttribute::find(class_file, method_info);
+    auto has_body = !method_info.has_access_flag(MethodInfo::ABSTRACT) && !method_info.has_access_flag(MethodInfo::NATIVE);
+
+    if (!attribute_info) {
+        if (has_body) return diagnostic(0, 0, "The method has no Code attribute.");
+        return std::nullopt;
+    }
+
+    if (!has_body) return diagnostic(0, 0, "Abstract and native methods can't have a Code attribute.");
+
+    auto code = CodeAttribute::read(*attribute_info);
+    if (!code) return diagnostic(0, 0, "The Code attribute is malformed.");
+
+    // Members with broken names or descriptors are reported by the VMCheck already.
+    if (!descriptors.method(class_file, method_info.descriptor_index)) return std::nullopt;
+
+    try {
+        MethodVerifier(class_file, method_info, *code, descriptors).verify();
+    } catch (const VerifyError &error) {
+        return diagnostic(error.pc, error.constant_pool_index, error.message);
+    } catch (const Unsupported &) {
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+auto BytecodeVerifier::verify(ClassFile &class_file, unsigned int thread_count) -> std::vector<Diagnostic> {
+    DescriptorCache descriptors;
+    descriptors.prepare(class_file);
+
+    std::vector<std::optional<Diagnostic>> results(class_file.methods.size());
+    parallel_for(class_file.methods.size(), [&](size_t index) {
+        results[index] = verify_method(class_file, class_file.methods[index], descriptors);
+    }, thread_count);
+
+    std::vector<Diagnostic> report;
+    for (auto &result: results) {
+        if (result) report.push_back(std::move(*result));
+    }
+
+    std::sort(report.begin(), report.end());
+    return report;
+}
+
+auto BytecodeVerifier::verify(JARFile &jar_file, unsigned int thread_count) -> std::vector<Diagnostic> {
+    std::vector<std::pair<const std::string, ClassFile> *> class_files;
+    class_files.reserve(jar_file.classes.size());
+    for (auto &class_file: jar_file.classes) {
+        class_files.push_back(&class_file);
+    }
+
+    std::vector<DescriptorCache> descriptors(class_files.size());
+    parallel_for(class_files.size(), [&](size_t index) {
+        descriptors[index].prepare(class_files[index]->second);
+    }, thread_count);
+
+    // The methods of all classes are verified as one flat list, so that a few large classes don't serialize the work.
+    std::vector<std::pair<size_t, size_t>> methods;
+    for (size_t index = 0; index < class_files.size(); index++) {
+        for (size_t method = 0; method < class_files[index]->second.methods.size(); method++) {
+            methods.emplace_back(index, method);
+        }
+    }
+
+    std::vector<std::optional<Diagnostic>> results(methods.size());
+    parallel_for(methods.size(), [&](size_t index) {
+        auto [class_index, method_index] = methods[index];
+        const auto &class_file = class_files[class_index]->second;
+
+        results[index] = verify_method(class_file, class_file.methods[method_index], descriptors[class_index]);
+        if (results[index]) results[index]->entry = class_files[class_index]->first;
+    }, thread_count);
+
+    std::vector<Diagnostic> report;
+    for (auto &result: results) {
+        if (result) report.push_back(std::move(*result));
+    }
+
+    std::sort(report.begin(), report.end());
+    return report;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "call_graph.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <optional>
+#include <tuple>
+
+#include "bootstrap_methods.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "visited_set.h"
+#include "field_info.h"
+#include "parallel.h"
+#include "bytecode.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+// The edges of one class, written into the adjacency arrays after all classes are scanned.
+struct ClassEdges {
+    std::vector<std::pair<uint32_t, uint32_t>> calls{};
+    std::vector<std::pair<uint32_t, CallGraph::DynamicSite>> sites{};
+};
+
+// Numbers the distinct name and descriptor pairs that the classes declare. Calls of any other pair can't have a
+// target in the class path.
+class Signatures {
+public:
+    explicit Signatures(const std::vector<CallGraph::Method> &methods) {
+        _ids.reserve(methods.size());
+        for (const auto &method: methods) {
+            _ids.try_emplace({method.name, method.descriptor}, static_cast<uint32_t>(_ids.size()));
+        }
+    }
+
+    [[nodiscard]] auto find(std::string_view name, std::string_view descriptor) const -> uint32_t {
+        auto found = _ids.find({name, descriptor});
+        return found == _ids.end() ? CallGraph::NONE : found->second;
+    }
+
+private:
+    struct Key {
+        std::string_view name{};
+        std::string_view descriptor{};
+
+        auto operator==(const Key &other) const -> bool = default;
+    };
+
+    struct KeyHash {
+        auto operator()(const Key &key) const -> size_t {
+            return hash64(key.descriptor, hash64(key.name));
+        }
+    };
+
+    std::unordered_map<Key, uint32_t, KeyHash> _ids{};
+};
+
+// Resolves call targets for the classes of one worker, caching the dispatch of virtual calls.
+class Resolver {
+public:
+    Resolver(const ClassHierarchy &hierarchy, const CallGraph &graph, const Signatures &signatures,
+             CallGraph::Precision precision)
+            : _hierarchy(hierarchy), _graph(graph), _signatures(signatures), _precision(precision) {}
+
+    // Resolves a method reference like the JVM does (JVMS 5.4.3.3): the class and its superclasses first, then the
+    // superinterfaces.
+    auto resolve(uint32_t class_id, std::string_view name, std::string_view descriptor) -> uint32_t {
+        std::vector<uint32_t> interfaces;
+
+        auto steps = _hierarchy.size();
+        for (auto current = class_id; current != ClassHierarchy::NONE && steps-- > 0;
+             current = _hierarchy.node(current).super_class) {
+            auto method = _graph.find(current, name, descriptor);
+            if (method != CallGraph::NONE) return method;
+
+            auto direct = _hierarchy.interfaces(current);
+            interfaces.insert(interfaces.end(), direct.begin(), direct.end());
+        }
+
+        return _find_in_interfaces(interfaces, name, descriptor, false);
+    }
+
+    // Selects the method that runs for a receiver of exactly this class (JVMS 5.4.6).
+    auto dispatch(uint32_t class_id, std::string_view name, std::string_view descriptor) -> uint32_t {
+        std::vector<uint32_t> interfaces;
+
+        auto steps = _hierarchy.size();
+        for (auto current = class_id; current != ClassHierarchy::NONE && steps-- > 0;
+             current = _hierarchy.node(current).super_class) {
+            auto method = _graph.find(current, name, descriptor);
+            if (method != CallGraph::NONE) {
+                auto access_flags = _graph.method(method).access_flags;
+                if (!(access_flags & (MethodInfo::STATIC | MethodInfo::ABSTRACT))) return method;
+            }
+
+            auto direct = _hierarchy.interfaces(current);
+            interfaces.insert(interfaces.end(), direct.begin(), direct.end());
+        }
+
+        return _find_in_interfaces(interfaces, name, descriptor, true);
+    }
+
+    auto virtual_targets(uint32_t class_id, std::string_view name, std::string_view descriptor)
+    -> const std::vector<uint32_t> & {
+        static const std::vector<uint32_t> none;
+
+        auto signature = _signatures.find(name, descriptor);
+        if (signature == CallGraph::NONE) return none;
+
+        auto [found, inserted] = _cache.try_emplace(uint64_t(class_id) << 32 | signature);
+        if (!inserted) return found->second;
+
+        auto &targets = found->second;
+        for (auto subtype: _concrete_subtypes(class_id)) {
+            if (_precision == CallGraph::RTA && !_graph.is_instantiated(subtype)) continue;
+
+            auto method = dispatch(subtype, name, descriptor);
+            if (method != CallGraph::NONE) targets.push_back(method);
+        }
+
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        return targets;
+    }
+
+private:
+    // The defined classes which aren't abstract among the subtypes, looked up once per class and not per signature.
+    auto _concrete_subtypes(uint32_t class_id) -> const std::vector<uint32_t> & {
+        auto [found, inserted] = _subtypes.try_emplace(class_id);
+        if (!inserted) return found->second;
+
+        for (auto subtype: _hierarchy.subtypes(class_id)) {
+            const auto &node = _hierarchy.node(subtype);
+            if (node.defined && !(node.access_flags & (ClassFile::INTERFACE | ClassFile::ABSTRACT))) {
+                found->second.push_back(subtype);
+            }
+        }
+        return found->second;
+    }
+
+    auto _find_in_interfaces(std::vector<uint32_t> &pending, std::string_view name, std::string_view descriptor,
+                             bool concrete) -> uint32_t {
+        _visited.clear(_hierarchy.size());
+
+        uint32_t abstract_method = CallGraph::NONE;
+        for (size_t index = 0; index < pending.size(); index++) {
+            auto interface = pending[index];
+            if (!_visited.insert(interface)) continue;
+
+            auto method = _graph.find(interface, name, descriptor);
+            if (method != CallGraph::NONE) {
+                auto access_flags = _graph.method(method).access_flags;
+                if (!(access_flags & (MethodInfo::STATIC | MethodInfo::PRIVATE))) {
+                    if (!(access_flags & MethodInfo::ABSTRACT)) return method;
+                    if (abstract_method == CallGraph::NONE) abstract_method = method;
+                }
+            }
+
+            auto direct = _hierarchy.interfaces(interface);
+            pending.insert(pending.end(), direct.begin(), direct.end());
+        }
+
+        return concrete ? CallGraph::NONE : abstract_method;
+    }
+
+private:
+    const ClassHierarchy &_hierarchy;
+    const CallGraph &_graph;
+    const Signatures &_signatures;
+    CallGraph::Precision _precision;
+    // Keyed by the class id in the upper and the signature id in the lower half.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> _cache{};
+    std::unordered_map<uint32_t, std::vector<uint32_t>> _subtypes{};
+    VisitedSet _visited{};
+};
+
+// Calls the function with every instruction of every method of the class.
+template<typename Function>
+void for_each_instruction(const ClassFile &class_file, Function &&function) {
+    for (size_t method_index = 0; method_index < class_file.methods.size(); method_index++) {
+        const auto *attribute_info = CodeAttribute::find(class_file, class_file.methods[method_index]);
+        if (!attribute_info) continue;
+
+        auto code = CodeAttribute::read(*attribute_info);
+        if (!code) continue;
+
+        for (size_t pc = 0; pc < code->code.size();) {
+            auto length = Bytecode::instruction_length(code->code, pc);
+            if (length == 0) break;
+
+            function(method_index, code->code, pc);
+            pc += length;
+        }
+    }
+}
+
+} // namespace
+
+auto CallGraph::build(const ClassHierarchy &hierarchy, Precision precision, unsigned int thread_count) -> CallGraph {
+    CallGraph graph;
+    auto class_count = hierarchy.size();
+
+    graph._method_offsets.assign(class_count + 1, 0);
+    for (uint32_t id = 0; id < class_count; id++) {
+        const auto *class_file = hierarchy.node(id).class_file;
+        graph._method_offsets[id + 1] = graph._method_offsets[id] + (class_file ? class_file->methods.size() : 0);
+    }
+
+    graph._methods.resize(graph._method_offsets[class_count]);
+    graph._instantiated.assign(class_count, 0);
+
+    // The first pass collects the methods and the instantiated classes. Different classes may write the same flag,
+    // so every class collects its own list first. Constructor references like Foo::new create instances without a
+    // new instruction, through a method handle of the kind REF_newInvokeSpecial.
+    std::vector<std::vector<uint32_t>> instantiated(class_count);
+    parallel_for(class_count, [&](size_t id) {
+        const auto *class_file = hierarchy.node(id).class_file;
+        if (!class_file) return;
+
+        auto *methods = graph._methods.data() + graph._method_offsets[id];
+        for (size_t index = 0; index < class_file->methods.size(); index++) {
+            const auto &method_info = class_file->methods[index];
+            methods[index] = {static_cast<uint32_t>(id), class_file->utf8(method_info.name_index),
+                              class_file->utf8(method_info.descriptor_index), method_info.access_flags};
+        }
+
+        std::sort(methods, methods + class_file->methods.size(), [](const Method &first, const Method &second) {
+            return std::tie(first.name, first.descriptor) < std::tie(second.name, second.descriptor);
+        });
+
+        for_each_instruction(*class_file, [&](size_t, std::span<const uint8_t> code, size_t pc) {
+            if (code[pc] != Bytecode::NEW) return;
+
+            auto name = class_file->class_name(Bytecode::read_u16(code, pc + 1));
+            auto created = name.empty() ? ClassHierarchy::NONE : hierarchy.find(name);
+            if (created != ClassHierarchy::NONE) instantiated[id].push_back(created);
+        });
+
+        for (uint16_t index = 1; index < class_file->constant_pool_count; index++) {
+            const auto &info = class_file->constant_pool[index - 1];
+            if (info.tag != ConstantPoolInfo::METHOD_HANDLE
+                || info.info.method_handle_info.reference_kind != ConstantInfo::NewInvokeSpecial) {
+                continue;
+            }
+
+            auto reference = class_file->member_ref(info.info.method_handle_info.reference_index);
+            auto created = !reference || reference->owner.empty() ? ClassHierarchy::NONE
+                                                                   : hierarchy.find(reference->owner);
+            if (created != ClassHierarchy::NONE) instantiated[id].push_back(created);
+        }
+    }, thread_count);
+
+    for (const auto &created: instantiated) {
+        for (auto id: created) graph._instantiated[id] = 1;
+    }
+
+    // The second pass resolves the calls. Every worker takes a strided chunk of the classes and keeps one cache of
+    // the virtual call targets for all of them, so the subtypes of a class are walked at most once per worker.
+    Signatures signatures(graph._methods);
+    std::vector<ClassEdges> edges(class_count);
+    auto chunks = chunk_count(class_count, thread_count);
+    parallel_for(chunks, [&](size_t chunk) {
+        Resolver resolver(hierarchy, graph, signatures, precision);
+
+        for (auto id = chunk; id < class_count; id += chunks) {
+            const auto *class_file = hierarchy.node(id).class_file;
+            if (!class_file) continue;
+
+            auto &class_edges = edges[id];
+            std::optional<BootstrapMethods> bootstrap_methods;
+            bool bootstrap_methods_read = false;
+
+            // The method ids follow the sorted order, the instructions the order of the class file.
+            auto method_id = [&](size_t method_index) {
+                const auto &method_info = class_file->methods[method_index];
+                return graph.find(static_cast<uint32_t>(id), class_file->utf8(method_info.name_index),
+                                  class_file->utf8(method_info.descriptor_index));
+            };
+
+            // Adds the calls through the method or interface method reference at the index.
+            auto add_call = [&](uint32_t caller, uint8_t opcode, uint16_t index) {
+                auto reference = class_file->member_ref(index);
+                if (!reference || reference->owner.empty()
+                    || class_file->constant_pool[index - 1].tag == ConstantPoolInfo::FIELD_REF) {
+                    return;
+                }
+
+                auto class_id = hierarchy.find(reference->owner);
+                if (class_id == ClassHierarchy::NONE || !hierarchy.node(class_id).defined) return;
+
+                if (opcode == Bytecode::INVOKEVIRTUAL || opcode == Bytecode::INVOKEINTERFACE) {
+                    for (auto target: resolver.virtual_targets(class_id, reference->name, reference->descriptor)) {
+                        class_edges.calls.emplace_back(caller, target);
+                    }
+                    return;
+                }
+
+                auto target = resolver.resolve(class_id, reference->name, reference->descriptor);
+                if (target != CallGraph::NONE) class_edges.calls.emplace_back(caller, target);
+            };
+
+            size_t current_index = SIZE_MAX;
+            uint32_t caller = CallGraph::NONE;
+
+            for_each_instruction(*class_file, [&](size_t method_index, std::span<const uint8_t> code, size_t pc) {
+                if (method_index != current_index) {
+                    current_index = method_index;
+                    caller = method_id(method_index);
+                }
+
+                auto opcode = code[pc];
+                if (opcode < Bytecode::INVOKEVIRTUAL || opcode > Bytecode::INVOKEDYNAMIC || caller == CallGraph::NONE) {
+                    return;
+                }
+
+                auto index = Bytecode::read_u16(code, pc + 1);
+                if (opcode != Bytecode::INVOKEDYNAMIC) {
+                    add_call(caller, opcode, index);
+                    return;
+                }
+
+                if (!class_file->is_valid_index(index)
+                    || class_file->constant_pool[index - 1].tag != ConstantPoolInfo::INVOKE_DYNAMIC) {
+                    return;
+                }
+
+                DynamicSite site;
+                site.pc = static_cast<uint32_t>(pc);
+                site.constant_pool_index = index;
+
+                auto name_and_type_index = class_file->constant_pool[index - 1].info.dynamic_info.name_and_type_index;
+                if (class_file->is_valid_index(name_and_type_index)) {
+                    const auto &name_and_type = class_file->constant_pool[name_and_type_index - 1];
+                    if (name_and_type.tag == ConstantPoolInfo::NAME_AND_TYPE) {
+                        site.name = class_file->utf8(name_and_type.info.name_and_type_info.name_index);
+                        site.descriptor = class_file->utf8(name_and_type.info.name_and_type_info.descriptor_index);
+                    }
+                }
+
+                class_edges.sites.emplace_back(caller, site);
+
+                if (!bootstrap_methods_read) {
+                    bootstrap_methods = BootstrapMethods::read(*class_file);
+                    bootstrap_methods_read = true;
+                }
+                if (!bootstrap_methods) return;
+
+                auto bootstrap_method = bootstrap_methods->of_constant(*class_file, index);
+                if (!bootstrap_method) return;
+
+                for (auto argument: bootstrap_method->arguments) {
+                    if (!class_file->is_valid_index(argument)) continue;
+
+                    const auto &handle = class_file->constant_pool[argument - 1];
+                    if (handle.tag != ConstantPoolInfo::METHOD_HANDLE) continue;
+
+                    auto kind = handle.info.method_handle_info.reference_kind;
+                    if (kind < ConstantInfo::InvokeVirtual) continue;
+
+                    auto handle_opcode = kind == ConstantInfo::InvokeVirtual ? Bytecode::INVOKEVIRTUAL
+                                         : kind == ConstantInfo::InvokeInterface ? Bytecode::INVOKEINTERFACE
+                                         : Bytecode::INVOKESPECIAL;
+                    add_call(caller, handle_opcode, handle.info.method_handle_info.reference_index);
+                }
+            });
+
+            std::sort(class_edges.calls.begin(), class_edges.calls.end());
+            class_edges.calls.erase(std::unique(class_edges.calls.begin(), class_edges.calls.end()),
+                                    class_edges.calls.end());
+            std::stable_sort(class_edges.sites.begin(), class_edges.sites.end(), [](auto &first, auto &second) {
+                return first.first < second.first;
+            });
+        }
+    }, thread_count);
+
+    // The methods of a class are consecutive, so the offsets follow from counts per method and every class fills
+    // its own range of the arrays without synchronization.
+    auto method_count = graph._methods.size();
+    graph._callee_offsets.assign(method_count + 1, 0);
+    graph._site_offsets.assign(method_count + 1, 0);
+
+    for (const auto &class_edges: edges) {
+        for (const auto &call: class_edges.calls) graph._callee_offsets[call.first + 1]++;
+        for (const auto &site: class_edges.sites) graph._site_offsets[site.first + 1]++;
+    }
+
+    for (size_t id = 0; id < method_count; id++) {
+        graph._callee_offsets[id + 1] += graph._callee_offsets[id];
+        graph._site_offsets[id + 1] += graph._site_offsets[id];
+    }
+
+    graph._callees.resize(graph._callee_offsets[method_count]);
+    graph._sites.resize(graph._site_offsets[method_count]);
+
+    parallel_for(class_count, [&](size_t id) {
+        const auto &class_edges = edges[id];
+        if (class_edges.calls.empty() && class_edges.sites.empty()) return;
+
+        auto first_method = graph._method_offsets[id];
+        auto *callees = graph._callees.data() + graph._callee_offsets[first_method];
+        for (const auto &call: class_edges.calls) *callees++ = call.second;
+
+        auto *sites = graph._sites.data() + graph._site_offsets[first_method];
+        for (const auto &site: class_edges.sites) *sites++ = site.second;
+    }, thread_count);
+
+    return graph;
+}
+
+auto CallGraph::method_count() const -> size_t {
+    return _methods.size();
+}
+
+auto CallGraph::edge_count() const -> size_t {
+    return _callees.size();
+}
+
+auto CallGraph::method(uint32_t id) const -> const Method & {
+    return _methods[id];
+}
+
+auto CallGraph::find(uint32_t class_id, std::string_view name, std::string_view descriptor) const -> uint32_t {
+    if (class_id + 1 >= _method_offsets.size()) return CallGraph::NONE;
+
+    auto begin = _methods.begin() + _method_offsets[class_id];
+    auto end = _methods.begin() + _method_offsets[class_id + 1];
+
+    auto found = std::lower_bound(begin, end, std::tie(name, descriptor), [](const Method &method, const auto &key) {
+        return std::tie(method.name, method.descriptor) < key;
+    });
+
+    if (found == end || found->name != name || found->descriptor != descriptor) return CallGraph::NONE;
+    return static_cast<uint32_t>(found - _methods.begin());
+}
+
+auto CallGraph::callees(uint32_t id) const -> std::span<const uint32_t> {
+    return {_callees.data() + _callee_offsets[id], _callee_offsets[id + 1] - _callee_offsets[id]};
+}
+
+auto CallGraph::dynamic_sites(uint32_t id) const -> std::span<const DynamicSite> {
+    return {_sites.data() + _site_offsets[id], _site_offsets[id + 1] - _site_offsets[id]};
+}
+
+auto CallGraph::is_instantiated(uint32_t class_id) const -> bool {
+    return _instantiated[class_id] != 0;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
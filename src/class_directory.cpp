@@ -0,0 +1,404 @@
+#include "class_directory.h"
+
+#include <initializer_list>
+#include <filesystem>
+#include <stdexcept>
+#include <cstring>
+#include <atomic>
+
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define ARES_HAS_IO_URING
+#endif
+
+#include <boost/algorithm/string.hpp>
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "parallel.h"
+
+using namespace ares;
+
+#ifdef ARES_HAS_IO_URING
+
+namespace {
+
+// A small io_uring wrapper on top of the raw system calls, so liburing is not needed to build the library.
+class IoUring {
+public:
+    static constexpr uint64_t IGNORED = UINT64_MAX;
+
+public:
+    IoUring() = default;
+
+    IoUring(const IoUring &) = delete;
+
+    auto operator=(const IoUring &) -> IoUring & = delete;
+
+    ~IoUring() {
+        if (_sqes) munmap(_sqes, _sqes_size);
+        if (_cq_ring && _cq_ring != _sq_ring) munmap(_cq_ring, _cq_ring_size);
+        if (_sq_ring) munmap(_sq_ring, _sq_ring_size);
+        if (_fd >= 0) close(_fd);
+    }
+
+    auto init(unsigned int entries) -> bool {
+        io_uring_params params{};
+        _fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (_fd < 0) return false;
+
+        _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+        }
+
+        _sq_ring = _map(_sq_ring_size, IORING_OFF_SQ_RING);
+        if (!_sq_ring) return false;
+
+        _cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP) ? _sq_ring : _map(_cq_ring_size, IORING_OFF_CQ_RING);
+        if (!_cq_ring) return false;
+
+        _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        _sqes = static_cast<io_uring_sqe *>(_map(_sqes_size, IORING_OFF_SQES));
+        if (!_sqes) return false;
+
+        auto *sq_ring = static_cast<uint8_t *>(_sq_ring);
+        _sq_tail = reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.tail);
+        _sq_mask = *reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.array);
+        _sq_entries = params.sq_entries;
+        _local_tail = *_sq_tail;
+
+        auto *cq_ring = static_cast<uint8_t *>(_cq_ring);
+        _cq_head = reinterpret_cast<unsigned int *>(cq_ring + params.cq_off.head);
+        _cq_tail = reinterpret_cast<unsigned int *>(cq_ring + params.cq_off.tail);
+        _cq_mask = *reinterpret_cast<unsigned int *>(cq_ring + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe *>(cq_ring + params.cq_off.cqes);
+
+        return true;
+    }
+
+    [[nodiscard]] auto supports(std::initializer_list<uint8_t> opcodes) const -> bool {
+        std::vector<uint8_t> buffer(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+        auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+        if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PROBE, probe, 256) < 0) return false;
+
+        for (auto opcode: opcodes) {
+            if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) return false;
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] auto capacity() const -> unsigned int {
+        return _sq_entries;
+    }
+
+    void prepare_openat(const std::string &path, uint64_t user_data) {
+        auto *sqe = _next_sqe(IORING_OP_OPENAT, user_data);
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(path.c_str());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+
+    void prepare_statx(const std::string &path, struct statx *buffer, uint64_t user_data) {
+        auto *sqe = _next_sqe(IORING_OP_STATX, user_data);
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(path.c_str());
+        sqe->len = STATX_SIZE;
+        sqe->addr2 = reinterpret_cast<uint64_t>(buffer);
+    }
+
+    void prepare_read(int file_descriptor, uint8_t *buffer, unsigned int length, uint64_t user_data) {
+        auto *sqe = _next_sqe(IORING_OP_READ, user_data);
+        sqe->fd = file_descriptor;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = length;
+        sqe->off = 0;
+    }
+
+    void prepare_close(int file_descriptor) {
+        auto *sqe = _next_sqe(IORING_OP_CLOSE, IGNORED);
+        sqe->fd = file_descriptor;
+    }
+
+    // Submits every prepared entry with a single system call and waits until all of them completed.
+    template<typename Callback>
+    auto submit_and_wait(Callback &&on_complete) -> bool {
+        auto expected = _to_submit;
+        std::atomic_ref<unsigned int>(*_sq_tail).store(_local_tail, std::memory_order_release);
+
+        unsigned int completed = 0;
+        while (completed < expected) {
+            auto submitted = syscall(__NR_io_uring_enter, _fd, _to_submit, expected - completed,
+                                     IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+
+            _to_submit -= static_cast<unsigned int>(submitted);
+
+            auto head = *_cq_head;
+            auto tail = std::atomic_ref<unsigned int>(*_cq_tail).load(std::memory_order_acquire);
+            for (; head != tail; head++, completed++) {
+                const auto &cqe = _cqes[head & _cq_mask];
+                if (cqe.user_data != IGNORED) on_complete(cqe.user_data, cqe.res);
+            }
+            std::atomic_ref<unsigned int>(*_cq_head).store(head, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+private:
+    auto _map(size_t size, off_t offset) const -> void * {
+        auto *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, offset);
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+    auto _next_sqe(uint8_t opcode, uint64_t user_data) -> io_uring_sqe * {
+        auto index = _local_tail & _sq_mask;
+        auto *sqe = &_sqes[index];
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode = opcode;
+        sqe->user_data = user_data;
+
+        _sq_array[index] = index;
+        _local_tail++;
+        _to_submit++;
+
+        return sqe;
+    }
+
+private:
+    int _fd{-1};
+    void *_sq_ring{}, *_cq_ring{};
+    size_t _sq_ring_size{}, _cq_ring_size{}, _sqes_size{};
+    io_uring_sqe *_sqes{};
+    unsigned int *_sq_tail{}, *_sq_array{}, _sq_mask{}, _sq_entries{};
+    unsigned int *_cq_head{}, *_cq_tail{}, _cq_mask{};
+    io_uring_cqe *_cqes{};
+    unsigned int _local_tail{}, _to_submit{};
+};
+
+} // namespace
+
+#endif
+
+auto ClassDirectory::read_directory(const std::string &path, unsigned int batch_size) -> JARFile {
+    if (!std::filesystem::is_directory(path)) {
+        throw std::invalid_argument("Warning: You can only enter directories.");
+    }
+
+    if (batch_size == 0) {
+        throw std::invalid_argument("Warning: The batch size needs to be greater than zero.");
+    }
+
+    std::vector<Entry> entries;
+    for (const auto &directory_entry: std::filesystem::recursive_directory_iterator(path)) {
+        if (!directory_entry.is_regular_file()) continue;
+
+        Entry entry;
+        entry.path = directory_entry.path().string();
+        entry.name = directory_entry.path().lexically_relative(path).generic_string();
+        entries.push_back(std::move(entry));
+    }
+
+    if (!_read_with_io_uring(entries, batch_size)) {
+        _read_with_threads(entries);
+    }
+
+    // Classes are parsed concurrently, everything else takes the same path as the entries of a JAR file.
+    std::vector<size_t> class_indices;
+    for (size_t index = 0; index < entries.size(); index++) {
+        if (boost::algorithm::iends_with(entries[index].name, ".class")) {
+            class_indices.push_back(index);
+        }
+    }
+
+    std::vector<ClassFile> class_files(class_indices.size());
+    parallel_for(class_indices.size(), [&](size_t index) {
+        class_files[index] = JARFile::read_class(std::move(entries[class_indices[index]].data));
+    });
+
+    JARFile jar_file;
+    for (size_t index = 0; index < class_indices.size(); index++) {
+        jar_file.classes.emplace(entries[class_indices[index]].name, std::move(class_files[index]));
+    }
+
+    for (auto &entry: entries) {
+        if (boost::algorithm::iends_with(entry.name, ".class")) continue;
+        jar_file.add_entry(entry.name, std::move(entry.data));
+    }
+
+    return jar_file;
+}
+
+#ifdef ARES_HAS_IO_URING
+
+auto ClassDirectory::_read_with_io_uring(std::vector<Entry> &entries, unsigned int batch_size) -> bool {
+    // The kernel refuses rings with more than 32768 entries.
+    IoUring ring;
+    if (!ring.init(std::min(batch_size, 32768u / 3) * 3)
+        || !ring.supports({IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE})) {
+        return false;
+    }
+
+    // The ring may be smaller than requested, every batch needs room for its close, open and stat requests.
+    batch_size = std::min(batch_size, ring.capacity() / 3);
+    if (batch_size == 0) return false;
+
+    std::vector<int> descriptors(entries.size(), -1);
+    std::vector<struct statx> stats(batch_size);
+    std::string error;
+
+    auto close_batch = [&](size_t begin, size_t end) {
+        for (auto index = begin; index < end; index++) {
+            if (descriptors[index] >= 0) ring.prepare_close(descriptors[index]);
+        }
+    };
+
+    size_t previous_begin = 0;
+    for (size_t begin = 0; begin < entries.size(); begin += batch_size) {
+        auto end = std::min(entries.size(), begin + batch_size);
+
+        // The files of the previous batch get closed with the same submission that opens the next batch.
+        close_batch(previous_begin, begin);
+        previous_begin = begin;
+
+        for (auto index = begin; index < end; index++) {
+            ring.prepare_openat(entries[index].path, index);
+            ring.prepare_statx(entries[index].path, &stats[index - begin], entries.size() + index);
+        }
+
+        auto submitted = ring.submit_and_wait([&](uint64_t user_data, int32_t result) {
+            auto is_stat = user_data >= entries.size();
+            auto index = is_stat ? user_data - entries.size() : user_data;
+
+            if (result < 0) {
+                if (error.empty()) {
+                    error = "Warning: Couldn't open the file: " + entries[index].path + " (" + strerror(-result) + ")";
+                }
+            } else if (is_stat) {
+                entries[index].data = std::vector<uint8_t>(stats[index - begin].stx_size);
+            } else {
+                descriptors[index] = result;
+            }
+        });
+        if (!submitted) throw std::runtime_error("Warning: Couldn't submit the io_uring requests.");
+        if (!error.empty()) break;
+
+        for (auto index = begin; index < end; index++) {
+            auto &data = entries[index].data;
+            if (data.empty()) continue;
+
+            auto length = static_cast<unsigned int>(std::min<size_t>(data.size(), 1u << 30));
+            ring.prepare_read(descriptors[index], data.data(), length, index);
+        }
+
+        submitted = ring.submit_and_wait([&](uint64_t index, int32_t result) {
+            // Short reads are completed synchronously, which only happens for huge or concurrently modified files.
+            if (result < 0 || !_read_remaining(descriptors[index], entries[index], static_cast<size_t>(result))) {
+                if (error.empty()) error = "Warning: Couldn't read the file: " + entries[index].path;
+            }
+        });
+        if (!submitted) throw std::runtime_error("Warning: Couldn't submit the io_uring requests.");
+        if (!error.empty()) break;
+    }
+
+    close_batch(previous_begin, entries.size());
+    ring.submit_and_wait([](uint64_t, int32_t) {});
+
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+
+    return true;
+}
+
+#else
+
+auto ClassDirectory::_read_with_io_uring(std::vector<Entry> &, unsigned int) -> bool {
+    return false;
+}
+
+#endif
+
+void ClassDirectory::_read_with_threads(std::vector<Entry> &entries) {
+    parallel_for(entries.size(), [&](size_t index) {
+        auto &entry = entries[index];
+
+        auto file_descriptor = open(entry.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file_descriptor < 0) {
+            throw std::runtime_error("Warning: Couldn't open the file: " + entry.path);
+        }
+
+        struct stat stat{};
+        auto success = fstat(file_descriptor, &stat) == 0;
+        if (success) {
+            entry.data = std::vector<uint8_t>(static_cast<size_t>(stat.st_size));
+            success = _read_remaining(file_descriptor, entry, 0);
+        }
+
+        close(file_descriptor);
+
+        if (!success) {
+            throw std::runtime_error("Warning: Couldn't read the file: " + entry.path);
+        }
+    });
+}
+
+auto ClassDirectory::_read_remaining(int file_descriptor, Entry &entry, size_t offset) -> bool {
+    while (offset < entry.data.size()) {
+        auto read = pread(file_descriptor, entry.data.data() + offset, entry.data.size() - offset,
+                          static_cast<off_t>(offset));
+        if (read < 0 && errno == EINTR) continue;
+        if (read <= 0) return false;
+
+        offset += static_cast<size_t>(read);
+    }
+
+    return true;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
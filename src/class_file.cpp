@@ -28,6 +28,66 @@ auto ClassFile::size() const -> unsigned int {
     return size;
 }
 
+auto ClassFile::utf8(unsigned int index) const -> std::string_view {
+    if (!is_valid_index(index)) return {};
+
+    const auto &info = constant_pool[index - 1];
+    if (info.tag != ConstantPoolInfo::UTF_8) return {};
+
+    return {reinterpret_cast<const char *>(info.info.utf8_info.bytes), info.info.utf8_info.length};
+}
+
+auto ClassFile::class_name(unsigned int index) const -> std::string_view {
+    if (!is_valid_index(index)) return {};
+
+    const auto &info = constant_pool[index - 1];
+    if (info.tag != ConstantPoolInfo::CLASS) return {};
+
+    return utf8(info.info.class_info.name_index);
+}
+
+auto ClassFile::member_ref(unsigned int index) const -> std::optional<MemberRef> {
+    if (!is_valid_index(index)) return std::nullopt;
+
+    const auto &info = constant_pool[index - 1];
+    auto dynamic = false;
+    uint16_t class_index = 0;
+    uint16_t name_and_type_index;
+    switch (info.tag) {
+        case ConstantPoolInfo::FIELD_REF:
+        case ConstantPoolInfo::METHOD_REF:
+        case ConstantPoolInfo::INTERFACE_METHOD_REF:
+            class_index = info.info.field_method_info.class_index;
+            name_and_type_index = info.info.field_method_info.name_and_type_index;
+            break;
+        case ConstantPoolInfo::DYNAMIC:
+        case ConstantPoolInfo::INVOKE_DYNAMIC:
+            dynamic = true;
+            name_and_type_index = info.info.dynamic_info.name_and_type_index;
+            break;
+        default:
+            return std::nullopt;
+    }
+
+    if (!is_valid_index(name_and_type_index)
+        || constant_pool[name_and_type_index - 1].tag != ConstantPoolInfo::NAME_AND_TYPE) {
+        return std::nullopt;
+    }
+
+    const auto &name_and_type = constant_pool[name_and_type_index - 1].info.name_and_type_info;
+
+    MemberRef result;
+    result.owner = class_name(class_index);
+    result.name = utf8(name_and_type.name_index);
+    result.descriptor = utf8(name_and_type.descriptor_index);
+    result.descriptor_index = name_and_type.descriptor_index;
+
+    if ((!dynamic && result.owner.empty()) || result.name.empty() || result.descriptor.empty()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
 //==============================================================================
 // BSD 3-Clause License
 //
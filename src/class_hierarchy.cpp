@@ -0,0 +1,466 @@
+#include "class_hierarchy.h"
+
+#include <unordered_set>
+#include <algorithm>
+#include <mutex>
+
+#include "parallel.h"
+
+using namespace ares;
+
+namespace {
+
+struct Definition {
+    std::string source{};
+    ClassFile *class_file{};
+
+    uint16_t access_flags{};
+    std::string_view name{};
+    std::string_view super_name{};
+    std::vector<std::string_view> interfaces{};
+};
+
+} // namespace
+
+auto ClassHierarchy::build(const std::vector<std::pair<std::string, JARFile *>> &class_path,
+                           unsigned int thread_count) -> ClassHierarchy {
+    // Nested JARs are opened lazily, so the entries are gathered on one thread first.
+    std::vector<Definition> definitions;
+    for (const auto &[jar_name, jar_file]: class_path) {
+        jar_file->visit_classes([&](const std::string &entry_name, ClassFile &class_file) {
+            definitions.push_back({jar_name + "!/" + entry_name, &class_file});
+        });
+    }
+
+    parallel_for(definitions.size(), [&](size_t index) {
+        auto &definition = definitions[index];
+        const auto &class_file = *definition.class_file;
+
+        definition.access_flags = class_file.access_flags;
+        definition.name = class_file.class_name(class_file.this_class);
+        definition.super_name = class_file.class_name(class_file.super_class);
+        for (auto interface: class_file.interfaces) {
+            definition.interfaces.push_back(class_file.class_name(interface));
+        }
+    }, thread_count);
+
+    ClassHierarchy hierarchy;
+    hierarchy._nodes.reserve(definitions.size());
+
+    std::vector<uint32_t> ids(definitions.size(), ClassHierarchy::NONE);
+    for (size_t index = 0; index < definitions.size(); index++) {
+        const auto &definition = definitions[index];
+        if (definition.name.empty()) continue;
+
+        auto id = hierarchy._intern(definition.name);
+        auto &node = hierarchy._nodes[id];
+
+        if (node.defined) {
+            hierarchy._duplicates.push_back(hierarchy._diagnostic(
+                    id, "The class is defined again in " + definition.source + ", first in " + node.source + "."));
+            continue;
+        }
+
+        node.defined = true;
+        node.source = definition.source;
+        node.access_flags = definition.access_flags;
+        node.class_file = definition.class_file;
+        ids[index] = id;
+    }
+
+    std::vector<std::vector<uint32_t>> interfaces(hierarchy._nodes.size());
+    for (size_t index = 0; index < definitions.size(); index++) {
+        if (ids[index] == ClassHierarchy::NONE) continue;
+
+        const auto &definition = definitions[index];
+        auto super_class = definition.super_name.empty() ? ClassHierarchy::NONE
+                                                         : hierarchy._intern(definition.super_name);
+
+        auto &implemented = interfaces[ids[index]];
+        implemented.reserve(definition.interfaces.size());
+        for (auto interface: definition.interfaces) {
+            if (!interface.empty()) implemented.push_back(hierarchy._intern(interface));
+        }
+
+        hierarchy._nodes[ids[index]].super_class = super_class;
+    }
+
+    interfaces.resize(hierarchy._nodes.size());
+    hierarchy._build_index(std::move(interfaces));
+
+    return hierarchy;
+}
+
+auto ClassHierarchy::size() const -> size_t {
+    return _nodes.size();
+}
+
+auto ClassHierarchy::node(uint32_t id) const -> const Node & {
+    return _nodes[id];
+}
+
+auto ClassHierarchy::find(std::string_view name) const -> uint32_t {
+    auto found = _ids.find(name);
+    return found == _ids.end() ? ClassHierarchy::NONE : found->second;
+}
+
+auto ClassHierarchy::is_interface(uint32_t id) const -> bool {
+    return _is_interface[id];
+}
+
+auto ClassHierarchy::interfaces(uint32_t id) const -> std::span<const uint32_t> {
+    return {_interfaces.data() + _interface_offsets[id], _interface_offsets[id + 1] - _interface_offsets[id]};
+}
+
+auto ClassHierarchy::direct_subtypes(uint32_t id) const -> std::span<const uint32_t> {
+    return {_subtypes.data() + _subtype_offsets[id], _subtype_offsets[id + 1] - _subtype_offsets[id]};
+}
+
+auto ClassHierarchy::is_subtype(uint32_t id, uint32_t super_id) const -> bool {
+    if (id == super_id) return true;
+
+    if (_is_interface[super_id]) return _implements(id, super_id);
+
+    return _preorder[super_id] <= _preorder[id] && _preorder[id] < _preorder_end[super_id];
+}
+
+auto ClassHierarchy::subtypes(uint32_t id) const -> std::vector<uint32_t> {
+    std::vector<uint32_t> result;
+
+    if (_is_interface[id]) {
+        // Every implementor is reachable over the subtype edges, the ones on inheritance cycles are filtered like
+        // is_subtype does.
+        std::unordered_set<uint32_t> visited{id};
+        std::vector<uint32_t> stack{id};
+        while (!stack.empty()) {
+            auto current = stack.back();
+            stack.pop_back();
+            if (is_subtype(current, id)) result.push_back(current);
+
+            for (auto subtype: direct_subtypes(current)) {
+                if (visited.insert(subtype).second) stack.push_back(subtype);
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    result.assign(_by_preorder.begin() + _preorder[id], _by_preorder.begin() + _preorder_end[id]);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+auto ClassHierarchy::check(unsigned int thread_count) const -> std::vector<Diagnostic> {
+    auto report = _duplicates;
+    std::mutex report_mutex;
+
+    size_t block_size = 1024;
+    parallel_for((_nodes.size() + block_size - 1) / block_size, [&](size_t block) {
+        std::vector<Diagnostic> local;
+
+        auto end = std::min(_nodes.size(), (block + 1) * block_size);
+        for (auto id = block * block_size; id < end; id++) {
+            _check_node(static_cast<uint32_t>(id), local);
+        }
+
+        if (local.empty()) return;
+
+        std::lock_guard<std::mutex> lock(report_mutex);
+        report.insert(report.end(), std::make_move_iterator(local.begin()), std::make_move_iterator(local.end()));
+    }, thread_count);
+
+    _check_cycles(report);
+
+    std::sort(report.begin(), report.end());
+    return report;
+}
+
+auto ClassHierarchy::_intern(std::string_view name) -> uint32_t {
+    auto [found, inserted] = _ids.try_emplace(std::string(name), static_cast<uint32_t>(_nodes.size()));
+    if (inserted) {
+        Node node;
+        node.name = found->first;
+        _nodes.push_back(std::move(node));
+    }
+
+    return found->second;
+}
+
+void ClassHierarchy::_build_index(std::vector<std::vector<uint32_t>> interfaces) {
+    auto count = _nodes.size();
+
+    for (const auto &implemented: interfaces) {
+        _interfaces.insert(_interfaces.end(), implemented.begin(), implemented.end());
+        _interface_offsets.push_back(static_cast<uint32_t>(_interfaces.size()));
+    }
+
+    // The reverse edges, counted first and then filled in place.
+    std::vector<uint32_t> counts(count + 1, 0);
+    for (uint32_t id = 0; id < count; id++) {
+        if (_nodes[id].super_class != ClassHierarchy::NONE) counts[_nodes[id].super_class]++;
+        for (auto interface: interfaces[id]) counts[interface]++;
+    }
+
+    _subtype_offsets.assign(count + 1, 0);
+    for (size_t id = 0; id < count; id++) {
+        _subtype_offsets[id + 1] = _subtype_offsets[id] + counts[id];
+    }
+
+    _subtypes.resize(_subtype_offsets[count]);
+    std::vector<uint32_t> next(_subtype_offsets.begin(), _subtype_offsets.end() - 1);
+    for (uint32_t id = 0; id < count; id++) {
+        if (_nodes[id].super_class != ClassHierarchy::NONE) _subtypes[next[_nodes[id].super_class]++] = id;
+        for (auto interface: interfaces[id]) _subtypes[next[interface]++] = id;
+    }
+
+    _is_interface.assign(count, false);
+    for (uint32_t id = 0; id < count; id++) {
+        if (_nodes[id].defined && (_nodes[id].access_flags & ClassFile::INTERFACE)) _is_interface[id] = true;
+
+        for (auto interface: interfaces[id]) {
+            if (!_nodes[interface].defined) _is_interface[interface] = true;
+        }
+    }
+
+    // Preorder numbering of the superclass forest. Classes on a superclass cycle have no root, the first one visited
+    // is used as one.
+    _preorder.assign(count, ClassHierarchy::NONE);
+    _preorder_end.assign(count, 0);
+    _by_preorder.clear();
+    _by_preorder.reserve(count);
+
+    std::vector<std::pair<uint32_t, uint32_t>> path;
+    auto number_tree = [&](uint32_t root) {
+        _preorder[root] = static_cast<uint32_t>(_by_preorder.size());
+        _by_preorder.push_back(root);
+        path.emplace_back(root, _subtype_offsets[root]);
+
+        while (!path.empty()) {
+            auto &[id, edge] = path.back();
+            if (edge == _subtype_offsets[id + 1]) {
+                _preorder_end[id] = static_cast<uint32_t>(_by_preorder.size());
+                path.pop_back();
+                continue;
+            }
+
+            auto subtype = _subtypes[edge++];
+            if (_nodes[subtype].super_class != id || _preorder[subtype] != ClassHierarchy::NONE) continue;
+
+            _preorder[subtype] = static_cast<uint32_t>(_by_preorder.size());
+            _by_preorder.push_back(subtype);
+            path.emplace_back(subtype, _subtype_offsets[subtype]);
+        }
+    };
+
+    for (uint32_t id = 0; id < count; id++) {
+        if (_nodes[id].super_class == ClassHierarchy::NONE) number_tree(id);
+    }
+
+    for (uint32_t id = 0; id < count; id++) {
+        if (_preorder[id] == ClassHierarchy::NONE) number_tree(id);
+    }
+
+    // The interface sets, computed after all supertypes of a class. Classes on a cycle keep their direct interfaces
+    // only.
+    _interface_sets.clear();
+    _interface_set_begin.assign(count, 0);
+    _interface_set_end.assign(count, 0);
+    _interface_parent.assign(count, ClassHierarchy::NONE);
+
+    std::vector<uint32_t> pending(count, 0);
+    std::vector<uint32_t> ready;
+    for (uint32_t id = 0; id < count; id++) {
+        pending[id] = static_cast<uint32_t>(interfaces[id].size()) + (_nodes[id].super_class != ClassHierarchy::NONE);
+        if (pending[id] == 0) ready.push_back(id);
+    }
+
+    std::vector<uint32_t> added;
+    auto add_set = [&](uint32_t id, uint32_t parent) {
+        std::sort(added.begin(), added.end());
+        added.erase(std::unique(added.begin(), added.end()), added.end());
+
+        _interface_parent[id] = parent;
+        _interface_set_begin[id] = static_cast<uint32_t>(_interface_sets.size());
+        for (auto interface: added) {
+            if (parent == ClassHierarchy::NONE || !_implements(parent, interface)) _interface_sets.push_back(interface);
+        }
+        _interface_set_end[id] = static_cast<uint32_t>(_interface_sets.size());
+        added.clear();
+    };
+
+    while (!ready.empty()) {
+        auto id = ready.back();
+        ready.pop_back();
+
+        // The direct interfaces bring their own sets and those of their superclasses.
+        if (_is_interface[id]) added.push_back(id);
+        for (auto interface: interfaces[id]) {
+            for (auto current = interface; current != ClassHierarchy::NONE; current = _interface_parent[current]) {
+                added.insert(added.end(), _interface_sets.begin() + _interface_set_begin[current],
+                             _interface_sets.begin() + _interface_set_end[current]);
+            }
+        }
+        add_set(id, _nodes[id].super_class);
+
+        for (auto subtype: direct_subtypes(id)) {
+            if (--pending[subtype] == 0) ready.push_back(subtype);
+        }
+    }
+
+    for (uint32_t id = 0; id < count; id++) {
+        if (pending[id] == 0) continue;
+
+        for (auto interface: interfaces[id]) {
+            if (_is_interface[interface]) added.push_back(interface);
+        }
+        add_set(id, ClassHierarchy::NONE);
+    }
+}
+
+auto ClassHierarchy::_implements(uint32_t id, uint32_t interface) const -> bool {
+    for (auto current = id; current != ClassHierarchy::NONE; current = _interface_parent[current]) {
+        auto begin = _interface_sets.begin() + _interface_set_begin[current];
+        auto end = _interface_sets.begin() + _interface_set_end[current];
+        if (std::binary_search(begin, end, interface)) return true;
+    }
+    return false;
+}
+
+void ClassHierarchy::_check_node(uint32_t id, std::vector<Diagnostic> &report) const {
+    const auto &node = _nodes[id];
+    if (!node.defined) return;
+
+    if (node.super_class != ClassHierarchy::NONE) {
+        const auto &super_class = _nodes[node.super_class];
+
+        if (super_class.defined && (super_class.access_flags & ClassFile::INTERFACE)) {
+            report.push_back(_diagnostic(id, "The superclass " + std::string(super_class.name) + " is an interface."));
+        } else if (super_class.defined && (super_class.access_flags & ClassFile::FINAL)) {
+            report.push_back(_diagnostic(id, "The superclass " + std::string(super_class.name) + " is final."));
+        }
+    }
+
+    for (auto interface_id: interfaces(id)) {
+        const auto &interface = _nodes[interface_id];
+        if (interface.defined && !(interface.access_flags & ClassFile::INTERFACE)) {
+            report.push_back(_diagnostic(id, "The interface " + std::string(interface.name) + " is a class."));
+        }
+    }
+}
+
+// Tarjan's algorithm over the superclass and interface edges. Every class of a strongly connected component with more
+// than one class is on a cycle, as is a class which extends or implements itself.
+void ClassHierarchy::_check_cycles(std::vector<Diagnostic> &report) const {
+    constexpr uint32_t UNVISITED = ClassHierarchy::NONE;
+
+    std::vector<uint32_t> order(_nodes.size(), UNVISITED);
+    std::vector<uint32_t> low_link(_nodes.size(), 0);
+    std::vector<bool> on_stack(_nodes.size(), false);
+    std::vector<bool> in_cycle(_nodes.size(), false);
+    std::vector<uint32_t> stack;
+    uint32_t counter = 0;
+
+    // The path of the search, with the next edge to follow of each node.
+    std::vector<std::pair<uint32_t, size_t>> path;
+
+    auto edge = [&](uint32_t id, size_t index) -> uint32_t {
+        if (index == 0) return _nodes[id].super_class;
+        return interfaces(id)[index - 1];
+    };
+
+    auto edge_count = [&](uint32_t id) -> size_t {
+        return 1 + interfaces(id).size();
+    };
+
+    auto enter = [&](uint32_t id) {
+        order[id] = low_link[id] = counter++;
+        on_stack[id] = true;
+        stack.push_back(id);
+        path.emplace_back(id, 0);
+    };
+
+    for (uint32_t root = 0; root < _nodes.size(); root++) {
+        if (order[root] != UNVISITED) continue;
+        enter(root);
+
+        while (!path.empty()) {
+            auto [id, next] = path.back();
+            if (next < edge_count(id)) {
+                path.back().second++;
+
+                auto target = edge(id, next);
+                if (target == ClassHierarchy::NONE) continue;
+
+                if (target == id) {
+                    in_cycle[id] = true;
+                } else if (order[target] == UNVISITED) {
+                    enter(target);
+                } else if (on_stack[target]) {
+                    low_link[id] = std::min(low_link[id], order[target]);
+                }
+                continue;
+            }
+
+            path.pop_back();
+            if (!path.empty()) {
+                auto parent = path.back().first;
+                low_link[parent] = std::min(low_link[parent], low_link[id]);
+            }
+
+            if (low_link[id] != order[id]) continue;
+
+            // The node is the root of a component, which consists of everything above it on the stack.
+            auto first = std::find(stack.rbegin(), stack.rend(), id).base() - 1;
+            auto cyclic = stack.end() - first > 1;
+            for (auto member = first; member != stack.end(); member++) {
+                on_stack[*member] = false;
+                if (cyclic) in_cycle[*member] = true;
+            }
+            stack.erase(first, stack.end());
+        }
+    }
+
+    for (uint32_t id = 0; id < _nodes.size(); id++) {
+        if (in_cycle[id]) report.push_back(_diagnostic(id, "The class is its own ancestor."));
+    }
+}
+
+auto ClassHierarchy::_diagnostic(uint32_t id, std::string message) const -> Diagnostic {
+    Diagnostic diagnostic;
+    diagnostic.class_name = _nodes[id].name;
+    diagnostic.message = std::move(message);
+    return diagnostic;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
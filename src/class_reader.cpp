@@ -18,7 +18,7 @@ using namespace ares;
         abort();                                                            \
     }
 
-ClassReader::ClassReader(unsigned int offset) : _offset(offset) {}
+ClassReader::ClassReader(unsigned int offset, bool verify) : _offset(offset), _verify(verify) {}
 
 void ClassReader::visit_class(ClassFile &class_file) {
     read_magic_number(class_file);
@@ -40,7 +40,11 @@ void ClassReader::read_class_attributes(ClassFile &class_file) {
 
     for (auto &attribute_info: class_file.attributes) {
         ClassReader::visit_class_attribute(class_file, attribute_info);
+
+        if (_verify) _vm_check.visit_class_attribute(class_file, attribute_info);
     }
+
+    if (_verify) _vm_check.check_bootstrap_methods(class_file);
 }
 
 void ClassReader::visit_class_attribute(ClassFile &class_file, AttributeInfo &attribute_info) {
@@ -53,6 +57,8 @@ void ClassReader::visit_class_attribute(ClassFile &class_file, AttributeInfo &at
 
 void ClassReader::read_magic_number(ClassFile &class_file) {
     CHECKED_READ(u32, class_file.magic_number, "Couldn't read the magic number.")
+
+    if (_verify) _vm_check.check_magic_number(class_file);
 }
 
 void ClassReader::read_class_version(ClassFile &class_file) {
@@ -63,6 +69,8 @@ void ClassReader::read_class_version(ClassFile &class_file) {
     if (class_file.major_version >= ClassFile::VERSION_1_1 && class_file.major_version <= ClassFile::VERSION_15) {
         class_file.class_version = ClassFile::ClassVersion(class_file.major_version);
     }
+
+    if (_verify) _vm_check.check_class_version(class_file);
 }
 
 void ClassReader::read_constant_pool(ClassFile &class_file) {
@@ -78,6 +86,9 @@ void ClassReader::read_constant_pool(ClassFile &class_file) {
             index++;
         }
     }
+
+    // Entries may reference later ones, so they can only be checked once the whole pool got decoded.
+    if (_verify) _vm_check.check_constant_pool(class_file);
 }
 
 void ClassReader::visit_classpool_info(ClassFile &class_file, ConstantPoolInfo &info) {
@@ -200,14 +211,20 @@ void ClassReader::read_module_package(ClassFile &class_file, ConstantInfo::Modul
 
 void ClassReader::read_access_flags(ClassFile &class_file) {
     CHECKED_READ(u16, class_file.access_flags, "Couldn't read the access flags.")
+
+    if (_verify) _vm_check.check_access_flags(class_file);
 }
 
 void ClassReader::read_this_class(ClassFile &class_file) {
     CHECKED_READ(u16, class_file.this_class, "Couldn't read the \"this class\".")
+
+    if (_verify) _vm_check.check_this_class(class_file);
 }
 
 void ClassReader::read_super_class(ClassFile &class_file) {
     CHECKED_READ(u16, class_file.super_class, "Couldn't read the \"super class\".")
+
+    if (_verify) _vm_check.check_super_class(class_file);
 }
 
 void ClassReader::read_interfaces(ClassFile &class_file) {
@@ -217,6 +234,8 @@ void ClassReader::read_interfaces(ClassFile &class_file) {
 
     for (auto &interface: class_file.interfaces) {
         CHECKED_READ(u16, interface, "Couldn't read the interface.")
+
+        if (_verify) _vm_check.visit_class_interface(class_file, interface);
     }
 }
 
@@ -229,6 +248,8 @@ void ClassReader::read_fields(ClassFile &class_file) {
 
     for (auto &field_info: class_file.fields) {
         ClassReader::visit_class_field(class_file, field_info);
+
+        if (_verify) _vm_check.visit_class_field(class_file, field_info);
     }
 }
 
@@ -246,6 +267,7 @@ void ClassReader::read_field_attributes(ClassFile &class_file, FieldInfo &field_
     field_info.attributes = std::vector<std::shared_ptr<AttributeInfo>>(field_info.attributes_count);
 
     for (auto &attribute_info: field_info.attributes) {
+        attribute_info = std::make_shared<AttributeInfo>();
         ClassReader::visit_field_attribute(class_file, field_info, *attribute_info);
     }
 }
@@ -261,6 +283,8 @@ void ClassReader::read_methods(ClassFile &class_file) {
 
     for (auto &method_info: class_file.methods) {
         ClassReader::visit_class_method(class_file, method_info);
+
+        if (_verify) _vm_check.visit_class_method(class_file, method_info);
     }
 }
 
@@ -13,91 +13,91 @@ void ClassWriter::visit_class(ClassFile &class_file) {
     _size = class_file.size();
     _byte_code = std::vector<uint8_t>(_size);
 
-    write_u32(class_file.magic_number, class_file);
-    write_u16(class_file.minor_version, class_file);
-    write_u16(class_file.major_version, class_file);
+    write_u32(class_file.magic_number);
+    write_u16(class_file.minor_version);
+    write_u16(class_file.major_version);
 
-    write_u16(class_file.constant_pool_count, class_file);
+    write_u16(class_file.constant_pool_count);
     for (auto &constantPoolInfo : class_file.constant_pool)
         ClassWriter::visit_classpool_info(class_file, constantPoolInfo);
 
-    write_u16(class_file.access_flags, class_file);
-    write_u16(class_file.this_class, class_file);
-    write_u16(class_file.super_class, class_file);
+    write_u16(class_file.access_flags);
+    write_u16(class_file.this_class);
+    write_u16(class_file.super_class);
 
-    write_u16(class_file.interfaces_count, class_file);
+    write_u16(class_file.interfaces_count);
     for (auto index = 0; index < class_file.interfaces_count; index++)
-        write_u16(class_file.interfaces[index], class_file);
+        write_u16(class_file.interfaces[index]);
 
-    write_u16(class_file.fields_count, class_file);
+    write_u16(class_file.fields_count);
     for (auto &field_info : class_file.fields)
         ClassWriter::visit_class_field(class_file, field_info);
 
-    write_u16(class_file.method_count, class_file);
+    write_u16(class_file.method_count);
     for (auto &method_info : class_file.methods)
         ClassWriter::visit_class_method(class_file, method_info);
 
-    write_u16(class_file.attributes_count, class_file);
+    write_u16(class_file.attributes_count);
     for (auto &attribute_info : class_file.attributes)
         ClassWriter::visit_class_attribute(class_file, attribute_info);
 }
 
-void ClassWriter::visit_classpool_info(ClassFile &class_file, ConstantPoolInfo &info) {
-    write_u8((uint8_t &) info.tag, class_file);
+void ClassWriter::visit_classpool_info(ClassFile &, ConstantPoolInfo &info) {
+    write_u8((uint8_t &) info.tag);
 
     switch (info.tag) {
         case ConstantPoolInfo::CLASS: {
-            write_u16(info.info.class_info.name_index, class_file);
+            write_u16(info.info.class_info.name_index);
             break;
         }
         case ConstantPoolInfo::METHOD_REF:
         case ConstantPoolInfo::FIELD_REF:
         case ConstantPoolInfo::INTERFACE_METHOD_REF: {
-            write_u16(info.info.field_method_info.class_index, class_file);
-            write_u16(info.info.field_method_info.name_and_type_index, class_file);
+            write_u16(info.info.field_method_info.class_index);
+            write_u16(info.info.field_method_info.name_and_type_index);
             break;
         }
         case ConstantPoolInfo::STRING: {
-            write_u16(info.info.string_info.string_index, class_file);
+            write_u16(info.info.string_info.string_index);
             break;
         }
         case ConstantPoolInfo::FLOAT:
         case ConstantPoolInfo::INTEGER: {
-            write_u32(info.info.integer_float_info.bytes, class_file);
+            write_u32(info.info.integer_float_info.bytes);
             break;
         }
         case ConstantPoolInfo::LONG:
         case ConstantPoolInfo::DOUBLE: {
-            write_u32(info.info.long_double_info.high_bytes, class_file);
-            write_u32(info.info.long_double_info.low_bytes, class_file);
+            write_u32(info.info.long_double_info.high_bytes);
+            write_u32(info.info.long_double_info.low_bytes);
             break;
         }
         case ConstantPoolInfo::NAME_AND_TYPE: {
-            write_u16(info.info.name_and_type_info.name_index, class_file);
-            write_u16(info.info.name_and_type_info.descriptor_index, class_file);
+            write_u16(info.info.name_and_type_info.name_index);
+            write_u16(info.info.name_and_type_info.descriptor_index);
             break;
         }
         case ConstantPoolInfo::UTF_8: {
-            write_u16(info.info.utf8_info.length, class_file);
-            write_u8_array(info.info.utf8_info.bytes, info.info.utf8_info.length, class_file);
+            write_u16(info.info.utf8_info.length);
+            write_u8_array(info.info.utf8_info.bytes, info.info.utf8_info.length);
             break;
         }
         case ConstantPoolInfo::METHOD_HANDLE: {
-            write_u8(info.info.method_handle_info.reference_kind, class_file);
-            write_u16(info.info.method_handle_info.reference_index, class_file);
+            write_u8(info.info.method_handle_info.reference_kind);
+            write_u16(info.info.method_handle_info.reference_index);
             break;
         }
         case ConstantPoolInfo::METHOD_TYPE: {
-            write_u16(info.info.method_type_info.descriptor_index, class_file);
+            write_u16(info.info.method_type_info.descriptor_index);
             break;
         }
         case ConstantPoolInfo::INVOKE_DYNAMIC:
-        case ConstantPoolInfo::DYNAMIC:write_u16(info.info.dynamic_info.boostrap_method_attr_index, class_file);
-            write_u16(info.info.dynamic_info.name_and_type_index, class_file);
+        case ConstantPoolInfo::DYNAMIC:write_u16(info.info.dynamic_info.boostrap_method_attr_index);
+            write_u16(info.info.dynamic_info.name_and_type_index);
             break;
         case ConstantPoolInfo::PACKAGE:
         case ConstantPoolInfo::MODULE: {
-            write_u16(info.info.module_package_info.name_index, class_file);
+            write_u16(info.info.module_package_info.name_index);
             break;
         }
         case ConstantPoolInfo::UNDEFINED: {
@@ -110,31 +110,31 @@ void ClassWriter::visit_class_interface(ClassFile &, uint16_t) {}
 
 void ClassWriter::visit_class_field(ClassFile &class_file,
                                           FieldInfo &field_info) {
-    write_u16(field_info.access_flags, class_file);
-    write_u16(field_info.name_index, class_file);
-    write_u16(field_info.descriptor_index, class_file);
+    write_u16(field_info.access_flags);
+    write_u16(field_info.name_index);
+    write_u16(field_info.descriptor_index);
 
-    write_u16(field_info.attributes_count, class_file);
+    write_u16(field_info.attributes_count);
     for (const auto &attribute_info : field_info.attributes)
         ClassWriter::visit_field_attribute(class_file, field_info, *attribute_info);
 }
 
 void ClassWriter::visit_class_method(ClassFile &class_file, MethodInfo &method_info) {
-    write_u16(method_info.access_flags, class_file);
-    write_u16(method_info.name_index, class_file);
-    write_u16(method_info.descriptor_index, class_file);
+    write_u16(method_info.access_flags);
+    write_u16(method_info.name_index);
+    write_u16(method_info.descriptor_index);
 
-    write_u16(method_info.attributes_count, class_file);
+    write_u16(method_info.attributes_count);
     for (auto &attribute_info : method_info.attributes)
         ClassWriter::visit_method_attribute(class_file, method_info, attribute_info);
 }
 
-void ClassWriter::visit_class_attribute(ClassFile &class_file, AttributeInfo &attribute_info) {
-    write_u16(attribute_info.attribute_name_index, class_file);
-    write_u32(attribute_info.attribute_length, class_file);
+void ClassWriter::visit_class_attribute(ClassFile &, AttributeInfo &attribute_info) {
+    write_u16(attribute_info.attribute_name_index);
+    write_u32(attribute_info.attribute_length);
 
     for (size_t index = 0; index < attribute_info.attribute_length; index++) {
-        write_u8(attribute_info.info[index], class_file);
+        write_u8(attribute_info.info[index]);
     }
 }
 
@@ -150,8 +150,14 @@ auto ClassWriter::byte_code() const -> const std::vector<uint8_t> & {
     return _byte_code;
 }
 
-auto ClassWriter::write_u8(uint8_t &data, ClassFile &class_file) -> bool {
-    if (_offset + 1 > class_file.byte_code.size()) {
+void ClassWriter::update_byte_code(ClassFile &class_file) {
+    ClassWriter class_writer;
+    class_writer.visit_class(class_file);
+    class_file.byte_code = std::move(class_writer._byte_code);
+}
+
+auto ClassWriter::write_u8(uint8_t &data) -> bool {
+    if (_offset + 1 > _byte_code.size()) {
         std::cerr << "Couldn't write u8 because it is out of bounds." << std::endl;
         return false;
     }
@@ -161,8 +167,8 @@ auto ClassWriter::write_u8(uint8_t &data, ClassFile &class_file) -> bool {
     return true;
 }
 
-auto ClassWriter::write_u16(uint16_t &data, ClassFile &class_file) -> bool {
-    if (_offset + 2 > class_file.byte_code.size()) {
+auto ClassWriter::write_u16(uint16_t &data) -> bool {
+    if (_offset + 2 > _byte_code.size()) {
         std::cerr << "Couldn't write u16 because it is out of bounds." << std::endl;
         return false;
     }
@@ -173,8 +179,8 @@ auto ClassWriter::write_u16(uint16_t &data, ClassFile &class_file) -> bool {
     return true;
 }
 
-auto ClassWriter::write_u32(uint32_t &data, ClassFile &class_file) -> bool {
-    if (_offset + 4 > class_file.byte_code.size()) {
+auto ClassWriter::write_u32(uint32_t &data) -> bool {
+    if (_offset + 4 > _byte_code.size()) {
         std::cerr << "Couldn't read u32 because it is out of bounds." << std::endl;
         return false;
     }
@@ -187,14 +193,14 @@ auto ClassWriter::write_u32(uint32_t &data, ClassFile &class_file) -> bool {
     return true;
 }
 
-auto ClassWriter::write_u8_array(uint8_t *data, unsigned int data_size, ClassFile &class_file) -> bool {
-    if ((_offset + data_size) > class_file.byte_code.size()) {
+auto ClassWriter::write_u8_array(uint8_t *data, unsigned int data_size) -> bool {
+    if ((_offset + data_size) > _byte_code.size()) {
         std::cerr << "Couldn't write the u8 array because it is out of bounds." << std::endl;
         return false;
     }
 
     for (size_t index = 0; index < data_size; index++)
-        write_u8(data[index], class_file);
+        write_u8(data[index]);
 
     return true;
 }
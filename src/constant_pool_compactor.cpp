@@ -0,0 +1,441 @@
+#include "constant_pool_compactor.h"
+
+#include <memory>
+#include <vector>
+
+#include "annotation_walker.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "class_writer.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "class_file.h"
+#include "bytecode.h"
+
+using namespace ares;
+
+namespace {
+
+// Walks the data of one attribute and reports the offsets of the indices in it.
+class IndexCursor {
+public:
+    IndexCursor(const ClassFile &class_file, std::span<const uint8_t> data, size_t base,
+                const ConstantPoolCompactor::IndexVisitor &visitor)
+            : _class_file(class_file), _data(data), _base(base), _visitor(visitor) {}
+
+    auto attribute(std::string_view name) -> bool {
+        if (name == "ConstantValue" || name == "Signature" || name == "SourceFile" || name == "NestHost"
+            || name == "ModuleMainClass") {
+            return index() && at_end();
+        }
+
+        if (name == "Exceptions" || name == "NestMembers" || name == "PermittedSubclasses"
+            || name == "ModulePackages") {
+            uint16_t count;
+            if (!u16(count)) return false;
+            for (uint16_t item = 0; item < count; item++) if (!index()) return false;
+            return at_end();
+        }
+
+        if (name == "Synthetic" || name == "Deprecated") return at_end();
+        if (name == "SourceDebugExtension" || name == "LineNumberTable") return true;
+
+        if (name == "InnerClasses") {
+            uint16_t count;
+            if (!u16(count)) return false;
+            for (uint16_t item = 0; item < count; item++) {
+                if (!index() || !index() || !index() || !skip(2)) return false;
+            }
+            return at_end();
+        }
+
+        if (name == "EnclosingMethod") return index() && index() && at_end();
+
+        if (name == "BootstrapMethods") {
+            uint16_t count, argument_count;
+            if (!u16(count)) return false;
+            for (uint16_t item = 0; item < count; item++) {
+                if (!index() || !u16(argument_count)) return false;
+                for (uint16_t argument = 0; argument < argument_count; argument++) if (!index()) return false;
+            }
+            return at_end();
+        }
+
+        if (name == "MethodParameters") {
+            uint8_t count;
+            if (!u8(count)) return false;
+            for (uint8_t item = 0; item < count; item++) if (!index() || !skip(2)) return false;
+            return at_end();
+        }
+
+        if (name == "LocalVariableTable" || name == "LocalVariableTypeTable") {
+            uint16_t count;
+            if (!u16(count)) return false;
+            for (uint16_t item = 0; item < count; item++) {
+                if (!skip(4) || !index() || !index() || !skip(2)) return false;
+            }
+            return at_end();
+        }
+
+        if (AnnotationWalker::handles(name)) {
+            return AnnotationWalker::walk(name, _data, [this](size_t offset, AnnotationWalker::Index) {
+                _visitor(_base + offset, true);
+            });
+        }
+
+        if (name == "StackMapTable") return stack_map_table() && at_end();
+        if (name == "Code") return code() && at_end();
+
+        return false;
+    }
+
+private:
+    auto code() -> bool {
+        uint32_t code_length;
+        if (!skip(4) || !u32(code_length) || code_length > _data.size() - _offset) return false;
+
+        auto code = _data.subspan(_offset, code_length);
+        for (size_t pc = 0; pc < code.size();) {
+            auto length = Bytecode::instruction_length(code, pc);
+            if (length == 0) return false;
+
+            switch (code[pc]) {
+                case Bytecode::LDC:
+                    _visitor(_base + _offset + pc + 1, false);
+                    break;
+                case Bytecode::LDC_W:
+                case Bytecode::LDC2_W:
+                case Bytecode::GETSTATIC:
+                case Bytecode::PUTSTATIC:
+                case Bytecode::GETFIELD:
+                case Bytecode::PUTFIELD:
+                case Bytecode::INVOKEVIRTUAL:
+                case Bytecode::INVOKESPECIAL:
+                case Bytecode::INVOKESTATIC:
+                case Bytecode::INVOKEINTERFACE:
+                case Bytecode::INVOKEDYNAMIC:
+                case Bytecode::NEW:
+                case Bytecode::ANEWARRAY:
+                case Bytecode::CHECKCAST:
+                case Bytecode::INSTANCEOF:
+                case Bytecode::MULTIANEWARRAY:
+                    _visitor(_base + _offset + pc + 1, true);
+                    break;
+                default:
+                    break;
+            }
+
+            pc += length;
+        }
+        _offset += code_length;
+
+        uint16_t exception_count;
+        if (!u16(exception_count)) return false;
+        for (uint16_t item = 0; item < exception_count; item++) if (!skip(6) || !index()) return false;
+
+        return nested_attributes();
+    }
+
+    auto nested_attributes() -> bool {
+        uint16_t count;
+        if (!u16(count)) return false;
+
+        for (uint16_t item = 0; item < count; item++) {
+            uint16_t name_index;
+            uint32_t length;
+            auto name_offset = _offset;
+            if (!u16(name_index) || !u32(length) || length > _data.size() - _offset) return false;
+            _visitor(_base + name_offset, true);
+
+            IndexCursor nested(_class_file, _data.subspan(_offset, length), _base + _offset, _visitor);
+            if (!nested.attribute(_class_file.utf8(name_index))) return false;
+            _offset += length;
+        }
+
+        return true;
+    }
+
+    auto stack_map_table() -> bool {
+        uint16_t count;
+        if (!u16(count)) return false;
+
+        for (uint16_t item = 0; item < count; item++) {
+            uint8_t frame_type;
+            if (!u8(frame_type)) return false;
+
+            if (frame_type < 64) continue;
+            if (frame_type < 128) {
+                if (!verification_types(1)) return false;
+            } else if (frame_type < 247) {
+                return false;
+            } else if (frame_type == 247) {
+                if (!skip(2) || !verification_types(1)) return false;
+            } else if (frame_type < 252) {
+                if (!skip(2)) return false;
+            } else if (frame_type < 255) {
+                if (!skip(2) || !verification_types(frame_type - 251)) return false;
+            } else {
+                uint16_t local_count, stack_count;
+                if (!skip(2) || !u16(local_count) || !verification_types(local_count) || !u16(stack_count)
+                    || !verification_types(stack_count)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    auto verification_types(size_t count) -> bool {
+        for (size_t item = 0; item < count; item++) {
+            uint8_t tag;
+            if (!u8(tag)) return false;
+
+            // Object_variable_info holds a class index, Uninitialized_variable_info an offset.
+            if (tag == 7 && !index()) return false;
+            if (tag == 8 && !skip(2)) return false;
+            if (tag > 8) return false;
+        }
+        return true;
+    }
+
+    auto index() -> bool {
+        if (_offset + 2 > _data.size()) return false;
+        _visitor(_base + _offset, true);
+        _offset += 2;
+        return true;
+    }
+
+    auto u8(uint8_t &value) -> bool {
+        if (_offset + 1 > _data.size()) return false;
+        value = _data[_offset++];
+        return true;
+    }
+
+    auto u16(uint16_t &value) -> bool {
+        if (_offset + 2 > _data.size()) return false;
+        value = Bytecode::read_u16(_data, _offset);
+        _offset += 2;
+        return true;
+    }
+
+    auto u32(uint32_t &value) -> bool {
+        if (_offset + 4 > _data.size()) return false;
+        value = static_cast<uint32_t>(Bytecode::read_s32(_data, _offset));
+        _offset += 4;
+        return true;
+    }
+
+    auto skip(size_t count) -> bool {
+        if (count > _data.size() - _offset) return false;
+        _offset += count;
+        return true;
+    }
+
+    [[nodiscard]] auto at_end() const -> bool {
+        return _offset == _data.size();
+    }
+
+private:
+    const ClassFile &_class_file;
+    std::span<const uint8_t> _data;
+    size_t _base, _offset{};
+    const ConstantPoolCompactor::IndexVisitor &_visitor;
+};
+
+// The indices a constant refers to.
+template<typename Function>
+void for_each_reference(ConstantPoolInfo &info, Function &&function) {
+    switch (info.tag) {
+        case ConstantPoolInfo::CLASS:
+            function(info.info.class_info.name_index);
+            break;
+        case ConstantPoolInfo::FIELD_REF:
+        case ConstantPoolInfo::METHOD_REF:
+        case ConstantPoolInfo::INTERFACE_METHOD_REF:
+            function(info.info.field_method_info.class_index);
+            function(info.info.field_method_info.name_and_type_index);
+            break;
+        case ConstantPoolInfo::STRING:
+            function(info.info.string_info.string_index);
+            break;
+        case ConstantPoolInfo::NAME_AND_TYPE:
+            function(info.info.name_and_type_info.name_index);
+            function(info.info.name_and_type_info.descriptor_index);
+            break;
+        case ConstantPoolInfo::METHOD_HANDLE:
+            function(info.info.method_handle_info.reference_index);
+            break;
+        case ConstantPoolInfo::METHOD_TYPE:
+            function(info.info.method_type_info.descriptor_index);
+            break;
+        case ConstantPoolInfo::DYNAMIC:
+        case ConstantPoolInfo::INVOKE_DYNAMIC:
+            function(info.info.dynamic_info.name_and_type_index);
+            break;
+        case ConstantPoolInfo::MODULE:
+        case ConstantPoolInfo::PACKAGE:
+            function(info.info.module_package_info.name_index);
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+auto ConstantPoolCompactor::visit_indices(const ClassFile &class_file, std::string_view name,
+                                          std::span<const uint8_t> data, const IndexVisitor &visitor) -> bool {
+    IndexCursor cursor(class_file, data, 0, visitor);
+    return cursor.attribute(name);
+}
+
+auto ConstantPoolCompactor::compact(ClassFile &class_file) -> size_t {
+    auto &pool = class_file.constant_pool;
+    std::vector<bool> used(pool.size() + 1, false);
+    std::vector<uint16_t> pending;
+
+    auto mark = [&](uint16_t index) {
+        if (index == 0 || index > pool.size() || used[index]) return;
+        used[index] = true;
+        pending.push_back(index);
+    };
+
+    // Every attribute is decoded twice, once to mark and once to rewrite, so they are collected up front.
+    std::vector<AttributeInfo *> attributes;
+    for (auto &attribute_info: class_file.attributes) attributes.push_back(&attribute_info);
+    for (auto &field_info: class_file.fields) {
+        for (auto &attribute_info: field_info.attributes) {
+            // Copies of the class share the attributes of fields, so rewritten ones are replaced instead.
+            attribute_info = std::make_shared<AttributeInfo>(*attribute_info);
+            attributes.push_back(attribute_info.get());
+        }
+    }
+    for (auto &method_info: class_file.methods) {
+        for (auto &attribute_info: method_info.attributes) attributes.push_back(&attribute_info);
+    }
+
+    for (const auto *attribute_info: attributes) {
+        mark(attribute_info->attribute_name_index);
+
+        std::span<const uint8_t> data(attribute_info->info, attribute_info->attribute_length);
+        auto mark_index = [&](size_t offset, bool wide) {
+            mark(wide ? Bytecode::read_u16(data, offset) : data[offset]);
+        };
+
+        if (!visit_indices(class_file, class_file.utf8(attribute_info->attribute_name_index), data, mark_index)) {
+            return 0;
+        }
+    }
+
+    mark(class_file.this_class);
+    mark(class_file.super_class);
+    for (auto interface: class_file.interfaces) mark(interface);
+    for (const auto &field_info: class_file.fields) {
+        mark(field_info.name_index);
+        mark(field_info.descriptor_index);
+    }
+    for (const auto &method_info: class_file.methods) {
+        mark(method_info.name_index);
+        mark(method_info.descriptor_index);
+    }
+
+    while (!pending.empty()) {
+        auto index = pending.back();
+        pending.pop_back();
+        for_each_reference(pool[index - 1], mark);
+    }
+
+    // The second slot of LONG and DOUBLE constants moves along with them.
+    std::vector<uint16_t> new_indices(pool.size() + 1, 0);
+    std::vector<ConstantPoolInfo> new_pool;
+    new_pool.reserve(pool.size());
+
+    for (size_t index = 1; index <= pool.size(); index++) {
+        if (!used[index] || pool[index - 1].tag == ConstantPoolInfo::UNDEFINED) continue;
+
+        new_indices[index] = static_cast<uint16_t>(new_pool.size() + 1);
+        new_pool.push_back(pool[index - 1]);
+        if (pool[index - 1].tag == ConstantPoolInfo::LONG || pool[index - 1].tag == ConstantPoolInfo::DOUBLE) {
+            new_pool.emplace_back();
+        }
+    }
+
+    if (new_pool.size() == pool.size()) return 0;
+
+    auto remap = [&](uint16_t &index) {
+        if (index != 0 && index <= pool.size()) index = new_indices[index];
+    };
+
+    // The indices only get smaller, so even the operands of ldc still fit.
+    for (auto *attribute_info: attributes) {
+        auto &data = *class_file.owned_data.emplace_back(std::make_shared<std::vector<uint8_t>>(
+                attribute_info->info, attribute_info->info + attribute_info->attribute_length));
+        auto remap_index = [&](size_t offset, bool wide) {
+            uint16_t index = wide ? Bytecode::read_u16(data, offset) : data[offset];
+            remap(index);
+
+            if (wide) {
+                data[offset] = index >> 8;
+                data[offset + 1] = index & 0xFF;
+            } else {
+                data[offset] = static_cast<uint8_t>(index);
+            }
+        };
+
+        visit_indices(class_file, class_file.utf8(attribute_info->attribute_name_index), data, remap_index);
+        attribute_info->info = data.data();
+    }
+
+    for (auto *attribute_info: attributes) remap(attribute_info->attribute_name_index);
+    remap(class_file.this_class);
+    remap(class_file.super_class);
+    for (auto &interface: class_file.interfaces) remap(interface);
+    for (auto &field_info: class_file.fields) {
+        remap(field_info.name_index);
+        remap(field_info.descriptor_index);
+    }
+    for (auto &method_info: class_file.methods) {
+        remap(method_info.name_index);
+        remap(method_info.descriptor_index);
+    }
+    for (auto &info: new_pool) for_each_reference(info, remap);
+
+    auto removed = pool.size() - new_pool.size();
+    pool = std::move(new_pool);
+    class_file.constant_pool_count = static_cast<uint16_t>(pool.size() + 1);
+    ClassWriter::update_byte_code(class_file);
+    return removed;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
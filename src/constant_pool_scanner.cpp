@@ -0,0 +1,113 @@
+#include "constant_pool_scanner.h"
+
+#include <algorithm>
+#include <array>
+
+#include "constant_info.h"
+
+using namespace ares;
+
+namespace {
+
+// The size of each constant pool entry after its tag by tag, UTF-8 entries add their length. Unknown tags are 0.
+constexpr auto ENTRY_SIZES = [] {
+    std::array<uint8_t, 256> sizes{};
+    sizes[ConstantPoolInfo::UTF_8] = 2;
+    sizes[ConstantPoolInfo::INTEGER] = 4;
+    sizes[ConstantPoolInfo::FLOAT] = 4;
+    sizes[ConstantPoolInfo::LONG] = 8;
+    sizes[ConstantPoolInfo::DOUBLE] = 8;
+    sizes[ConstantPoolInfo::CLASS] = 2;
+    sizes[ConstantPoolInfo::STRING] = 2;
+    sizes[ConstantPoolInfo::FIELD_REF] = 4;
+    sizes[ConstantPoolInfo::METHOD_REF] = 4;
+    sizes[ConstantPoolInfo::INTERFACE_METHOD_REF] = 4;
+    sizes[ConstantPoolInfo::NAME_AND_TYPE] = 4;
+    sizes[ConstantPoolInfo::METHOD_HANDLE] = 3;
+    sizes[ConstantPoolInfo::METHOD_TYPE] = 2;
+    sizes[ConstantPoolInfo::DYNAMIC] = 4;
+    sizes[ConstantPoolInfo::INVOKE_DYNAMIC] = 4;
+    sizes[ConstantPoolInfo::MODULE] = 2;
+    sizes[ConstantPoolInfo::PACKAGE] = 2;
+    return sizes;
+}();
+
+} // namespace
+
+auto ConstantPoolScanner::scan(const uint8_t *data, size_t size, size_t offset) -> std::optional<size_t> {
+    _data = data;
+    if (offset + 2 > size) return std::nullopt;
+
+    auto count = read_u16(data + offset);
+    _offsets.assign(std::max<uint16_t>(count, 1), 0);
+    offset += 2;
+
+    for (size_t index = 1; index < count; index++) {
+        if (offset + 1 > size) return std::nullopt;
+
+        auto tag = data[offset];
+        size_t entry_size = ENTRY_SIZES[tag];
+        if (entry_size == 0) return std::nullopt;
+
+        if (tag == ConstantPoolInfo::UTF_8) {
+            if (offset + 3 > size) return std::nullopt;
+            entry_size += read_u16(data + offset + 1);
+        }
+
+        if (offset + 1 + entry_size > size) return std::nullopt;
+
+        _offsets[index] = static_cast<uint32_t>(offset);
+        offset += 1 + entry_size;
+
+        if (tag == ConstantPoolInfo::LONG || tag == ConstantPoolInfo::DOUBLE) index++;
+    }
+
+    return offset;
+}
+
+auto ConstantPoolScanner::utf8(size_t index, std::string_view &value) const -> bool {
+    if (tag(index) != ConstantPoolInfo::UTF_8) return false;
+    value = {reinterpret_cast<const char *>(payload(index) + 2), operand(index, 0)};
+    return true;
+}
+
+auto ConstantPoolScanner::class_name(size_t index, std::string_view &value) const -> bool {
+    if (index == 0) {
+        value = {};
+        return true;
+    }
+
+    return tag(index) == ConstantPoolInfo::CLASS && utf8(operand(index, 0), value);
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
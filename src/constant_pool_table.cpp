@@ -0,0 +1,257 @@
+#include "constant_pool_table.h"
+
+#include <utility>
+#include <array>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ARES_HAS_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "class_file.h"
+#include "field_info.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr uint32_t bit(ConstantPoolInfo::ConstantTag tag) {
+    return uint32_t(1) << tag;
+}
+
+// Tags are read from the class file and may be anything up to 255, but only the first 32 fit into a mask. The vector
+// shift in the AVX2 kernel yields 0 for them as well.
+constexpr bool accepts(uint32_t expected, uint8_t tag) {
+    return tag < 32 && ((expected >> tag) & 1) != 0;
+}
+
+// The tags each operand may point at, by the tag of the referencing entry. Operands without a reference are stored
+// as 0, which points at the UNDEFINED entry, so that the same check passes for them.
+struct ExpectedTags {
+    std::array<uint32_t, 256> first{};
+    std::array<uint32_t, 256> second{};
+
+    constexpr ExpectedTags() {
+        first.fill(bit(ConstantPoolInfo::UNDEFINED));
+        second.fill(bit(ConstantPoolInfo::UNDEFINED));
+
+        first[ConstantPoolInfo::CLASS] = bit(ConstantPoolInfo::UTF_8);
+        first[ConstantPoolInfo::STRING] = bit(ConstantPoolInfo::UTF_8);
+        first[ConstantPoolInfo::METHOD_TYPE] = bit(ConstantPoolInfo::UTF_8);
+        first[ConstantPoolInfo::MODULE] = bit(ConstantPoolInfo::UTF_8);
+        first[ConstantPoolInfo::PACKAGE] = bit(ConstantPoolInfo::UTF_8);
+
+        first[ConstantPoolInfo::NAME_AND_TYPE] = bit(ConstantPoolInfo::UTF_8);
+        second[ConstantPoolInfo::NAME_AND_TYPE] = bit(ConstantPoolInfo::UTF_8);
+
+        for (auto tag: {ConstantPoolInfo::FIELD_REF, ConstantPoolInfo::METHOD_REF,
+                        ConstantPoolInfo::INTERFACE_METHOD_REF}) {
+            first[tag] = bit(ConstantPoolInfo::CLASS);
+            second[tag] = bit(ConstantPoolInfo::NAME_AND_TYPE);
+        }
+    }
+};
+
+constexpr ExpectedTags expected_tags{};
+
+constexpr size_t BLOCK_SIZE = 8;
+
+} // namespace
+
+ConstantPoolTable::ConstantPoolTable(const ClassFile &class_file) : _size(class_file.constant_pool.size() + 1) {
+    // Whole blocks plus the three bytes a 32-bit gather reads past the last tag.
+    auto padded_size = (_size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE + BLOCK_SIZE;
+    _tags.assign(padded_size, ConstantPoolInfo::UNDEFINED);
+    _first.assign(padded_size, 0);
+    _second.assign(padded_size, 0);
+
+    for (size_t index = 1; index < _size; index++) {
+        const auto &info = class_file.constant_pool[index - 1];
+        _tags[index] = info.tag;
+
+        auto [first, second] = _references(info);
+        _first[index] = first;
+        _second[index] = second;
+    }
+}
+
+auto ConstantPoolTable::covers(uint8_t tag) -> bool {
+    return expected_tags.first[tag] != bit(ConstantPoolInfo::UNDEFINED);
+}
+
+auto ConstantPoolTable::validate_entry(const ClassFile &class_file, const ConstantPoolInfo &info) -> uint8_t {
+    auto is_valid = [&](uint16_t reference, uint32_t expected) {
+        if (reference == 0) return (expected & bit(ConstantPoolInfo::UNDEFINED)) != 0;
+        if (reference > class_file.constant_pool.size()) return false;
+        return accepts(expected, class_file.constant_pool[reference - 1].tag);
+    };
+
+    auto [first, second] = _references(info);
+
+    uint8_t violations = 0;
+    if (!is_valid(first, expected_tags.first[info.tag])) violations |= ConstantPoolTable::FIRST;
+    if (!is_valid(second, expected_tags.second[info.tag])) violations |= ConstantPoolTable::SECOND;
+    return violations;
+}
+
+auto ConstantPoolTable::size() const -> size_t {
+    return _size;
+}
+
+auto ConstantPoolTable::tag(uint16_t index) const -> uint8_t {
+    return _tags[index];
+}
+
+auto ConstantPoolTable::first(uint16_t index) const -> uint16_t {
+    return _first[index];
+}
+
+auto ConstantPoolTable::second(uint16_t index) const -> uint16_t {
+    return _second[index];
+}
+
+auto ConstantPoolTable::validate() const -> std::vector<Result> {
+#ifdef ARES_HAS_AVX2_KERNEL
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) return _validate_avx2();
+#endif
+
+    return validate_scalar();
+}
+
+auto ConstantPoolTable::validate_scalar() const -> std::vector<Result> {
+    std::vector<Result> results;
+
+    auto is_valid = [&](uint16_t reference, uint32_t expected) {
+        return reference < _size && accepts(expected, _tags[reference]);
+    };
+
+    for (size_t index = 1; index < _size; index++) {
+        auto tag = _tags[index];
+
+        uint8_t violations = 0;
+        if (!is_valid(_first[index], expected_tags.first[tag])) violations |= ConstantPoolTable::FIRST;
+        if (!is_valid(_second[index], expected_tags.second[tag])) violations |= ConstantPoolTable::SECOND;
+
+        if (violations) results.push_back({static_cast<uint16_t>(index), violations});
+    }
+
+    return results;
+}
+
+auto ConstantPoolTable::_references(const ConstantPoolInfo &info) -> std::pair<uint16_t, uint16_t> {
+    switch (info.tag) {
+        case ConstantPoolInfo::CLASS:
+            return {info.info.class_info.name_index, 0};
+        case ConstantPoolInfo::STRING:
+            return {info.info.string_info.string_index, 0};
+        case ConstantPoolInfo::METHOD_TYPE:
+            return {info.info.method_type_info.descriptor_index, 0};
+        case ConstantPoolInfo::MODULE:
+        case ConstantPoolInfo::PACKAGE:
+            return {info.info.module_package_info.name_index, 0};
+        case ConstantPoolInfo::NAME_AND_TYPE:
+            return {info.info.name_and_type_info.name_index, info.info.name_and_type_info.descriptor_index};
+        case ConstantPoolInfo::FIELD_REF:
+        case ConstantPoolInfo::METHOD_REF:
+        case ConstantPoolInfo::INTERFACE_METHOD_REF:
+            return {info.info.field_method_info.class_index, info.info.field_method_info.name_and_type_index};
+        default:
+            return {0, 0};
+    }
+}
+
+#ifdef ARES_HAS_AVX2_KERNEL
+
+namespace {
+
+// Returns a lane mask of the references which are out of range or point at an unexpected tag.
+__attribute__((target("avx2")))
+auto invalid_lanes(const uint8_t *tags, __m256i entry_tags, const uint16_t *references, const uint32_t *expected,
+                   __m256i size) -> int {
+    auto indices = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(references)));
+    auto in_range = _mm256_cmpgt_epi32(size, indices);
+
+    // Out of range lanes gather index 0 instead and are masked out afterward.
+    auto clamped = _mm256_and_si256(indices, in_range);
+    auto target_tags = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int *>(tags), clamped, 1),
+                                        _mm256_set1_epi32(0xFF));
+
+    auto masks = _mm256_i32gather_epi32(reinterpret_cast<const int *>(expected), entry_tags, 4);
+    auto matches = _mm256_and_si256(_mm256_srlv_epi32(masks, target_tags), _mm256_set1_epi32(1));
+
+    auto valid = _mm256_and_si256(_mm256_cmpeq_epi32(matches, _mm256_set1_epi32(1)), in_range);
+    return ~_mm256_movemask_ps(_mm256_castsi256_ps(valid)) & 0xFF;
+}
+
+} // namespace
+
+__attribute__((target("avx2")))
+auto ConstantPoolTable::_validate_avx2() const -> std::vector<Result> {
+    std::vector<Result> results;
+    auto size = _mm256_set1_epi32(static_cast<int>(_size));
+
+    for (size_t block = 0; block < _size; block += BLOCK_SIZE) {
+        auto entry_tags = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&_tags[block])));
+
+        auto first = invalid_lanes(_tags.data(), entry_tags, &_first[block], expected_tags.first.data(), size);
+        auto second = invalid_lanes(_tags.data(), entry_tags, &_second[block], expected_tags.second.data(), size);
+        if (!(first | second)) continue;
+
+        for (size_t lane = 0; lane < BLOCK_SIZE; lane++) {
+            auto index = block + lane;
+            if (index == 0 || index >= _size) continue;
+
+            uint8_t violations = 0;
+            if (first & (1 << lane)) violations |= ConstantPoolTable::FIRST;
+            if (second & (1 << lane)) violations |= ConstantPoolTable::SECOND;
+
+            if (violations) results.push_back({static_cast<uint16_t>(index), violations});
+        }
+    }
+
+    return results;
+}
+
+#else
+
+auto ConstantPoolTable::_validate_avx2() const -> std::vector<Result> {
+    return validate_scalar();
+}
+
+#endif
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
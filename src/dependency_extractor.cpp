@@ -0,0 +1,254 @@
+#include "dependency_extractor.h"
+
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+#include <deque>
+
+#include "constant_pool_scanner.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "descriptor.h"
+#include "field_info.h"
+#include "zip_reader.h"
+#include "parallel.h"
+
+using namespace ares;
+
+namespace {
+
+auto read_u32(const uint8_t *data) -> uint32_t {
+    return static_cast<uint32_t>(ConstantPoolScanner::read_u16(data)) << 16 | ConstantPoolScanner::read_u16(data + 2);
+}
+
+void add_descriptor_classes(std::string_view text, std::vector<std::string_view> &classes) {
+    if (auto descriptor = Descriptor::parse(text)) {
+        classes.insert(classes.end(), descriptor->referenced_classes.begin(), descriptor->referenced_classes.end());
+    }
+}
+
+auto package_of(std::string_view name) -> std::string_view {
+    auto slash = name.rfind('/');
+    return slash == std::string_view::npos ? std::string_view{} : name.substr(0, slash);
+}
+
+// The dependencies found by one worker, with names interned into a table of its own.
+struct PartialGraph {
+    std::deque<std::string> names{};
+    std::unordered_map<std::string_view, uint32_t> ids{};
+    std::vector<DependencyGraph::Edge> edges{};
+
+    auto intern(std::string_view name) -> uint32_t {
+        auto found = ids.find(name);
+        if (found != ids.end()) return found->second;
+
+        auto id = static_cast<uint32_t>(names.size());
+        ids.emplace(names.emplace_back(name), id);
+        return id;
+    }
+
+    void add(const DependencyExtractor::ClassDependencies &dependencies) {
+        auto from = intern(dependencies.name);
+        for (auto referenced: dependencies.referenced_classes) {
+            edges.push_back({from, intern(referenced)});
+        }
+    }
+};
+
+auto index_of(const std::vector<std::string> &names, std::string_view name) -> uint32_t {
+    auto found = std::lower_bound(names.begin(), names.end(), name);
+    if (found == names.end() || *found != name) return DependencyGraph::MISSING;
+    return static_cast<uint32_t>(found - names.begin());
+}
+
+auto sorted_unique(std::vector<std::string_view> names) -> std::vector<std::string> {
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return {names.begin(), names.end()};
+}
+
+template<typename Edges>
+void sort_unique(Edges &edges) {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+// Merges the partial graphs of the chunks.
+auto build_graph(const std::vector<PartialGraph> &partials) -> DependencyGraph {
+    std::vector<std::string_view> names;
+    for (const auto &partial: partials) names.insert(names.end(), partial.names.begin(), partial.names.end());
+
+    DependencyGraph graph;
+    graph.classes = sorted_unique(std::move(names));
+
+    for (const auto &partial: partials) {
+        std::vector<uint32_t> global_ids;
+        global_ids.reserve(partial.names.size());
+        for (const auto &name: partial.names) global_ids.push_back(index_of(graph.classes, name));
+
+        for (auto edge: partial.edges) graph.class_edges.push_back({global_ids[edge.from], global_ids[edge.to]});
+    }
+    sort_unique(graph.class_edges);
+
+    std::vector<std::string_view> packages;
+    for (const auto &name: graph.classes) packages.push_back(package_of(name));
+    graph.packages = sorted_unique(packages);
+
+    std::vector<uint32_t> package_ids;
+    package_ids.reserve(packages.size());
+    for (auto package: packages) package_ids.push_back(index_of(graph.packages, package));
+
+    for (auto edge: graph.class_edges) {
+        auto from = package_ids[edge.from], to = package_ids[edge.to];
+        if (from != to) graph.package_edges.push_back({from, to});
+    }
+    sort_unique(graph.package_edges);
+
+    return graph;
+}
+
+} // namespace
+
+auto DependencyGraph::find_class(std::string_view name) const -> uint32_t {
+    return index_of(classes, name);
+}
+
+auto DependencyGraph::find_package(std::string_view name) const -> uint32_t {
+    return index_of(packages, name);
+}
+
+auto DependencyExtractor::extract_class(const uint8_t *data, size_t size) -> std::optional<ClassDependencies> {
+    if (size < 10 || read_u32(data) != 0xCAFEBABE) return std::nullopt;
+
+    ConstantPoolScanner pool;
+    auto end = pool.scan(data, size);
+
+    // Only the access flags and this_class are read past the pool.
+    if (!end || *end + 4 > size) return std::nullopt;
+    auto this_class = ConstantPoolScanner::read_u16(data + *end + 2);
+
+    auto count = pool.count();
+    auto utf8 = [&](size_t index) {
+        std::string_view value;
+        pool.utf8(index, value);
+        return value;
+    };
+
+    std::vector<bool> literals(count);
+    for (size_t index = 1; index < count; index++) {
+        if (pool.tag(index) != ConstantPoolInfo::STRING) continue;
+
+        auto string_index = pool.operand(index, 0);
+        if (string_index < count) literals[string_index] = true;
+    }
+
+    ClassDependencies dependencies;
+    if (pool.tag(this_class) == ConstantPoolInfo::CLASS) dependencies.name = utf8(pool.operand(this_class, 0));
+
+    auto &classes = dependencies.referenced_classes;
+    for (size_t index = 1; index < count; index++) {
+        switch (pool.tag(index)) {
+            case ConstantPoolInfo::CLASS: {
+                auto name = utf8(pool.operand(index, 0));
+                if (name.starts_with('[')) {
+                    add_descriptor_classes(name, classes);
+                } else if (!name.empty()) {
+                    classes.push_back(name);
+                }
+                break;
+            }
+            case ConstantPoolInfo::NAME_AND_TYPE: {
+                add_descriptor_classes(utf8(pool.operand(index, 1)), classes);
+                break;
+            }
+            case ConstantPoolInfo::METHOD_TYPE: {
+                add_descriptor_classes(utf8(pool.operand(index, 0)), classes);
+                break;
+            }
+            case ConstantPoolInfo::UTF_8: {
+                // Cheap check first, names and attribute names can't start a descriptor with a class in it.
+                auto text = utf8(index);
+                if (!literals[index] && !text.empty() && (text[0] == '(' || text[0] == 'L' || text[0] == '[')) {
+                    add_descriptor_classes(text, classes);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    std::sort(classes.begin(), classes.end());
+    classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+    std::erase(classes, dependencies.name);
+
+    return dependencies;
+}
+
+auto DependencyExtractor::extract_jar(const std::string &path, unsigned int thread_count) -> DependencyGraph {
+    auto extract = [&](const ZipEntry &entry, std::span<const uint8_t> data, PartialGraph &partial) {
+        auto dependencies = extract_class(data.data(), data.size());
+        if (!dependencies) {
+            throw std::runtime_error("Warning: Couldn't extract the dependencies of: " + path + "!/" + entry.name);
+        }
+
+        partial.add(*dependencies);
+    };
+
+    return build_graph(read_class_chunks<PartialGraph>(path, thread_count, extract));
+}
+
+auto DependencyExtractor::extract_jar(JARFile &jar_file, unsigned int thread_count) -> DependencyGraph {
+    std::vector<std::pair<std::string, const ClassFile *>> classes;
+    jar_file.visit_classes([&](const std::string &entry_name, ClassFile &class_file) {
+        classes.emplace_back(entry_name, &class_file);
+    });
+
+    std::vector<PartialGraph> partials(chunk_count(classes.size(), thread_count));
+    parallel_for(partials.size(), [&](size_t chunk) {
+        for (auto index = chunk; index < classes.size(); index += partials.size()) {
+            const auto &byte_code = classes[index].second->byte_code;
+            auto dependencies = extract_class(byte_code.data(), byte_code.size());
+            if (!dependencies) {
+                throw std::runtime_error("Warning: Couldn't extract the dependencies of: " + classes[index].first);
+            }
+
+            partials[chunk].add(*dependencies);
+        }
+    }, thread_count);
+
+    return build_graph(partials);
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "descriptor.h"
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "class_file.h"
+#include "field_info.h"
+
+using namespace ares;
+
+auto Descriptor::parse_field(std::string_view descriptor) -> std::optional<Descriptor> {
+    Descriptor result;
+
+    size_t offset = 0;
+    auto kind = _parse_type(descriptor, offset, result);
+    if (!kind || *kind == Descriptor::VOID || offset != descriptor.size()) {
+        return std::nullopt;
+    }
+
+    result.return_kind = *kind;
+    return result;
+}
+
+auto Descriptor::parse_method(std::string_view descriptor) -> std::optional<Descriptor> {
+    if (descriptor.empty() || descriptor[0] != '(') {
+        return std::nullopt;
+    }
+
+    Descriptor result;
+    result.method = true;
+
+    size_t offset = 1;
+    unsigned int slots = 0;
+    while (offset < descriptor.size() && descriptor[offset] != ')') {
+        auto kind = _parse_type(descriptor, offset, result);
+        if (!kind || *kind == Descriptor::VOID) {
+            return std::nullopt;
+        }
+
+        result.parameter_count++;
+        slots += (*kind == Descriptor::LONG || *kind == Descriptor::DOUBLE) ? 2 : 1;
+    }
+
+    // Methods are limited to 255 parameter slots, including "this" which isn't part of the descriptor.
+    if (offset >= descriptor.size() || slots > 255) {
+        return std::nullopt;
+    }
+
+    offset++;
+
+    auto kind = _parse_type(descriptor, offset, result);
+    if (!kind || offset != descriptor.size()) {
+        return std::nullopt;
+    }
+
+    result.parameter_slots = static_cast<uint16_t>(slots);
+    result.return_kind = *kind;
+    return result;
+}
+
+auto Descriptor::parse(std::string_view descriptor) -> std::optional<Descriptor> {
+    if (!descriptor.empty() && descriptor[0] == '(') {
+        return parse_method(descriptor);
+    }
+
+    return parse_field(descriptor);
+}
+
+auto Descriptor::_parse_type(std::string_view descriptor, size_t &offset, Descriptor &result) -> std::optional<Kind> {
+    size_t dimensions = 0;
+    while (offset < descriptor.size() && descriptor[offset] == '[') {
+        dimensions++;
+        offset++;
+    }
+
+    if (offset >= descriptor.size() || dimensions > 255) {
+        return std::nullopt;
+    }
+
+    auto kind = Kind(descriptor[offset++]);
+    switch (kind) {
+        case Descriptor::BYTE:
+        case Descriptor::CHAR:
+        case Descriptor::DOUBLE:
+        case Descriptor::FLOAT:
+        case Descriptor::INT:
+        case Descriptor::LONG:
+        case Descriptor::SHORT:
+        case Descriptor::BOOLEAN:
+            break;
+        case Descriptor::VOID:
+            // Void is only valid as return type, which the callers check.
+            if (dimensions != 0) return std::nullopt;
+            break;
+        case Descriptor::OBJECT: {
+            auto end = descriptor.find(';', offset);
+            if (end == std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            // Binary names consist of non-empty unqualified names separated by slashes.
+            auto name = descriptor.substr(offset, end - offset);
+            if (name.empty() || name.front() == '/' || name.back() == '/'
+                || name.find_first_of(".[") != std::string_view::npos
+                || name.find("//") != std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            result.referenced_classes.push_back(name);
+            offset = end + 1;
+            break;
+        }
+        default:
+            return std::nullopt;
+    }
+
+    return dimensions != 0 ? Descriptor::ARRAY : kind;
+}
+
+void DescriptorCache::reset(const ClassFile &class_file) {
+    _descriptors.clear();
+    _states.assign(class_file.constant_pool.size() + 1, DescriptorCache::UNPARSED);
+    _slots.assign(_states.size(), 0);
+}
+
+void DescriptorCache::prepare(const ClassFile &class_file) {
+    reset(class_file);
+
+    for (size_t index = 1; index < _states.size(); index++) {
+        (void) _lookup(class_file, static_cast<uint16_t>(index));
+    }
+}
+
+auto DescriptorCache::field(const ClassFile &class_file, uint16_t index) -> const Descriptor * {
+    auto descriptor = _lookup(class_file, index);
+    return descriptor && !descriptor->method ? descriptor : nullptr;
+}
+
+auto DescriptorCache::method(const ClassFile &class_file, uint16_t index) -> const Descriptor * {
+    auto descriptor = _lookup(class_file, index);
+    return descriptor && descriptor->method ? descriptor : nullptr;
+}
+
+auto DescriptorCache::field(const ClassFile &class_file, uint16_t index) const -> const Descriptor * {
+    auto descriptor = _find(class_file, index);
+    return descriptor && !descriptor->method ? descriptor : nullptr;
+}
+
+auto DescriptorCache::method(const ClassFile &class_file, uint16_t index) const -> const Descriptor * {
+    auto descriptor = _find(class_file, index);
+    return descriptor && descriptor->method ? descriptor : nullptr;
+}
+
+auto DescriptorCache::_lookup(const ClassFile &class_file, uint16_t index) -> const Descriptor * {
+    if (_states.size() != class_file.constant_pool.size() + 1) {
+        reset(class_file);
+    }
+
+    if (!class_file.is_valid_index(index)) {
+        return nullptr;
+    }
+
+    if (_states[index] == DescriptorCache::UNPARSED) {
+        auto utf8 = class_file.utf8(index);
+        auto descriptor = utf8.empty() ? std::nullopt : Descriptor::parse(utf8);
+
+        if (descriptor) {
+            _descriptors.push_back(std::move(*descriptor));
+            _slots[index] = static_cast<uint32_t>(_descriptors.size() - 1);
+            _states[index] = DescriptorCache::VALID;
+        } else {
+            _states[index] = DescriptorCache::INVALID;
+        }
+    }
+
+    if (_states[index] != DescriptorCache::VALID) {
+        return nullptr;
+    }
+
+    return &_descriptors[_slots[index]];
+}
+
+auto DescriptorCache::_find(const ClassFile &class_file, uint16_t index) const -> const Descriptor * {
+    if (_states.size() != class_file.constant_pool.size() + 1 || !class_file.is_valid_index(index)) {
+        return nullptr;
+    }
+
+    if (_states[index] != DescriptorCache::VALID) {
+        return nullptr;
+    }
+
+    return &_descriptors[_slots[index]];
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace ares;
+
+namespace {
+
+constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+auto rotate_left(uint64_t value, int bits) -> uint64_t {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+auto read_u64(const uint8_t *data) -> uint64_t {
+    uint64_t value = 0;
+    for (int index = 7; index >= 0; index--) {
+        value = (value << 8) | data[index];
+    }
+    return value;
+}
+
+auto read_u32(const uint8_t *data) -> uint64_t {
+    return static_cast<uint64_t>(data[0]) | (static_cast<uint64_t>(data[1]) << 8)
+           | (static_cast<uint64_t>(data[2]) << 16) | (static_cast<uint64_t>(data[3]) << 24);
+}
+
+auto round(uint64_t accumulator, uint64_t input) -> uint64_t {
+    accumulator += input * PRIME_2;
+    accumulator = rotate_left(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+auto merge_round(uint64_t accumulator, uint64_t value) -> uint64_t {
+    accumulator ^= round(0, value);
+    return accumulator * PRIME_1 + PRIME_4;
+}
+
+} // namespace
+
+auto ares::hash64(const uint8_t *data, size_t size, uint64_t seed) -> uint64_t {
+    const auto *end = data + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        const auto *limit = end - 32;
+        uint64_t first = seed + PRIME_1 + PRIME_2, second = seed + PRIME_2, third = seed, fourth = seed - PRIME_1;
+
+        do {
+            first = round(first, read_u64(data));
+            second = round(second, read_u64(data + 8));
+            third = round(third, read_u64(data + 16));
+            fourth = round(fourth, read_u64(data + 24));
+            data += 32;
+        } while (data <= limit);
+
+        hash = rotate_left(first, 1) + rotate_left(second, 7) + rotate_left(third, 12) + rotate_left(fourth, 18);
+        hash = merge_round(hash, first);
+        hash = merge_round(hash, second);
+        hash = merge_round(hash, third);
+        hash = merge_round(hash, fourth);
+    } else {
+        hash = seed + PRIME_5;
+    }
+
+    hash += size;
+
+    for (; data + 8 <= end; data += 8) {
+        hash ^= round(0, read_u64(data));
+        hash = rotate_left(hash, 27) * PRIME_1 + PRIME_4;
+    }
+
+    if (data + 4 <= end) {
+        hash ^= read_u32(data) * PRIME_1;
+        hash = rotate_left(hash, 23) * PRIME_2 + PRIME_3;
+        data += 4;
+    }
+
+    for (; data < end; data++) {
+        hash ^= (*data) * PRIME_5;
+        hash = rotate_left(hash, 11) * PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+auto ares::hash64(std::string_view data, uint64_t seed) -> uint64_t {
+    return hash64(reinterpret_cast<const uint8_t *>(data.data()), data.size(), seed);
+}
+
+namespace {
+
+constexpr uint32_t SHA256_ROUND_CONSTANTS[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2};
+
+auto rotate_right(uint32_t value, int bits) -> uint32_t {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+} // namespace
+
+void SHA256::update(const uint8_t *data, size_t size) {
+    _length += size;
+
+    if (_buffered > 0) {
+        auto count = std::min(size, _buffer.size() - _buffered);
+        std::memcpy(_buffer.data() + _buffered, data, count);
+        _buffered += count;
+        data += count;
+        size -= count;
+
+        if (_buffered < _buffer.size()) return;
+
+        _compress(_buffer.data());
+        _buffered = 0;
+    }
+
+    for (; size >= 64; data += 64, size -= 64) {
+        _compress(data);
+    }
+
+    if (size > 0) {
+        std::memcpy(_buffer.data(), data, size);
+        _buffered = size;
+    }
+}
+
+void SHA256::update(std::string_view data) {
+    update(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+}
+
+auto SHA256::finish() -> Digest {
+    auto bit_length = _length * 8;
+
+    uint8_t padding[72] = {0x80};
+    auto padding_size = (_buffered < 56 ? 56 : 120) - _buffered;
+    for (int index = 0; index < 8; index++) {
+        padding[padding_size + index] = static_cast<uint8_t>(bit_length >> (56 - 8 * index));
+    }
+    update(padding, padding_size + 8);
+
+    Digest digest;
+    for (size_t index = 0; index < _state.size(); index++) {
+        for (int byte = 0; byte < 4; byte++) {
+            digest[index * 4 + byte] = static_cast<uint8_t>(_state[index] >> (24 - 8 * byte));
+        }
+    }
+    return digest;
+}
+
+auto SHA256::digest(const uint8_t *data, size_t size) -> Digest {
+    SHA256 sha256;
+    sha256.update(data, size);
+    return sha256.finish();
+}
+
+auto SHA256::digest(std::string_view data) -> Digest {
+    return digest(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+}
+
+void SHA256::_compress(const uint8_t *block) {
+    uint32_t words[64];
+    for (int index = 0; index < 16; index++) {
+        words[index] = (uint32_t(block[index * 4]) << 24) | (uint32_t(block[index * 4 + 1]) << 16)
+                       | (uint32_t(block[index * 4 + 2]) << 8) | uint32_t(block[index * 4 + 3]);
+    }
+
+    for (int index = 16; index < 64; index++) {
+        auto first = words[index - 15], second = words[index - 2];
+        auto sigma_0 = rotate_right(first, 7) ^ rotate_right(first, 18) ^ (first >> 3);
+        auto sigma_1 = rotate_right(second, 17) ^ rotate_right(second, 19) ^ (second >> 10);
+        words[index] = words[index - 16] + sigma_0 + words[index - 7] + sigma_1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = _state;
+    for (int index = 0; index < 64; index++) {
+        auto sum_1 = rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25);
+        auto choice = (e & f) ^ (~e & g);
+        auto first = h + sum_1 + choice + SHA256_ROUND_CONSTANTS[index] + words[index];
+        auto sum_0 = rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22);
+        auto majority = (a & b) ^ (a & c) ^ (b & c);
+        auto second = sum_0 + majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + first;
+        d = c;
+        c = b;
+        b = a;
+        a = first + second;
+    }
+
+    _state = {_state[0] + a, _state[1] + b, _state[2] + c, _state[3] + d,
+              _state[4] + e, _state[5] + f, _state[6] + g, _state[7] + h};
+}
+
+auto ares::base64_encode(const uint8_t *data, size_t size) -> std::string {
+    constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string encoded;
+    encoded.reserve((size + 2) / 3 * 4);
+
+    for (size_t index = 0; index < size; index += 3) {
+        uint32_t group = uint32_t(data[index]) << 16;
+        if (index + 1 < size) group |= uint32_t(data[index + 1]) << 8;
+        if (index + 2 < size) group |= data[index + 2];
+
+        encoded.push_back(alphabet[(group >> 18) & 0x3F]);
+        encoded.push_back(alphabet[(group >> 12) & 0x3F]);
+        encoded.push_back(index + 1 < size ? alphabet[(group >> 6) & 0x3F] : '=');
+        encoded.push_back(index + 2 < size ? alphabet[group & 0x3F] : '=');
+    }
+
+    return encoded;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
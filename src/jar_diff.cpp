@@ -0,0 +1,461 @@
+#include "jar_diff.h"
+
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <map>
+
+#include <boost/algorithm/string.hpp>
+
+#include "constant_pool_compactor.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "zip_reader.h"
+#include "parallel.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+// Constants nested deeper than this can only come from a cyclic, malformed constant pool.
+constexpr int MAX_DEPTH = 8;
+
+// The canonical forms of the attributes of a class or member by attribute name.
+using CanonicalAttributes = std::map<std::string, std::vector<std::string>>;
+
+auto is_class(const std::string &name) -> bool {
+    return boost::algorithm::iends_with(name, ".class");
+}
+
+// Appends the part as a netstring like "5:hello", which keeps the concatenated parts unambiguous.
+void append_part(std::string &result, std::string_view part) {
+    result += std::to_string(part.size());
+    result += ':';
+    result += part;
+}
+
+// Renders the constant with everything it references, so that equal constants render equally in any constant pool.
+auto render_constant(const ClassFile &class_file, uint16_t index, int depth = 0) -> std::string {
+    if (!class_file.is_valid_index(index) || depth > MAX_DEPTH) return "#" + std::to_string(index);
+
+    const auto &info = class_file.constant_pool[index - 1];
+    auto result = std::to_string(info.tag) + '|';
+    auto reference = [&](uint16_t referenced) {
+        append_part(result, render_constant(class_file, referenced, depth + 1));
+    };
+
+    switch (info.tag) {
+        case ConstantPoolInfo::UTF_8:
+            append_part(result, class_file.utf8(index));
+            break;
+        case ConstantPoolInfo::INTEGER:
+        case ConstantPoolInfo::FLOAT:
+            result += std::to_string(info.info.integer_float_info.bytes);
+            break;
+        case ConstantPoolInfo::LONG:
+        case ConstantPoolInfo::DOUBLE:
+            result += std::to_string(info.info.long_double_info.high_bytes) + ','
+                      + std::to_string(info.info.long_double_info.low_bytes);
+            break;
+        case ConstantPoolInfo::CLASS:
+            reference(info.info.class_info.name_index);
+            break;
+        case ConstantPoolInfo::STRING:
+            reference(info.info.string_info.string_index);
+            break;
+        case ConstantPoolInfo::METHOD_TYPE:
+            reference(info.info.method_type_info.descriptor_index);
+            break;
+        case ConstantPoolInfo::MODULE:
+        case ConstantPoolInfo::PACKAGE:
+            reference(info.info.module_package_info.name_index);
+            break;
+        case ConstantPoolInfo::FIELD_REF:
+        case ConstantPoolInfo::METHOD_REF:
+        case ConstantPoolInfo::INTERFACE_METHOD_REF:
+            reference(info.info.field_method_info.class_index);
+            reference(info.info.field_method_info.name_and_type_index);
+            break;
+        case ConstantPoolInfo::NAME_AND_TYPE:
+            reference(info.info.name_and_type_info.name_index);
+            reference(info.info.name_and_type_info.descriptor_index);
+            break;
+        case ConstantPoolInfo::METHOD_HANDLE:
+            result += std::to_string(info.info.method_handle_info.reference_kind) + ',';
+            reference(info.info.method_handle_info.reference_index);
+            break;
+        case ConstantPoolInfo::DYNAMIC:
+        case ConstantPoolInfo::INVOKE_DYNAMIC:
+            // The bootstrap method index points into the BootstrapMethods attribute, which is compared on its own.
+            result += std::to_string(info.info.dynamic_info.boostrap_method_attr_index) + ',';
+            reference(info.info.dynamic_info.name_and_type_index);
+            break;
+        default:
+            break;
+    }
+
+    return result;
+}
+
+// The attribute data with its constant pool indices zeroed, followed by the constants they point at.
+auto canonical_attribute(const ClassFile &class_file, std::string_view name,
+                         const AttributeInfo &attribute) -> std::string {
+    std::span<const uint8_t> data(attribute.info, attribute.attribute_length);
+
+    std::vector<std::pair<size_t, bool>> indices;
+    auto known = ConstantPoolCompactor::visit_indices(class_file, name, data, [&](size_t offset, bool wide) {
+        indices.emplace_back(offset, wide);
+    });
+    if (!known) indices.clear();
+
+    std::string skeleton(reinterpret_cast<const char *>(data.data()), data.size());
+    std::string constants;
+
+    std::sort(indices.begin(), indices.end());
+    for (auto [offset, wide]: indices) {
+        auto index = wide ? static_cast<uint16_t>(data[offset] << 8 | data[offset + 1]) : data[offset];
+        skeleton[offset] = 0;
+        if (wide) skeleton[offset + 1] = 0;
+
+        append_part(constants, render_constant(class_file, index));
+    }
+
+    std::string result;
+    append_part(result, skeleton);
+    result += constants;
+    return result;
+}
+
+auto attribute_of(const AttributeInfo &attribute) -> const AttributeInfo & {
+    return attribute;
+}
+
+auto attribute_of(const std::shared_ptr<AttributeInfo> &attribute) -> const AttributeInfo & {
+    return *attribute;
+}
+
+template<typename Attributes>
+auto canonical_attributes(const ClassFile &class_file, const Attributes &attributes) -> CanonicalAttributes {
+    CanonicalAttributes result;
+    for (const auto &item: attributes) {
+        const auto &attribute = attribute_of(item);
+        auto name = class_file.utf8(attribute.attribute_name_index);
+        result[std::string(name)].push_back(canonical_attribute(class_file, name, attribute));
+    }
+    return result;
+}
+
+void diff_attributes(const CanonicalAttributes &old_attributes, const CanonicalAttributes &new_attributes,
+                     const std::string &entry, const std::string &member, std::vector<JARDiff::Change> &changes) {
+    for (const auto &[name, forms]: old_attributes) {
+        auto found = new_attributes.find(name);
+        if (found == new_attributes.end()) {
+            changes.push_back({JARDiff::REMOVED, entry, member, "attribute " + name});
+        } else if (found->second != forms) {
+            changes.push_back({JARDiff::CHANGED, entry, member, "attribute " + name});
+        }
+    }
+
+    for (const auto &[name, forms]: new_attributes) {
+        if (!old_attributes.contains(name)) changes.push_back({JARDiff::ADDED, entry, member, "attribute " + name});
+    }
+}
+
+// Matches the fields or methods of both versions by name and descriptor.
+template<typename Members>
+void diff_members(const std::string &entry, const ClassFile &old_class, const Members &old_members,
+                  const ClassFile &new_class, const Members &new_members, bool fields,
+                  std::vector<JARDiff::Change> &changes) {
+    auto key_of = [&](const ClassFile &class_file, const auto &member) {
+        auto key = std::string(class_file.utf8(member.name_index));
+        if (fields) key += ':';
+        return key.append(class_file.utf8(member.descriptor_index));
+    };
+
+    std::unordered_map<std::string, const typename Members::value_type *> remaining;
+    for (const auto &member: new_members) remaining.emplace(key_of(new_class, member), &member);
+
+    for (const auto &member: old_members) {
+        auto key = key_of(old_class, member);
+        auto found = remaining.find(key);
+        if (found == remaining.end()) {
+            changes.push_back({JARDiff::REMOVED, entry, key, {}});
+            continue;
+        }
+
+        const auto &other = *found->second;
+        if (member.access_flags != other.access_flags) {
+            changes.push_back({JARDiff::CHANGED, entry, key, "access_flags"});
+        }
+
+        diff_attributes(canonical_attributes(old_class, member.attributes),
+                        canonical_attributes(new_class, other.attributes), entry, key, changes);
+        remaining.erase(found);
+    }
+
+    for (const auto &item: remaining) changes.push_back({JARDiff::ADDED, entry, item.first, {}});
+}
+
+// The central directory by entry name.
+auto read_entries(const std::string &path) -> std::unordered_map<std::string, ZipEntry> {
+    std::unordered_map<std::string, ZipEntry> entries;
+    for (auto &entry: read_directory(path)) {
+        auto name = entry.name;
+        entries.insert_or_assign(std::move(name), std::move(entry));
+    }
+    return entries;
+}
+
+auto same_content(const JARFile &old_jar, const JARFile &new_jar, const std::string &name) -> bool {
+    auto old_other = old_jar.others.find(name);
+    auto new_other = new_jar.others.find(name);
+    if (old_other != old_jar.others.end() && new_other != new_jar.others.end()) {
+        return old_other->second == new_other->second;
+    }
+
+    // At least one side is streamed from disk, so both are digested in chunks.
+    auto digest = [&](const JARFile &jar_file) {
+        SHA256 sha256;
+        jar_file.read_entry(name, [&](const uint8_t *data, size_t size) {
+            sha256.update(data, size);
+        });
+        return sha256.finish();
+    };
+    return digest(old_jar) == digest(new_jar);
+}
+
+auto resource_names(const JARFile &jar_file) -> std::vector<std::string> {
+    std::vector<std::string> names;
+    for (const auto &item: jar_file.others) names.push_back(item.first);
+    for (const auto &item: jar_file.streamed) names.push_back(item.first);
+    return names;
+}
+
+} // namespace
+
+auto JARDiff::diff_files(const std::string &old_path, const std::string &new_path,
+                         unsigned int thread_count) -> std::vector<Change> {
+    auto old_entries = read_entries(old_path);
+    auto new_entries = read_entries(new_path);
+
+    std::vector<Change> changes;
+    std::vector<std::string> pending;
+
+    for (const auto &[name, entry]: old_entries) {
+        auto found = new_entries.find(name);
+        if (found == new_entries.end()) {
+            changes.push_back({JARDiff::REMOVED, name, {}, {}});
+            continue;
+        }
+
+        const auto &other = found->second;
+        if (entry.size == other.size && entry.crc && entry.crc == other.crc) continue;
+
+        // Classes of different sizes or CRCs may still be equal in structure, other entries are known to differ.
+        if (!is_class(name) && (entry.size != other.size || (entry.crc && other.crc))) {
+            changes.push_back({JARDiff::CHANGED, name, {}, {}});
+        } else {
+            pending.push_back(name);
+        }
+    }
+
+    for (const auto &item: new_entries) {
+        if (!old_entries.contains(item.first)) changes.push_back({JARDiff::ADDED, item.first, {}, {}});
+    }
+
+    std::vector<std::vector<Change>> results(chunk_count(pending.size(), thread_count));
+    parallel_for(pending.empty() ? 0 : results.size(), [&](size_t chunk) {
+        zip_t *old_zip = open_zip(old_path);
+        zip_t *new_zip = nullptr;
+
+        try {
+            new_zip = open_zip(new_path);
+
+            for (auto index = chunk; index < pending.size(); index += results.size()) {
+                const auto &name = pending[index];
+                auto old_data = read_entry(old_zip, old_entries.at(name), old_path);
+                auto new_data = read_entry(new_zip, new_entries.at(name), new_path);
+                if (old_data == new_data) continue;
+
+                if (!is_class(name)) {
+                    results[chunk].push_back({JARDiff::CHANGED, name, {}, {}});
+                    continue;
+                }
+
+                auto class_changes = diff_class(name, JARFile::read_class(std::move(old_data)),
+                                                JARFile::read_class(std::move(new_data)));
+                std::move(class_changes.begin(), class_changes.end(), std::back_inserter(results[chunk]));
+            }
+        } catch (...) {
+            zip_discard(old_zip);
+            if (new_zip) zip_discard(new_zip);
+            throw;
+        }
+
+        zip_discard(old_zip);
+        zip_discard(new_zip);
+    }, thread_count);
+
+    for (auto &result: results) {
+        std::move(result.begin(), result.end(), std::back_inserter(changes));
+    }
+
+    std::sort(changes.begin(), changes.end());
+    return changes;
+}
+
+auto JARDiff::diff(const JARFile &old_jar, const JARFile &new_jar, unsigned int thread_count) -> std::vector<Change> {
+    std::vector<Change> changes;
+    std::vector<std::pair<const std::string *, const ClassFile *>> pending;
+
+    for (const auto &[name, class_file]: old_jar.classes) {
+        auto found = new_jar.classes.find(name);
+        if (found == new_jar.classes.end()) {
+            changes.push_back({JARDiff::REMOVED, name, {}, {}});
+        } else if (class_file.byte_code.empty() || class_file.byte_code != found->second.byte_code) {
+            pending.emplace_back(&name, &class_file);
+        }
+    }
+
+    for (const auto &item: new_jar.classes) {
+        if (!old_jar.classes.contains(item.first)) changes.push_back({JARDiff::ADDED, item.first, {}, {}});
+    }
+
+    std::vector<std::vector<Change>> results(pending.size());
+    parallel_for(pending.size(), [&](size_t index) {
+        const auto &name = *pending[index].first;
+        results[index] = diff_class(name, *pending[index].second, new_jar.classes.at(name));
+    }, thread_count);
+
+    for (auto &result: results) {
+        std::move(result.begin(), result.end(), std::back_inserter(changes));
+    }
+
+    auto old_names = resource_names(old_jar);
+    auto new_names = resource_names(new_jar);
+    std::sort(new_names.begin(), new_names.end());
+
+    std::vector<std::string> common;
+    for (auto &name: old_names) {
+        if (std::binary_search(new_names.begin(), new_names.end(), name)) {
+            common.push_back(std::move(name));
+        } else {
+            changes.push_back({JARDiff::REMOVED, std::move(name), {}, {}});
+        }
+    }
+
+    for (auto &name: new_names) {
+        if (!old_jar.others.contains(name) && !old_jar.streamed.contains(name)) {
+            changes.push_back({JARDiff::ADDED, std::move(name), {}, {}});
+        }
+    }
+
+    std::vector<uint8_t> changed(common.size());
+    parallel_for(common.size(), [&](size_t index) {
+        changed[index] = !same_content(old_jar, new_jar, common[index]);
+    }, thread_count);
+
+    for (size_t index = 0; index < common.size(); index++) {
+        if (changed[index]) changes.push_back({JARDiff::CHANGED, common[index], {}, {}});
+    }
+
+    const std::string manifest_name = "META-INF/MANIFEST.MF";
+    if (old_jar.manifest.empty() != new_jar.manifest.empty()) {
+        changes.push_back({old_jar.manifest.empty() ? JARDiff::ADDED : JARDiff::REMOVED, manifest_name, {}, {}});
+    } else if (old_jar.manifest.content() != new_jar.manifest.content()) {
+        changes.push_back({JARDiff::CHANGED, manifest_name, {}, {}});
+    }
+
+    std::sort(changes.begin(), changes.end());
+    return changes;
+}
+
+auto JARDiff::diff_class(const std::string &entry, const ClassFile &old_class,
+                         const ClassFile &new_class) -> std::vector<Change> {
+    std::vector<Change> changes;
+    auto changed = [&](const char *detail) {
+        changes.push_back({JARDiff::CHANGED, entry, {}, detail});
+    };
+
+    if (old_class.major_version != new_class.major_version || old_class.minor_version != new_class.minor_version) {
+        changed("version");
+    }
+    if (old_class.access_flags != new_class.access_flags) changed("access_flags");
+    if (old_class.class_name(old_class.this_class) != new_class.class_name(new_class.this_class)) changed("name");
+    if (old_class.class_name(old_class.super_class) != new_class.class_name(new_class.super_class)) {
+        changed("super_class");
+    }
+
+    auto interfaces_of = [](const ClassFile &class_file) {
+        std::vector<std::string_view> names;
+        for (auto interface: class_file.interfaces) names.push_back(class_file.class_name(interface));
+        return names;
+    };
+    if (interfaces_of(old_class) != interfaces_of(new_class)) changed("interfaces");
+
+    diff_attributes(canonical_attributes(old_class, old_class.attributes),
+                    canonical_attributes(new_class, new_class.attributes), entry, {}, changes);
+
+    diff_members(entry, old_class, old_class.fields, new_class, new_class.fields, true, changes);
+    diff_members(entry, old_class, old_class.methods, new_class, new_class.methods, false, changes);
+
+    std::sort(changes.begin(), changes.end());
+    return changes;
+}
+
+auto JARDiff::format(const std::vector<Change> &changes) -> std::string {
+    std::string result;
+    for (const auto &change: changes) {
+        switch (change.kind) {
+            case JARDiff::ADDED:
+                result += "ADDED";
+                break;
+            case JARDiff::REMOVED:
+                result += "REMOVED";
+                break;
+            case JARDiff::CHANGED:
+                result += "CHANGED";
+                break;
+        }
+
+        result += '\t' + change.entry + '\t' + change.member + '\t' + change.detail + '\n';
+    }
+    return result;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "jar_merger.h"
+
+#include <unordered_map>
+#include <string_view>
+#include <stdexcept>
+#include <algorithm>
+#include <optional>
+
+#include <boost/algorithm/string.hpp>
+
+#include "jar_signature.h"
+#include "zip_reader.h"
+#include "parallel.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+struct Entry : ZipEntry {
+    // Set for duplicates whose contents are compared, before the digest is taken.
+    bool compare{};
+    SHA256::Digest digest{};
+};
+
+// The central directory of a JAR, with the manifest and the service files already read.
+struct Source {
+    std::vector<Entry> entries{};
+    std::optional<std::string> manifest{};
+    std::vector<std::pair<std::string, std::string>> services{};
+};
+
+auto read_text(zip_t *zip, const ZipEntry &entry, const std::string &path) -> std::string {
+    auto data = read_entry(zip, entry, path);
+    return {data.begin(), data.end()};
+}
+
+auto read_source(const std::string &path) -> Source {
+    Source source;
+    zip_t *zip = open_zip(path);
+
+    try {
+        for (auto &entry: read_directory(zip)) {
+            if (entry.name == "META-INF/MANIFEST.MF") {
+                source.manifest = read_text(zip, entry, path);
+            } else if (boost::algorithm::starts_with(entry.name, "META-INF/services/")
+                       && entry.name.find('/', 18) == std::string::npos) {
+                source.services.emplace_back(entry.name, read_text(zip, entry, path));
+            } else if (!JARSignature::is_signature_file(entry.name)
+                       && !boost::algorithm::iequals(entry.name, "META-INF/INDEX.LIST")) {
+                source.entries.push_back({std::move(entry)});
+            }
+        }
+    } catch (...) {
+        zip_discard(zip);
+        throw;
+    }
+
+    zip_discard(zip);
+    return source;
+}
+
+// Digests the entries of the source that are compared, opening the JAR once.
+void digest_entries(const std::string &path, Source &source) {
+    auto compared = std::any_of(source.entries.begin(), source.entries.end(), [](auto &entry) {
+        return entry.compare;
+    });
+    if (!compared) return;
+
+    zip_t *zip = open_zip(path);
+    std::vector<uint8_t> data;
+
+    try {
+        for (auto &entry: source.entries) {
+            if (!entry.compare) continue;
+
+            read_entry(zip, entry, path, data);
+            entry.digest = SHA256::digest(data.data(), data.size());
+        }
+    } catch (...) {
+        zip_discard(zip);
+        throw;
+    }
+
+    zip_discard(zip);
+}
+
+} // namespace
+
+auto JARMerger::merge(const std::vector<std::string> &paths, const Options &options) -> Result {
+    // The directories are read concurrently, which is all the I/O merging needs besides the small files.
+    std::vector<Source> sources(paths.size());
+    parallel_for(paths.size(), [&](size_t index) {
+        sources[index] = read_source(paths[index]);
+    }, options.thread_count);
+
+    Result result;
+    auto &jar_file = result.jar_file;
+
+    // The JAR and entry every name was taken from.
+    std::unordered_map<std::string_view, std::pair<size_t, Entry *>> origins;
+
+    for (size_t source_index = 0; source_index < sources.size(); source_index++) {
+        for (auto &entry: sources[source_index].entries) {
+            auto [found, inserted] = origins.try_emplace(entry.name, source_index, &entry);
+            auto *kept = found->second.second;
+            if (!inserted && kept->size == entry.size && kept->crc == entry.crc
+                && (options.compare_contents || !entry.crc)) {
+                kept->compare = true;
+                entry.compare = true;
+            }
+        }
+    }
+
+    // The contents of duplicates are compared by their digests, so that every JAR is read once and concurrently.
+    parallel_for(paths.size(), [&](size_t index) {
+        digest_entries(paths[index], sources[index]);
+    }, options.thread_count);
+
+    for (size_t source_index = 0; source_index < sources.size(); source_index++) {
+        for (const auto &entry: sources[source_index].entries) {
+            const auto &[kept_index, kept] = origins.at(entry.name);
+            if (kept == &entry) {
+                jar_file.streamed.emplace(entry.name, JARFile::StreamedEntry{paths[source_index], entry.index,
+                                                                             entry.size});
+                continue;
+            }
+
+            auto identical = kept->size == entry.size && kept->crc == entry.crc;
+            if (identical && entry.compare) identical = kept->digest == entry.digest;
+
+            if (identical) {
+                result.identical_duplicates++;
+                continue;
+            }
+
+            if (options.duplicates == FAIL) {
+                throw std::runtime_error("Warning: The entry " + entry.name + " differs between " + paths[kept_index]
+                                         + " and " + paths[source_index] + ".");
+            }
+
+            result.conflicts.push_back({entry.name, paths[kept_index], paths[source_index]});
+        }
+    }
+
+    // Providers keep the order in which they appear, comments and blank lines are dropped.
+    std::unordered_map<std::string, std::vector<std::string>> providers;
+    std::vector<std::string> service_names;
+
+    for (const auto &source: sources) {
+        for (const auto &[name, content]: source.services) {
+            auto [found, inserted] = providers.try_emplace(name);
+            if (inserted) service_names.push_back(name);
+
+            std::string_view remaining(content);
+            while (!remaining.empty()) {
+                auto end = remaining.find('\n');
+                auto line = trim(remaining.substr(0, std::min(remaining.find('#'), end)));
+                remaining = end == std::string_view::npos ? std::string_view() : remaining.substr(end + 1);
+
+                auto &names = found->second;
+                if (!line.empty() && std::find(names.begin(), names.end(), line) == names.end()) {
+                    names.emplace_back(line);
+                }
+            }
+        }
+    }
+
+    for (const auto &name: service_names) {
+        std::string content;
+        for (const auto &provider: providers[name]) content.append(provider).append(1, '\n');
+        jar_file.others.emplace(name, std::vector<uint8_t>(content.begin(), content.end()));
+    }
+
+    for (const auto &source: sources) {
+        if (!source.manifest) continue;
+
+        auto manifest = Manifest::read_manifest(*source.manifest);
+        for (const auto &attribute: manifest.main_section().attributes) {
+            if (!jar_file.manifest.value(attribute.name)) jar_file.manifest.set(attribute.name, attribute.value);
+        }
+    }
+
+    return result;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "jar_signature.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <boost/algorithm/string.hpp>
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "parallel.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr std::string_view DIGEST_ATTRIBUTE = "SHA-256-Digest";
+
+// Any "<ALG>-Digest" attribute signs the entry, even if only SHA-256 digests are verified.
+auto has_digest(const Manifest::Section &section) -> bool {
+    return std::any_of(section.attributes.begin(), section.attributes.end(), [](const Manifest::Attribute &attribute) {
+        return attribute.name.size() > 7 && boost::algorithm::iends_with(attribute.name, "-Digest");
+    });
+}
+
+auto encode(const SHA256::Digest &digest) -> std::string {
+    return base64_encode(digest.data(), digest.size());
+}
+
+auto digest_entry(const JARFile &jar_file, const std::string &name) -> std::optional<std::string> {
+    if (auto class_file = jar_file.classes.find(name); class_file != jar_file.classes.end()) {
+        const auto &data = class_file->second.byte_code;
+        return encode(SHA256::digest(data.data(), data.size()));
+    }
+
+    if (!jar_file.others.contains(name) && !jar_file.streamed.contains(name)) return std::nullopt;
+
+    SHA256 sha256;
+    jar_file.read_entry(name, [&](const uint8_t *data, size_t size) {
+        sha256.update(data, size);
+    });
+    return encode(sha256.finish());
+}
+
+// Checks the manifest against one signature file, whose sections digest the sections of the manifest.
+void verify_signature_file(const std::string &name, const Manifest &manifest, const Manifest &signature_file,
+                           std::vector<JARSignature::Issue> &issues) {
+    // A matching digest over the whole manifest makes the section digests redundant.
+    if (auto whole = signature_file.value("SHA-256-Digest-Manifest")) {
+        if (*whole == encode(SHA256::digest(manifest.content()))) return;
+    }
+
+    if (auto main = signature_file.value("SHA-256-Digest-Manifest-Main-Attributes")) {
+        if (*main != encode(SHA256::digest(manifest.main_section().raw))) {
+            issues.push_back({name, "The digest of the main manifest attributes doesn't match."});
+        }
+    }
+
+    const auto &sections = signature_file.sections();
+    for (size_t index = 1; index < sections.size(); index++) {
+        auto entry = sections[index].name();
+        const auto *expected = sections[index].find(DIGEST_ATTRIBUTE);
+        if (entry.empty() || !expected) continue;
+
+        const auto *section = manifest.entry(entry);
+        if (!section) {
+            issues.push_back({name, "The manifest has no section for " + std::string(entry) + "."});
+        } else if (expected->value != encode(SHA256::digest(section->raw))) {
+            issues.push_back({name, "The digest of the manifest section for " + std::string(entry) + " doesn't match."});
+        }
+    }
+}
+
+} // namespace
+
+auto JARSignature::verify(const JARFile &jar_file, unsigned int thread_count) -> std::vector<Issue> {
+    const auto &manifest = jar_file.manifest;
+
+    std::vector<std::string> signature_files;
+    for (const auto &[name, data]: jar_file.others) {
+        if (boost::algorithm::istarts_with(name, "META-INF/") && boost::algorithm::iends_with(name, ".SF")
+            && name.find('/', 9) == std::string::npos) {
+            signature_files.push_back(name);
+        }
+    }
+
+    const auto &sections = manifest.sections();
+    std::vector<std::optional<Issue>> results(sections.size());
+
+    parallel_for(sections.size(), [&](size_t index) {
+        if (index == 0) return;
+
+        auto entry = std::string(sections[index].name());
+        const auto *expected = sections[index].find(DIGEST_ATTRIBUTE);
+        if (entry.empty() || !expected) return;
+
+        auto digest = digest_entry(jar_file, entry);
+        if (!digest) {
+            results[index] = Issue{entry, "The entry listed in the manifest is missing."};
+        } else if (*digest != expected->value) {
+            results[index] = Issue{entry, "The SHA-256 digest doesn't match the manifest."};
+        }
+    }, thread_count);
+
+    std::vector<Issue> issues;
+    for (auto &result: results) {
+        if (result) issues.push_back(std::move(*result));
+    }
+
+    for (const auto &name: signature_files) {
+        const auto &data = jar_file.others.at(name);
+        auto signature_file = Manifest::read_manifest(std::string(data.begin(), data.end()));
+        verify_signature_file(name, manifest, signature_file, issues);
+    }
+
+    // Entries added after signing have no digest at all.
+    if (!signature_files.empty()) {
+        auto check_covered = [&](const std::string &name) {
+            const auto *section = manifest.entry(name);
+            if (!is_signature_file(name) && (!section || !has_digest(*section))) {
+                issues.push_back({name, "The entry is not covered by the signature."});
+            }
+        };
+
+        for (const auto &entry: jar_file.classes) check_covered(entry.first);
+        for (const auto &entry: jar_file.others) check_covered(entry.first);
+        for (const auto &entry: jar_file.streamed) check_covered(entry.first);
+    }
+
+    std::sort(issues.begin(), issues.end());
+    return issues;
+}
+
+auto JARSignature::is_signature_file(const std::string &name) -> bool {
+    if (!boost::algorithm::istarts_with(name, "META-INF/") || name.find('/', 9) != std::string::npos) return false;
+
+    auto file_name = name.substr(9);
+    if (boost::algorithm::iequals(file_name, "MANIFEST.MF") || boost::algorithm::istarts_with(file_name, "SIG-")) {
+        return true;
+    }
+
+    return boost::algorithm::iends_with(file_name, ".SF") || boost::algorithm::iends_with(file_name, ".RSA")
+           || boost::algorithm::iends_with(file_name, ".DSA") || boost::algorithm::iends_with(file_name, ".EC");
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "parse_cache.h"
+
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "zip_reader.h"
+#include "binary_io.h"
+#include "utils.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x43505241; // "ARPC"
+constexpr uint16_t CACHE_VERSION = 1;
+constexpr size_t HEADER_SIZE = 28;
+
+void add_descriptor_classes(std::string_view descriptor, std::vector<std::string> &classes) {
+    for (size_t index = 0; index < descriptor.size(); index++) {
+        if (descriptor[index] != 'L') continue;
+
+        auto end = descriptor.find(';', index);
+        if (end == std::string_view::npos) return;
+
+        classes.emplace_back(descriptor.substr(index + 1, end - index - 1));
+        index = end;
+    }
+}
+
+void write_member(BinaryWriter &writer, const ClassSummary::Member &member) {
+    writer.write_u16(member.access_flags);
+    writer.write_string16(member.name);
+    writer.write_string16(member.descriptor);
+}
+
+auto read_member(BinaryReader &reader, ClassSummary::Member &member) -> bool {
+    return reader.read_u16(member.access_flags) && reader.read_string16(member.name)
+           && reader.read_string16(member.descriptor);
+}
+
+} // namespace
+
+auto ClassSummary::from_class(const ClassFile &class_file) -> ClassSummary {
+    ClassSummary summary;
+    summary.access_flags = class_file.access_flags;
+    summary.name = class_file.class_name(class_file.this_class);
+    summary.super_name = class_file.class_name(class_file.super_class);
+
+    for (auto interface: class_file.interfaces) {
+        summary.interfaces.emplace_back(class_file.class_name(interface));
+    }
+
+    for (const auto &field_info: class_file.fields) {
+        summary.fields.push_back({field_info.access_flags, std::string(class_file.utf8(field_info.name_index)),
+                                  std::string(class_file.utf8(field_info.descriptor_index))});
+        add_descriptor_classes(summary.fields.back().descriptor, summary.referenced_classes);
+    }
+
+    for (const auto &method_info: class_file.methods) {
+        summary.methods.push_back({method_info.access_flags, std::string(class_file.utf8(method_info.name_index)),
+                                   std::string(class_file.utf8(method_info.descriptor_index))});
+        add_descriptor_classes(summary.methods.back().descriptor, summary.referenced_classes);
+    }
+
+    for (const auto &info: class_file.constant_pool) {
+        if (info.tag == ConstantPoolInfo::CLASS) {
+            auto name = class_file.utf8(info.info.class_info.name_index);
+            if (name.starts_with('[')) {
+                add_descriptor_classes(name, summary.referenced_classes);
+            } else if (!name.empty()) {
+                summary.referenced_classes.emplace_back(name);
+            }
+        } else if (info.tag == ConstantPoolInfo::NAME_AND_TYPE) {
+            add_descriptor_classes(class_file.utf8(info.info.name_and_type_info.descriptor_index),
+                                   summary.referenced_classes);
+        } else if (info.tag == ConstantPoolInfo::METHOD_TYPE) {
+            add_descriptor_classes(class_file.utf8(info.info.method_type_info.descriptor_index),
+                                   summary.referenced_classes);
+        }
+    }
+
+    auto &referenced = summary.referenced_classes;
+    std::sort(referenced.begin(), referenced.end());
+    referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+    std::erase(referenced, summary.name);
+
+    return summary;
+}
+
+ParseCache::ParseCache(std::string directory) : _directory(std::move(directory)) {
+    std::filesystem::create_directories(_directory);
+}
+
+auto ParseCache::key_of(const std::vector<uint8_t> &data) -> uint64_t {
+    return hash64(data.data(), data.size());
+}
+
+auto ParseCache::key_of(uint32_t crc, uint64_t size) -> uint64_t {
+    uint8_t bytes[12];
+    for (int index = 0; index < 4; index++) bytes[index] = (crc >> (index * 8)) & 0xFF;
+    for (int index = 0; index < 8; index++) bytes[4 + index] = (size >> (index * 8)) & 0xFF;
+
+    // A different seed keeps these keys apart from the ones computed over the content.
+    return hash64(bytes, sizeof(bytes), 0x5A49502D43524331ULL);
+}
+
+auto ParseCache::lookup(uint64_t key) const -> std::optional<ClassSummary> {
+    auto path = _path_of(key);
+
+    auto file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0) return std::nullopt;
+
+    struct stat stat{};
+    if (fstat(file_descriptor, &stat) != 0 || static_cast<size_t>(stat.st_size) < HEADER_SIZE) {
+        close(file_descriptor);
+        return std::nullopt;
+    }
+
+    auto size = static_cast<size_t>(stat.st_size);
+    auto *memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+
+    if (memory == MAP_FAILED) return std::nullopt;
+
+    const auto *data = static_cast<const uint8_t *>(memory);
+    BinaryReader header(data, HEADER_SIZE);
+
+    uint32_t magic{}, payload_size{};
+    uint16_t version{};
+    uint64_t stored_key{}, checksum{};
+    ClassSummary summary;
+
+    auto valid = header.read_u32(magic) && header.read_u16(version) && header.read_u16(summary.access_flags)
+                 && header.read_u64(stored_key) && header.read_u64(checksum) && header.read_u32(payload_size)
+                 && magic == CACHE_MAGIC && version == CACHE_VERSION && stored_key == key
+                 && payload_size == size - HEADER_SIZE
+                 && hash64(data + HEADER_SIZE, payload_size) == checksum;
+
+    if (valid) {
+        BinaryReader reader(data + HEADER_SIZE, payload_size);
+        valid = reader.read_string16(summary.name) && reader.read_string16(summary.super_name);
+
+        uint16_t count{};
+        valid = valid && reader.read_u16(count);
+        summary.interfaces.resize(valid ? count : 0);
+        for (auto &interface: summary.interfaces) valid = valid && reader.read_string16(interface);
+
+        valid = valid && reader.read_u16(count);
+        summary.fields.resize(valid ? count : 0);
+        for (auto &field: summary.fields) valid = valid && read_member(reader, field);
+
+        valid = valid && reader.read_u16(count);
+        summary.methods.resize(valid ? count : 0);
+        for (auto &method: summary.methods) valid = valid && read_member(reader, method);
+
+        uint32_t referenced_count{};
+        valid = valid && reader.read_u32(referenced_count) && referenced_count <= payload_size;
+        summary.referenced_classes.resize(valid ? referenced_count : 0);
+        for (auto &referenced: summary.referenced_classes) valid = valid && reader.read_string16(referenced);
+
+        valid = valid && reader.at_end();
+    }
+
+    munmap(memory, size);
+
+    if (!valid) return std::nullopt;
+    return summary;
+}
+
+void ParseCache::store(uint64_t key, const ClassSummary &summary) const {
+    BinaryWriter payload;
+    payload.write_string16(summary.name);
+    payload.write_string16(summary.super_name);
+
+    payload.write_u16(static_cast<uint16_t>(summary.interfaces.size()));
+    for (const auto &interface: summary.interfaces) payload.write_string16(interface);
+
+    payload.write_u16(static_cast<uint16_t>(summary.fields.size()));
+    for (const auto &field: summary.fields) write_member(payload, field);
+
+    payload.write_u16(static_cast<uint16_t>(summary.methods.size()));
+    for (const auto &method: summary.methods) write_member(payload, method);
+
+    payload.write_u32(static_cast<uint32_t>(summary.referenced_classes.size()));
+    for (const auto &referenced: summary.referenced_classes) payload.write_string16(referenced);
+
+    auto &payload_bytes = payload.bytes();
+
+    BinaryWriter header;
+    header.write_u32(CACHE_MAGIC);
+    header.write_u16(CACHE_VERSION);
+    header.write_u16(summary.access_flags);
+    header.write_u64(key);
+    header.write_u64(hash64(payload_bytes.data(), payload_bytes.size()));
+    header.write_u32(static_cast<uint32_t>(payload_bytes.size()));
+
+    auto path = _path_of(key);
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+
+    write_file_atomically(path, {header.bytes(), payload_bytes}, "cache entry");
+}
+
+auto ParseCache::summarize_jar(const std::string &path) const -> std::unordered_map<std::string, ClassSummary> {
+    zip_t *zip = open_zip(path);
+    std::unordered_map<std::string, ClassSummary> summaries;
+
+    try {
+        for (auto &entry: read_directory(zip)) {
+            if (!boost::algorithm::iends_with(entry.name, ".class")) continue;
+
+            auto key = entry.crc ? key_of(*entry.crc, entry.size) : 0;
+            if (entry.crc) {
+                if (auto summary = lookup(key)) {
+                    summaries.emplace(std::move(entry.name), std::move(*summary));
+                    continue;
+                }
+            }
+
+            auto data = read_entry(zip, entry, path);
+
+            if (!entry.crc) {
+                key = key_of(data);
+                if (auto summary = lookup(key)) {
+                    summaries.emplace(std::move(entry.name), std::move(*summary));
+                    continue;
+                }
+            }
+
+            auto summary = ClassSummary::from_class(JARFile::read_class(std::move(data)));
+
+            // The cache only saves work, a directory that can't be written to doesn't fail the summary.
+            try {
+                store(key, summary);
+            } catch (const std::exception &) {}
+
+            summaries.emplace(std::move(entry.name), std::move(summary));
+        }
+    } catch (...) {
+        zip_discard(zip);
+        throw;
+    }
+
+    zip_discard(zip);
+
+    return summaries;
+}
+
+auto ParseCache::_path_of(uint64_t key) const -> std::string {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+    // Entries are spread over 256 sub directories to keep the directories small.
+    return (std::filesystem::path(_directory) / std::string(name, 2) / (std::string(name) + ".summary")).string();
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,890 @@
+#include "remapper.h"
+
+#include <unordered_set>
+#include <stdexcept>
+#include <algorithm>
+#include <optional>
+#include <cctype>
+#include <array>
+#include <mutex>
+#include <map>
+
+#include "constant_pool_compactor.h"
+#include "annotation_walker.h"
+#include "signature_walker.h"
+#include "bootstrap_methods.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "class_writer.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "parallel.h"
+#include "bytecode.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+// The kinds of UTF-8 constants that are rewritten, every kind maps the same input to the same output.
+enum Role : char {
+    CLASS_NAME = 'C',
+    DESCRIPTOR = 'D',
+    SIGNATURE = 'S',
+    LITERAL = 'L',
+};
+
+auto internal_name(std::string_view name) -> std::string {
+    std::string result(name);
+    std::replace(result.begin(), result.end(), '.', '/');
+    return result;
+}
+
+using Renames = std::vector<std::pair<std::string, std::string>>;
+
+// Throws if a renamed entry would replace one that keeps its name, or two entries would get the same name. Classes,
+// loaded and streamed entries share the names of the archive, so they are checked together. It runs before anything
+// is changed, so that a failed rename leaves the JAR as it was.
+void check_renames(const JARFile &jar_file, std::initializer_list<const Renames *> renames) {
+    std::unordered_set<std::string_view> old_names, new_names;
+    for (const auto *entries: renames) {
+        for (const auto &rename: *entries) old_names.insert(rename.first);
+    }
+
+    for (const auto *entries: renames) {
+        for (const auto &[old_name, new_name]: *entries) {
+            auto taken = jar_file.classes.contains(new_name) || jar_file.others.contains(new_name)
+                         || jar_file.streamed.contains(new_name);
+            if (new_names.insert(new_name).second && (!taken || old_names.contains(new_name))) continue;
+
+            throw std::runtime_error("Warning: Couldn't rename an entry to " + new_name
+                                     + " because the JAR already has one with that name.");
+        }
+    }
+}
+
+// All renamed entries are taken out before any is put back, so that entries may take over the names of each other.
+template<typename Map>
+void rename_entries(Map &map, const Renames &renames) {
+    std::vector<typename Map::node_type> nodes;
+    nodes.reserve(renames.size());
+    for (const auto &[old_name, new_name]: renames) {
+        auto &node = nodes.emplace_back(map.extract(old_name));
+        node.key() = new_name;
+    }
+
+    for (auto &node: nodes) map.insert(std::move(node));
+}
+
+// Appends the descriptor of a Java type like "java.lang.String[]".
+auto append_type_descriptor(std::string_view type, std::string &output) -> bool {
+    type = trim(type);
+    while (type.ends_with("[]")) {
+        output.push_back('[');
+        type.remove_suffix(2);
+    }
+
+    static constexpr std::pair<std::string_view, char> PRIMITIVES[] = {
+            {"boolean", 'Z'}, {"byte", 'B'}, {"char", 'C'}, {"short", 'S'}, {"int", 'I'}, {"long", 'J'},
+            {"float", 'F'}, {"double", 'D'}, {"void", 'V'}};
+
+    for (const auto &[name, kind]: PRIMITIVES) {
+        if (type != name) continue;
+        output.push_back(kind);
+        return true;
+    }
+
+    if (type.empty()) return false;
+    output.append(1, 'L').append(internal_name(type)).append(1, ';');
+    return true;
+}
+
+auto member_key(std::string_view owner, std::string_view name, std::string_view descriptor,
+                bool method) -> std::string {
+    std::string key;
+    key.reserve(owner.size() + name.size() + descriptor.size() + 2);
+    key.append(owner).append(1, '.').append(name);
+    if (!method) key.push_back(':');
+    key.append(descriptor);
+    return key;
+}
+
+// The rewritten UTF-8 constants of all classes. Every distinct input is mapped once and its bytes are shared by the
+// classes that contain it.
+class Utf8Table {
+public:
+    using Buffer = std::shared_ptr<std::vector<uint8_t>>;
+
+    // Returns nullptr if the value stays the same.
+    template<typename Function>
+    auto get(Role role, std::string_view value, Function &&function) -> Buffer {
+        Key key{role, value};
+        auto &shard = _shards[KeyHash{}(key) % SHARD_COUNT];
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto found = shard.values.find(key);
+            if (found != shard.values.end()) return found->second;
+        }
+
+        std::string output;
+        Buffer buffer;
+        if (function(value, output)) buffer = std::make_shared<std::vector<uint8_t>>(output.begin(), output.end());
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.values.try_emplace(key, std::move(buffer)).first->second;
+    }
+
+private:
+    static constexpr size_t SHARD_COUNT = 64;
+
+    struct Key {
+        Role role{};
+        std::string_view value{};
+
+        auto operator==(const Key &other) const -> bool = default;
+    };
+
+    struct KeyHash {
+        auto operator()(const Key &key) const -> size_t {
+            return hash64(key.value, static_cast<uint64_t>(key.role));
+        }
+    };
+
+    struct Shard {
+        std::mutex mutex{};
+        std::unordered_map<Key, Buffer, KeyHash> values{};
+    };
+
+    std::array<Shard, SHARD_COUNT> _shards{};
+};
+
+using Supertypes = std::unordered_map<std::string_view, std::vector<std::string_view>>;
+
+// Remaps one class. UTF-8 constants are never changed in place, since the same one may serve as a class name and as
+// a string. Whatever is rewritten points to new constants instead, and the ones left over are compacted away.
+class ClassRemapper {
+public:
+    ClassRemapper(const Remapper &remapper, const Supertypes &supertypes, Utf8Table &table, ClassFile &class_file)
+            : _remapper(remapper), _supertypes(supertypes), _table(table), _class_file(class_file) {}
+
+    void run() {
+        auto &pool = _class_file.constant_pool;
+        auto pool_size = static_cast<uint16_t>(pool.size());
+        auto this_name = _class_file.class_name(_class_file.this_class);
+
+        // The planned name and descriptor of the NAME_AND_TYPE of every member reference and dynamic constant.
+        std::vector<std::pair<uint16_t, std::pair<uint16_t, uint16_t>>> planned;
+        std::optional<BootstrapMethods> bootstrap_methods;
+
+        for (uint16_t index = 1; index <= pool_size; index++) {
+            auto tag = pool[index - 1].tag;
+            if (tag == ConstantPoolInfo::FIELD_REF || tag == ConstantPoolInfo::METHOD_REF
+                || tag == ConstantPoolInfo::INTERFACE_METHOD_REF) {
+                const auto &info = pool[index - 1].info.field_method_info;
+                auto owner = _class_file.class_name(info.class_index);
+                planned.emplace_back(index, _plan(owner, info.name_and_type_index,
+                                                  tag != ConstantPoolInfo::FIELD_REF));
+            } else if (tag == ConstantPoolInfo::INVOKE_DYNAMIC) {
+                if (!bootstrap_methods) bootstrap_methods = BootstrapMethods::read(_class_file);
+                planned.emplace_back(index, _plan_lambda(index, *bootstrap_methods));
+            } else if (tag == ConstantPoolInfo::DYNAMIC) {
+                planned.emplace_back(index, _plan({}, pool[index - 1].info.dynamic_info.name_and_type_index, false));
+            }
+        }
+
+        // A NAME_AND_TYPE shared by references that are renamed differently is split up.
+        _claims.assign(pool_size + 1, {0, 0});
+        for (const auto &[index, name_and_type]: planned) {
+            auto tag = pool[index - 1].tag;
+            auto dynamic = tag == ConstantPoolInfo::INVOKE_DYNAMIC || tag == ConstantPoolInfo::DYNAMIC;
+            auto name_and_type_index = dynamic ? pool[index - 1].info.dynamic_info.name_and_type_index
+                                               : pool[index - 1].info.field_method_info.name_and_type_index;
+
+            // Claiming may append constants, which moves the pool.
+            auto new_index = _claim(name_and_type_index, name_and_type);
+            if (dynamic) {
+                pool[index - 1].info.dynamic_info.name_and_type_index = new_index;
+            } else {
+                pool[index - 1].info.field_method_info.name_and_type_index = new_index;
+            }
+        }
+
+        // The method of EnclosingMethod refers to a NAME_AND_TYPE directly.
+        for (auto &attribute_info: _class_file.attributes) {
+            if (_class_file.utf8(attribute_info.attribute_name_index) != "EnclosingMethod"
+                || attribute_info.attribute_length != 4) {
+                continue;
+            }
+
+            std::span<const uint8_t> data(attribute_info.info, attribute_info.attribute_length);
+            auto method_index = Bytecode::read_u16(data, 2);
+            if (method_index == 0) continue;
+
+            auto owner = _class_file.class_name(Bytecode::read_u16(data, 0));
+            auto new_index = _claim(method_index, _plan(owner, method_index, true));
+            if (new_index == method_index) continue;
+
+            auto &copy = _class_file.owned_data.emplace_back(
+                    std::make_shared<std::vector<uint8_t>>(data.begin(), data.end()));
+            (*copy)[2] = new_index >> 8;
+            (*copy)[3] = new_index & 0xFF;
+            attribute_info.info = copy->data();
+        }
+
+        for (uint16_t index = 1; index <= pool_size; index++) {
+            auto tag = pool[index - 1].tag;
+            if (tag == ConstantPoolInfo::NAME_AND_TYPE && _claims[index].first == 0) {
+                _claim(index, {pool[index - 1].info.name_and_type_info.name_index,
+                               _utf8(DESCRIPTOR, pool[index - 1].info.name_and_type_info.descriptor_index)});
+            }
+        }
+
+        for (uint16_t index = 1; index <= pool_size; index++) {
+            auto &info = pool[index - 1];
+            if (info.tag == ConstantPoolInfo::NAME_AND_TYPE) {
+                info.info.name_and_type_info.name_index = _claims[index].first;
+                info.info.name_and_type_info.descriptor_index = _claims[index].second;
+            }
+        }
+
+        for (uint16_t index = 1; index <= pool_size; index++) {
+            auto tag = pool[index - 1].tag;
+            if (tag == ConstantPoolInfo::CLASS) {
+                auto name_index = pool[index - 1].info.class_info.name_index;
+                auto role = _class_file.utf8(name_index).starts_with('[') ? DESCRIPTOR : CLASS_NAME;
+                auto new_index = _utf8(role, name_index);
+                pool[index - 1].info.class_info.name_index = new_index;
+            } else if (tag == ConstantPoolInfo::METHOD_TYPE) {
+                auto new_index = _utf8(DESCRIPTOR, pool[index - 1].info.method_type_info.descriptor_index);
+                pool[index - 1].info.method_type_info.descriptor_index = new_index;
+            }
+        }
+
+        for (auto &field_info: _class_file.fields) {
+            _remap_member(this_name, field_info.name_index, field_info.descriptor_index, false);
+            for (auto &attribute_info: field_info.attributes) {
+                // Copies of the class share the attributes of fields, so rewritten ones are replaced instead.
+                attribute_info = std::make_shared<AttributeInfo>(*attribute_info);
+                _remap_attribute(*attribute_info);
+            }
+        }
+
+        for (auto &method_info: _class_file.methods) {
+            _remap_member(this_name, method_info.name_index, method_info.descriptor_index, true);
+            for (auto &attribute_info: method_info.attributes) _remap_attribute(attribute_info);
+        }
+
+        for (auto &attribute_info: _class_file.attributes) _remap_attribute(attribute_info);
+
+        if (ConstantPoolCompactor::compact(_class_file) == 0) ClassWriter::update_byte_code(_class_file);
+    }
+
+private:
+    // Resolves a member along the supertypes of its owner.
+    auto _resolve(std::string_view owner, std::string_view name, std::string_view descriptor,
+                  bool method) const -> std::string_view {
+        std::vector<std::string_view> pending{owner};
+        for (size_t index = 0; index < pending.size() && index < 1024; index++) {
+            auto new_name = _remapper.map_member(pending[index], name, descriptor, method);
+            if (!new_name.empty()) return new_name;
+
+            auto found = _supertypes.find(pending[index]);
+            if (found == _supertypes.end()) continue;
+            for (auto supertype: found->second) {
+                if (std::find(pending.begin(), pending.end(), supertype) == pending.end()) pending.push_back(supertype);
+            }
+        }
+        return {};
+    }
+
+    auto _plan(std::string_view owner, uint16_t name_and_type_index,
+               bool method) -> std::pair<uint16_t, uint16_t> {
+        if (!_class_file.is_valid_index(name_and_type_index)
+            || _class_file.constant_pool[name_and_type_index - 1].tag != ConstantPoolInfo::NAME_AND_TYPE) {
+            return {0, 0};
+        }
+
+        auto info = _class_file.constant_pool[name_and_type_index - 1].info.name_and_type_info;
+        auto new_name = owner.empty() || owner.starts_with('[')
+                        ? std::string_view()
+                        : _resolve(owner, _class_file.utf8(info.name_index), _class_file.utf8(info.descriptor_index),
+                                   method);
+
+        auto name_index = new_name.empty() ? info.name_index : _literal(new_name);
+        return {name_index, _utf8(DESCRIPTOR, info.descriptor_index)};
+    }
+
+    // The name of an invokedynamic is the method a lambda implements, which is renamed along with its interface.
+    // The interface is the return type, the erased method type the first bootstrap argument.
+    auto _plan_lambda(uint16_t index, const std::optional<BootstrapMethods> &bootstrap_methods)
+    -> std::pair<uint16_t, uint16_t> {
+        auto name_and_type_index = _class_file.constant_pool[index - 1].info.dynamic_info.name_and_type_index;
+        auto plan = _plan({}, name_and_type_index, true);
+        if (plan.first == 0 || !bootstrap_methods) return plan;
+
+        auto bootstrap_method = bootstrap_methods->of_constant(_class_file, index);
+        if (!bootstrap_method || bootstrap_method->arguments.empty()) return plan;
+
+        auto argument = bootstrap_method->arguments[0];
+        if (!_class_file.is_valid_index(argument)
+            || _class_file.constant_pool[argument - 1].tag != ConstantPoolInfo::METHOD_TYPE) {
+            return plan;
+        }
+
+        const auto &name_and_type = _class_file.constant_pool[name_and_type_index - 1].info.name_and_type_info;
+        auto descriptor = _class_file.utf8(name_and_type.descriptor_index);
+        auto return_type = descriptor.substr(std::min(descriptor.size(), descriptor.find(')') + 1));
+        if (!return_type.starts_with('L') || !return_type.ends_with(';')) return plan;
+
+        auto method_descriptor = _class_file.utf8(
+                _class_file.constant_pool[argument - 1].info.method_type_info.descriptor_index);
+        auto new_name = _resolve(return_type.substr(1, return_type.size() - 2),
+                                 _class_file.utf8(name_and_type.name_index), method_descriptor, true);
+        if (!new_name.empty()) plan.first = _literal(new_name);
+        return plan;
+    }
+
+    // Returns the NAME_AND_TYPE to use for the planned name and descriptor, the original one if it is free.
+    auto _claim(uint16_t index, std::pair<uint16_t, uint16_t> name_and_type) -> uint16_t {
+        if (index >= _claims.size() || name_and_type.first == 0) return index;
+
+        if (_claims[index].first == 0) {
+            _claims[index] = name_and_type;
+            return index;
+        }
+        if (_claims[index] == name_and_type) return index;
+
+        auto [found, inserted] = _split_name_and_types.try_emplace(name_and_type, 0);
+        if (inserted) {
+            ConstantPoolInfo info;
+            info.tag = ConstantPoolInfo::NAME_AND_TYPE;
+            info.info.name_and_type_info = {name_and_type.first, name_and_type.second};
+            found->second = _append(info);
+        }
+        return found->second;
+    }
+
+    void _remap_member(std::string_view owner, uint16_t &name_index, uint16_t &descriptor_index, bool method) {
+        auto new_name = _remapper.map_member(owner, _class_file.utf8(name_index), _class_file.utf8(descriptor_index),
+                                             method);
+        if (!new_name.empty()) name_index = _literal(new_name);
+        descriptor_index = _utf8(DESCRIPTOR, descriptor_index);
+    }
+
+    // Rewrites the UTF-8 indices of the attributes that hold class names, copying the data before the first change.
+    void _remap_attribute(AttributeInfo &attribute_info) {
+        std::shared_ptr<std::vector<uint8_t>> copy;
+        std::span<const uint8_t> data(attribute_info.info, attribute_info.attribute_length);
+
+        auto patch = [&](size_t offset, Role role) {
+            if (offset + 2 > data.size()) return;
+
+            auto index = Bytecode::read_u16(data, offset);
+            auto new_index = _utf8(role, index);
+            if (new_index == index) return;
+
+            if (!copy) {
+                copy = std::make_shared<std::vector<uint8_t>>(data.begin(), data.end());
+                data = *copy;
+            }
+            (*copy)[offset] = new_index >> 8;
+            (*copy)[offset + 1] = new_index & 0xFF;
+        };
+
+        _remap_attribute_data(_class_file.utf8(attribute_info.attribute_name_index), data, 0, patch);
+
+        if (copy) {
+            attribute_info.info = copy->data();
+            _class_file.owned_data.push_back(std::move(copy));
+        }
+    }
+
+    template<typename Patch>
+    void _remap_attribute_data(std::string_view name, std::span<const uint8_t> data, size_t base, Patch &patch) {
+        if (name == "Signature") {
+            patch(base, SIGNATURE);
+        } else if (name == "LocalVariableTable" || name == "LocalVariableTypeTable") {
+            if (data.size() < 2) return;
+            auto count = Bytecode::read_u16(data, 0);
+            for (size_t entry = 0; entry < count && 2 + entry * 10 + 10 <= data.size(); entry++) {
+                patch(base + 2 + entry * 10 + 6, name == "LocalVariableTable" ? DESCRIPTOR : SIGNATURE);
+            }
+        } else if (name == "Code") {
+            AttributeInfo attribute_info;
+            attribute_info.attribute_length = static_cast<uint32_t>(data.size());
+            attribute_info.info = const_cast<uint8_t *>(data.data());
+
+            auto code = CodeAttribute::read(attribute_info);
+            if (!code) return;
+
+            for (const auto &attribute: code->attributes) {
+                _remap_attribute_data(_class_file.utf8(attribute.name_index), attribute.data,
+                                      base + (attribute.data.data() - data.data()), patch);
+            }
+        } else if (name == "Record") {
+            if (data.size() < 2) return;
+            auto count = Bytecode::read_u16(data, 0);
+            size_t offset = 2;
+
+            // Component descriptors, and the signatures and annotations among the attributes of the components.
+            for (size_t component = 0; component < count && offset + 6 <= data.size(); component++) {
+                patch(base + offset + 2, DESCRIPTOR);
+                auto attribute_count = Bytecode::read_u16(data, offset + 4);
+                offset += 6;
+
+                for (size_t attribute = 0; attribute < attribute_count && offset + 6 <= data.size(); attribute++) {
+                    auto length = static_cast<uint32_t>(Bytecode::read_s32(data, offset + 2));
+                    if (length > data.size() - offset - 6) return;
+
+                    _remap_attribute_data(_class_file.utf8(Bytecode::read_u16(data, offset)),
+                                          data.subspan(offset + 6, length), base + offset + 6, patch);
+                    offset += 6 + length;
+                }
+            }
+        } else if (AnnotationWalker::handles(name)) {
+            AnnotationWalker::walk(name, data, [&](size_t offset, AnnotationWalker::Index index) {
+                if (index == AnnotationWalker::TYPE || index == AnnotationWalker::CLASS
+                    || index == AnnotationWalker::ENUM_TYPE) {
+                    patch(base + offset, DESCRIPTOR);
+                }
+            });
+        }
+    }
+
+    // Returns the index of the UTF-8 constant in its remapped form.
+    auto _utf8(Role role, uint16_t index) -> uint16_t {
+        auto value = _class_file.utf8(index);
+        if (value.empty()) return index;
+
+        auto buffer = _table.get(role, value, [&](std::string_view input, std::string &output) {
+            switch (role) {
+                case CLASS_NAME:
+                    return _remapper.map_class(input, output);
+                case DESCRIPTOR:
+                    return _remapper.map_descriptor(input, output);
+                case SIGNATURE:
+                    return _remapper.map_signature(input, output);
+                default:
+                    return false;
+            }
+        });
+
+        return buffer ? _find_or_append(std::move(buffer)) : index;
+    }
+
+    auto _literal(std::string_view value) -> uint16_t {
+        auto buffer = _table.get(LITERAL, value, [](std::string_view input, std::string &output) {
+            output.assign(input);
+            return true;
+        });
+        return _find_or_append(std::move(buffer));
+    }
+
+    auto _find_or_append(Utf8Table::Buffer buffer) -> uint16_t {
+        if (!_indexed) {
+            for (uint16_t index = 1; index <= _class_file.constant_pool.size(); index++) {
+                auto value = _class_file.utf8(index);
+                if (_class_file.constant_pool[index - 1].tag == ConstantPoolInfo::UTF_8) _utf8_indices.emplace(value, index);
+            }
+            _indexed = true;
+        }
+
+        std::string_view value(reinterpret_cast<const char *>(buffer->data()), buffer->size());
+        auto found = _utf8_indices.find(value);
+        if (found != _utf8_indices.end()) return found->second;
+
+        ConstantPoolInfo info;
+        info.tag = ConstantPoolInfo::UTF_8;
+        info.info.utf8_info.length = static_cast<uint16_t>(buffer->size());
+        info.info.utf8_info.bytes = buffer->data();
+
+        auto index = _append(info);
+        _utf8_indices.emplace(value, index);
+        _class_file.owned_data.push_back(std::move(buffer));
+        return index;
+    }
+
+    auto _append(const ConstantPoolInfo &info) -> uint16_t {
+        if (_class_file.constant_pool.size() + 1 >= UINT16_MAX) {
+            throw std::runtime_error("Warning: The constant pool of "
+                                     + std::string(_class_file.class_name(_class_file.this_class))
+                                     + " overflows while remapping.");
+        }
+
+        _class_file.constant_pool.push_back(info);
+        _class_file.constant_pool_count = static_cast<uint16_t>(_class_file.constant_pool.size() + 1);
+        return static_cast<uint16_t>(_class_file.constant_pool.size());
+    }
+
+private:
+    const Remapper &_remapper;
+    const Supertypes &_supertypes;
+    Utf8Table &_table;
+    ClassFile &_class_file;
+
+    bool _indexed{};
+    std::unordered_map<std::string_view, uint16_t> _utf8_indices{};
+    std::vector<std::pair<uint16_t, uint16_t>> _claims{};
+    std::map<std::pair<uint16_t, uint16_t>, uint16_t> _split_name_and_types{};
+};
+
+} // namespace
+
+auto Remapper::read_proguard(std::string_view mapping) -> Remapper {
+    Remapper remapper;
+    std::string_view current_class;
+    size_t line_number = 0;
+
+    while (!mapping.empty()) {
+        auto end = mapping.find('\n');
+        auto line = mapping.substr(0, end);
+        mapping = end == std::string_view::npos ? std::string_view() : mapping.substr(end + 1);
+        line_number++;
+
+        auto trimmed = trim(line);
+        if (trimmed.empty() || trimmed.starts_with('#')) continue;
+
+        auto malformed = [&]() {
+            return std::invalid_argument("Warning: Malformed mapping at line " + std::to_string(line_number) + ".");
+        };
+
+        auto arrow = trimmed.find(" -> ");
+        if (arrow == std::string_view::npos) throw malformed();
+
+        auto left = trim(trimmed.substr(0, arrow));
+        auto right = trim(trimmed.substr(arrow + 4));
+
+        if (!std::isspace(static_cast<unsigned char>(line.front()))) {
+            if (!right.ends_with(':')) throw malformed();
+
+            auto name = internal_name(left);
+            remapper.add_class(name, internal_name(right.substr(0, right.size() - 1)));
+            current_class = remapper._classes.find(name)->first;
+            continue;
+        }
+
+        if (current_class.empty()) throw malformed();
+
+        // Line numbers like "12:14:" in front and ":12:14" behind the method.
+        while (!left.empty() && std::isdigit(static_cast<unsigned char>(left.front()))) {
+            auto colon = left.find(':');
+            if (colon == std::string_view::npos) throw malformed();
+            left.remove_prefix(colon + 1);
+        }
+        while (!left.empty() && std::isdigit(static_cast<unsigned char>(left.back()))) {
+            auto colon = left.rfind(':');
+            if (colon == std::string_view::npos) throw malformed();
+            left = left.substr(0, colon);
+        }
+
+        auto space = left.find(' ');
+        if (space == std::string_view::npos) throw malformed();
+
+        auto type = left.substr(0, space);
+        auto member = trim(left.substr(space + 1));
+        auto parenthesis = member.find('(');
+
+        std::string descriptor;
+        if (parenthesis == std::string_view::npos) {
+            if (!append_type_descriptor(type, descriptor)) throw malformed();
+            remapper.add_field(current_class, member, descriptor, right);
+            continue;
+        }
+
+        // Methods inlined from other classes carry their class name.
+        auto name = member.substr(0, parenthesis);
+        if (name.find('.') != std::string_view::npos) continue;
+
+        auto close = member.find(')', parenthesis);
+        if (close == std::string_view::npos) throw malformed();
+
+        descriptor.push_back('(');
+        auto arguments = member.substr(parenthesis + 1, close - parenthesis - 1);
+        while (!trim(arguments).empty()) {
+            auto comma = arguments.find(',');
+            if (!append_type_descriptor(arguments.substr(0, comma), descriptor)) throw malformed();
+            arguments = comma == std::string_view::npos ? std::string_view() : arguments.substr(comma + 1);
+        }
+        descriptor.push_back(')');
+        if (!append_type_descriptor(type, descriptor)) throw malformed();
+
+        remapper.add_method(current_class, name, descriptor, right);
+    }
+
+    return remapper;
+}
+
+void Remapper::add_class(std::string_view name, std::string_view new_name) {
+    _classes.insert_or_assign(_store(std::string(name)), _store(std::string(new_name)));
+}
+
+void Remapper::add_field(std::string_view owner, std::string_view name, std::string_view descriptor,
+                         std::string_view new_name) {
+    _members.insert_or_assign(_store(member_key(owner, name, descriptor, false)), _store(std::string(new_name)));
+}
+
+void Remapper::add_method(std::string_view owner, std::string_view name, std::string_view descriptor,
+                          std::string_view new_name) {
+    _members.insert_or_assign(_store(member_key(owner, name, descriptor, true)), _store(std::string(new_name)));
+}
+
+void Remapper::add_relocation(std::string_view prefix, std::string_view new_prefix) {
+    _relocations.emplace_back(_store(std::string(prefix)), _store(std::string(new_prefix)));
+    std::stable_sort(_relocations.begin(), _relocations.end(), [](const auto &first, const auto &second) {
+        return first.first.size() > second.first.size();
+    });
+}
+
+auto Remapper::map_class(std::string_view name) const -> std::string {
+    std::string output;
+    return map_class(name, output) ? output : std::string(name);
+}
+
+auto Remapper::map_descriptor(std::string_view descriptor) const -> std::string {
+    std::string output;
+    return map_descriptor(descriptor, output) ? output : std::string(descriptor);
+}
+
+auto Remapper::map_signature(std::string_view signature) const -> std::string {
+    std::string output;
+    return map_signature(signature, output) ? output : std::string(signature);
+}
+
+auto Remapper::map_class(std::string_view name, std::string &output) const -> bool {
+    if (name.starts_with('[')) return map_descriptor(name, output);
+
+    auto found = _classes.find(name);
+    if (found != _classes.end()) {
+        if (found->second == name) return false;
+        output.append(found->second);
+        return true;
+    }
+
+    for (const auto &[prefix, new_prefix]: _relocations) {
+        if (!name.starts_with(prefix)) continue;
+        output.append(new_prefix).append(name.substr(prefix.size()));
+        return true;
+    }
+
+    return false;
+}
+
+auto Remapper::map_descriptor(std::string_view descriptor, std::string &output) const -> bool {
+    auto start = output.size();
+    size_t copied = 0;
+
+    for (size_t index = 0; index < descriptor.size(); index++) {
+        if (descriptor[index] != 'L') continue;
+
+        auto end = descriptor.find(';', index);
+        if (end == std::string_view::npos) break;
+
+        // The part up to the class name is only copied once the class turns out to be mapped.
+        auto mark = output.size();
+        output.append(descriptor.substr(copied, index + 1 - copied));
+        if (map_class(descriptor.substr(index + 1, end - index - 1), output)) {
+            copied = end;
+        } else {
+            output.resize(mark);
+        }
+        index = end;
+    }
+
+    if (copied == 0) {
+        output.resize(start);
+        return false;
+    }
+
+    output.append(descriptor.substr(copied));
+    return true;
+}
+
+auto Remapper::map_signature(std::string_view signature, std::string &output) const -> bool {
+    // Inner classes are looked up under their binary name, their simple name is only replaced if the mapping keeps
+    // them inside of the mapped outer class.
+    auto start = output.size();
+    size_t copied = 0;
+    auto changed = false;
+    std::string mapped_name;
+
+    auto replace = [&](size_t begin, size_t end, std::string_view value) {
+        output.append(signature.substr(copied, begin - copied)).append(value);
+        copied = end;
+        changed = true;
+    };
+
+    auto valid = SignatureWalker::walk(signature, [&](size_t begin, size_t end, std::string_view binary_name,
+                                                      bool inner) {
+        std::string mapped;
+        if (!inner) {
+            if (map_class(binary_name, mapped)) {
+                replace(begin, end, mapped);
+                mapped_name = std::move(mapped);
+            } else {
+                mapped_name = binary_name;
+            }
+            return;
+        }
+
+        auto simple_name = signature.substr(begin, end - begin);
+        if (map_class(binary_name, mapped) && mapped.size() > mapped_name.size() && mapped.starts_with(mapped_name)
+            && mapped[mapped_name.size()] == '$') {
+            replace(begin, end, std::string_view(mapped).substr(mapped_name.size() + 1));
+            mapped_name = std::move(mapped);
+        } else {
+            mapped_name.append(1, '$').append(simple_name);
+        }
+    });
+
+    if (!valid || !changed) {
+        output.resize(start);
+        return false;
+    }
+
+    output.append(signature.substr(copied));
+    return true;
+}
+
+auto Remapper::map_member(std::string_view owner, std::string_view name, std::string_view descriptor,
+                          bool method) const -> std::string_view {
+    if (_members.empty()) return {};
+
+    auto found = _members.find(member_key(owner, name, descriptor, method));
+    return found == _members.end() ? std::string_view() : found->second;
+}
+
+void Remapper::apply(JARFile &jar_file, unsigned int thread_count) const {
+    // The old names stay readable while the classes are rewritten, the bytes they point to aren't changed.
+    Supertypes supertypes;
+    std::vector<ClassFile *> classes;
+
+    // Entries like "META-INF/versions/9/a/B.class" keep their prefix.
+    Renames class_renames;
+
+    for (auto &[entry_name, class_file]: jar_file.classes) {
+        auto name = class_file.class_name(class_file.this_class);
+        auto &names = supertypes[name];
+        if (auto super_name = class_file.class_name(class_file.super_class); !super_name.empty()) {
+            names.push_back(super_name);
+        }
+        for (auto interface: class_file.interfaces) names.push_back(class_file.class_name(interface));
+
+        classes.push_back(&class_file);
+
+        std::string new_name;
+        if (!entry_name.ends_with(std::string(name) + ".class") || !map_class(name, new_name)) continue;
+        class_renames.emplace_back(entry_name, entry_name.substr(0, entry_name.size() - name.size() - 6)
+                                               + new_name + ".class");
+    }
+
+    // Service files are named after their service, and resources move with their relocated package, whether they are
+    // loaded or streamed.
+    auto plan_resource = [&](const std::string &entry_name, Renames &renames) {
+        if (entry_name.starts_with("META-INF/services/")) {
+            std::string mapped_service;
+            if (!map_class(internal_name(entry_name.substr(18)), mapped_service)) return;
+
+            std::replace(mapped_service.begin(), mapped_service.end(), '/', '.');
+            renames.emplace_back(entry_name, "META-INF/services/" + mapped_service);
+            return;
+        }
+
+        for (const auto &[prefix, new_prefix]: _relocations) {
+            if (!entry_name.starts_with(prefix)) continue;
+            renames.emplace_back(entry_name, std::string(new_prefix) + entry_name.substr(prefix.size()));
+            break;
+        }
+    };
+
+    Renames other_renames, streamed_renames;
+    for (const auto &item: jar_file.others) plan_resource(item.first, other_renames);
+    for (const auto &item: jar_file.streamed) plan_resource(item.first, streamed_renames);
+
+    check_renames(jar_file, {&class_renames, &other_renames, &streamed_renames});
+
+    Utf8Table table;
+    parallel_for(classes.size(), [&](size_t index) {
+        ClassRemapper(*this, supertypes, table, *classes[index]).run();
+    }, thread_count);
+
+    rename_entries(jar_file.classes, class_renames);
+
+    // The provider lines of the service files are mapped in place.
+    for (auto &[entry_name, data]: jar_file.others) {
+        if (!entry_name.starts_with("META-INF/services/")) continue;
+
+        std::string_view content(reinterpret_cast<const char *>(data.data()), data.size());
+        std::string new_content;
+        auto changed = false;
+
+        while (!content.empty()) {
+            auto end = content.find('\n');
+            auto line = content.substr(0, end == std::string_view::npos ? content.size() : end + 1);
+            content.remove_prefix(line.size());
+
+            auto provider = trim(line.substr(0, line.find('#')));
+            std::string mapped_provider;
+            if (!provider.empty() && map_class(internal_name(provider), mapped_provider)) {
+                std::replace(mapped_provider.begin(), mapped_provider.end(), '/', '.');
+                auto position = line.find(provider);
+                new_content.append(line.substr(0, position)).append(mapped_provider)
+                        .append(line.substr(position + provider.size()));
+                changed = true;
+            } else {
+                new_content.append(line);
+            }
+        }
+
+        if (changed) data.assign(new_content.begin(), new_content.end());
+    }
+
+    for (const auto &rename: other_renames) jar_file.invalidate_nested(rename.first);
+    for (const auto &rename: streamed_renames) jar_file.invalidate_nested(rename.first);
+    rename_entries(jar_file.others, other_renames);
+    rename_entries(jar_file.streamed, streamed_renames);
+
+    if (auto main_class = jar_file.manifest.value("Main-Class")) {
+        std::string mapped;
+        if (map_class(internal_name(*main_class), mapped)) {
+            std::replace(mapped.begin(), mapped.end(), '/', '.');
+            jar_file.manifest.set("Main-Class", mapped);
+        }
+    }
+}
+
+auto Remapper::_store(std::string value) -> std::string_view {
+    return _storage->emplace_back(std::move(value));
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
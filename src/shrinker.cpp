@@ -0,0 +1,709 @@
+#include "shrinker.h"
+
+#include <unordered_map>
+#include <string_view>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+#include <deque>
+
+#include "constant_pool_compactor.h"
+#include "annotation_walker.h"
+#include "signature_walker.h"
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "class_writer.h"
+#include "method_info.h"
+#include "visited_set.h"
+#include "field_info.h"
+#include "descriptor.h"
+#include "parallel.h"
+#include "bytecode.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr std::string_view OBJECT_METHODS[] = {"toString()Ljava/lang/String;", "equals(Ljava/lang/Object;)Z",
+                                               "hashCode()I", "finalize()V", "clone()Ljava/lang/Object;"};
+
+// Called by the serialization through reflection.
+constexpr std::string_view SERIALIZATION_MEMBERS[] = {"readObject", "writeObject", "readObjectNoData",
+                                                      "writeReplace", "readResolve", "serialVersionUID",
+                                                      "serialPersistentFields"};
+
+using MemberRef = ClassFile::MemberRef;
+
+// The symbolic references of the code of a method, or of the class outside of code.
+struct References {
+    std::vector<std::string_view> classes{};
+    std::vector<MemberRef> methods{};
+    std::vector<MemberRef> fields{};
+    std::vector<std::string_view> strings{};
+    // Binary names of inner classes in generic signatures, which the constant pool doesn't hold.
+    std::deque<std::string> inner_classes{};
+};
+
+struct ClassScan {
+    ClassFile *class_file{};
+    std::string_view name{};
+    std::vector<std::string_view> supertypes{};
+    References references{};
+    std::vector<References> methods{};
+    std::unordered_map<std::string, uint32_t> method_ids{};
+    std::unordered_map<std::string, uint32_t> field_ids{};
+};
+
+auto member_key(std::string_view name, std::string_view descriptor) -> std::string {
+    std::string key;
+    key.reserve(name.size() + descriptor.size());
+    key.append(name).append(descriptor);
+    return key;
+}
+
+void add_descriptor_classes(std::string_view descriptor, std::vector<std::string_view> &classes) {
+    auto parsed = Descriptor::parse(descriptor);
+    if (!parsed) return;
+    classes.insert(classes.end(), parsed->referenced_classes.begin(), parsed->referenced_classes.end());
+}
+
+void add_constant(const ClassFile &class_file, uint16_t index, References &references) {
+    if (!class_file.is_valid_index(index)) return;
+
+    const auto &info = class_file.constant_pool[index - 1];
+    switch (info.tag) {
+        case ConstantPoolInfo::CLASS: {
+            auto name = class_file.class_name(index);
+            if (name.starts_with('[')) {
+                add_descriptor_classes(name, references.classes);
+            } else if (!name.empty()) {
+                references.classes.push_back(name);
+            }
+            break;
+        }
+        case ConstantPoolInfo::FIELD_REF:
+        case ConstantPoolInfo::METHOD_REF:
+        case ConstantPoolInfo::INTERFACE_METHOD_REF: {
+            auto reference = class_file.member_ref(index);
+            if (!reference) break;
+
+            add_constant(class_file, info.info.field_method_info.class_index, references);
+            add_descriptor_classes(reference->descriptor, references.classes);
+            auto &members = info.tag == ConstantPoolInfo::FIELD_REF ? references.fields : references.methods;
+            members.push_back(*reference);
+            break;
+        }
+        case ConstantPoolInfo::STRING:
+            references.strings.push_back(class_file.utf8(info.info.string_info.string_index));
+            break;
+        case ConstantPoolInfo::METHOD_HANDLE:
+            add_constant(class_file, info.info.method_handle_info.reference_index, references);
+            break;
+        case ConstantPoolInfo::METHOD_TYPE:
+            add_descriptor_classes(class_file.utf8(info.info.method_type_info.descriptor_index), references.classes);
+            break;
+        case ConstantPoolInfo::DYNAMIC:
+        case ConstantPoolInfo::INVOKE_DYNAMIC:
+            if (auto reference = class_file.member_ref(index)) {
+                add_descriptor_classes(reference->descriptor, references.classes);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Adds the classes of a generic signature, inner classes under their binary name. Returns false if the signature is
+// malformed.
+auto add_signature_classes(std::string_view signature, References &references) -> bool {
+    return SignatureWalker::walk(signature, [&](size_t begin, size_t end, std::string_view binary_name, bool inner) {
+        if (inner) {
+            references.classes.push_back(references.inner_classes.emplace_back(binary_name));
+        } else {
+            references.classes.push_back(signature.substr(begin, end - begin));
+        }
+    });
+}
+
+// Adds the classes that annotations name through UTF-8 descriptors instead of class constants: the annotation types,
+// class values and enum types. String values count like string literals.
+auto add_annotation_references(const ClassFile &class_file, std::string_view name, std::span<const uint8_t> data,
+                               References &references) -> bool {
+    return AnnotationWalker::walk(name, data, [&](size_t offset, AnnotationWalker::Index index) {
+        auto value = class_file.utf8(Bytecode::read_u16(data, offset));
+        if (index == AnnotationWalker::STRING) {
+            references.strings.push_back(value);
+        } else if (index == AnnotationWalker::TYPE || index == AnnotationWalker::CLASS
+                   || index == AnnotationWalker::ENUM_TYPE) {
+            add_descriptor_classes(value, references.classes);
+        }
+    });
+}
+
+// Adds the constants referenced by the attribute. Returns false if the attribute couldn't be decoded.
+auto add_attribute(const ClassFile &class_file, const AttributeInfo &attribute_info, References &references) -> bool {
+    std::span<const uint8_t> data(attribute_info.info, attribute_info.attribute_length);
+    auto name = class_file.utf8(attribute_info.attribute_name_index);
+
+    // Annotations and signatures name their classes in UTF-8 constants, which add_constant doesn't follow.
+    if (AnnotationWalker::handles(name)) return add_annotation_references(class_file, name, data, references);
+    if (name == "Signature") {
+        return data.size() == 2 && add_signature_classes(class_file.utf8(Bytecode::read_u16(data, 0)), references);
+    }
+
+    auto add_index = [&](size_t offset, bool wide) {
+        add_constant(class_file, wide ? Bytecode::read_u16(data, offset) : data[offset], references);
+    };
+
+    return ConstantPoolCompactor::visit_indices(class_file, name, data, add_index);
+}
+
+auto scan_class(ClassFile &class_file) -> ClassScan {
+    ClassScan scan;
+    scan.class_file = &class_file;
+    scan.name = class_file.class_name(class_file.this_class);
+
+    if (auto super_name = class_file.class_name(class_file.super_class); !super_name.empty()) {
+        scan.supertypes.push_back(super_name);
+    }
+    for (auto interface: class_file.interfaces) {
+        if (auto name = class_file.class_name(interface); !name.empty()) scan.supertypes.push_back(name);
+    }
+
+    // Nest and inner class lists don't keep the classes they name alive, everything else outside of code does.
+    auto decoded = true;
+    auto add_attributes = [&](const std::vector<AttributeInfo> &attributes) {
+        for (const auto &attribute_info: attributes) {
+            auto name = class_file.utf8(attribute_info.attribute_name_index);
+            if (name == "Code" || name == "InnerClasses" || name == "NestMembers" || name == "PermittedSubclasses") {
+                continue;
+            }
+            decoded = add_attribute(class_file, attribute_info, scan.references) && decoded;
+        }
+    };
+
+    add_attributes(class_file.attributes);
+    for (const auto &field_info: class_file.fields) {
+        for (const auto &attribute_info: field_info.attributes) {
+            decoded = add_attribute(class_file, *attribute_info, scan.references) && decoded;
+        }
+    }
+
+    scan.methods.resize(class_file.methods.size());
+    for (uint32_t index = 0; index < class_file.methods.size(); index++) {
+        const auto &method_info = class_file.methods[index];
+        scan.method_ids.emplace(member_key(class_file.utf8(method_info.name_index),
+                                           class_file.utf8(method_info.descriptor_index)), index);
+        add_attributes(method_info.attributes);
+
+        if (const auto *code = CodeAttribute::find(class_file, method_info)) {
+            decoded = add_attribute(class_file, *code, scan.methods[index]) && decoded;
+        }
+    }
+
+    for (uint32_t index = 0; index < class_file.fields.size(); index++) {
+        const auto &field_info = class_file.fields[index];
+        scan.field_ids.emplace(member_key(class_file.utf8(field_info.name_index),
+                                          class_file.utf8(field_info.descriptor_index)), index);
+    }
+
+    // Attributes that aren't understood may refer to anything, so the whole constant pool counts, including the
+    // UTF-8 constants that read as descriptors.
+    if (!decoded) {
+        for (uint16_t index = 1; index < class_file.constant_pool_count; index++) {
+            add_constant(class_file, index, scan.references);
+            if (class_file.constant_pool[index - 1].tag == ConstantPoolInfo::UTF_8) {
+                add_descriptor_classes(class_file.utf8(index), scan.references.classes);
+            }
+        }
+    }
+
+    return scan;
+}
+
+auto matches(std::string_view pattern, std::string_view name) -> bool {
+    if (pattern.ends_with("/**")) return name.starts_with(pattern.substr(0, pattern.size() - 2));
+
+    if (pattern.ends_with("/*")) {
+        auto package = pattern.substr(0, pattern.size() - 1);
+        return name.starts_with(package) && name.find('/', package.size()) == std::string_view::npos;
+    }
+
+    return pattern == name;
+}
+
+// A worklist over the classes of the JAR that marks the live classes and members.
+class Reachability {
+public:
+    Reachability(std::vector<ClassScan> &scans, bool reflection_hints)
+            : _scans(scans), _reflection_hints(reflection_hints) {
+        _live_classes.assign(scans.size(), 0);
+        _external_supertypes.assign(scans.size(), UNKNOWN);
+        _subtypes.resize(scans.size());
+        _live_methods.resize(scans.size());
+        _live_fields.resize(scans.size());
+
+        for (uint32_t id = 0; id < scans.size(); id++) {
+            _ids[scans[id].name].push_back(id);
+            _live_methods[id].assign(scans[id].class_file->methods.size(), 0);
+            _live_fields[id].assign(scans[id].class_file->fields.size(), 0);
+        }
+
+        for (uint32_t id = 0; id < scans.size(); id++) {
+            for (auto supertype: scans[id].supertypes) {
+                for (auto super_id: ids(supertype)) _subtypes[super_id].push_back(id);
+            }
+        }
+    }
+
+    [[nodiscard]] auto ids(std::string_view name) const -> const std::vector<uint32_t> & {
+        static const std::vector<uint32_t> none;
+        auto found = _ids.find(name);
+        return found == _ids.end() ? none : found->second;
+    }
+
+    void keep_class(uint32_t id) {
+        mark_class(id);
+        for (uint32_t index = 0; index < _live_methods[id].size(); index++) mark_method(id, index);
+        for (uint32_t index = 0; index < _live_fields[id].size(); index++) mark_field(id, index);
+    }
+
+    void mark_class(uint32_t id) {
+        if (_live_classes[id]) return;
+        _live_classes[id] = 1;
+        _pending_classes.push_back(id);
+    }
+
+    void mark_method(uint32_t id, uint32_t index) {
+        if (_live_methods[id][index]) return;
+        _live_methods[id][index] = 1;
+        _pending_methods.emplace_back(id, index);
+    }
+
+    void mark_field(uint32_t id, uint32_t index) {
+        if (_live_fields[id][index]) return;
+        _live_fields[id][index] = 1;
+
+        const auto &class_file = *_scans[id].class_file;
+        std::vector<std::string_view> classes;
+        add_descriptor_classes(class_file.utf8(class_file.fields[index].descriptor_index), classes);
+        for (auto name: classes) mark_classes(name);
+    }
+
+    void run() {
+        while (!_pending_classes.empty() || !_pending_methods.empty()) {
+            if (!_pending_classes.empty()) {
+                auto id = _pending_classes.back();
+                _pending_classes.pop_back();
+                _process_class(id);
+            } else {
+                auto [id, index] = _pending_methods.back();
+                _pending_methods.pop_back();
+                _process_method(id, index);
+            }
+        }
+    }
+
+    [[nodiscard]] auto is_live_class(uint32_t id) const -> bool {
+        return _live_classes[id];
+    }
+
+    [[nodiscard]] auto is_live_method(uint32_t id, uint32_t index) const -> bool {
+        return _live_methods[id][index];
+    }
+
+    [[nodiscard]] auto is_live_field(uint32_t id, uint32_t index) const -> bool {
+        return _live_fields[id][index];
+    }
+
+private:
+    enum ExternalState : uint8_t {
+        UNKNOWN,
+        VISITING,
+        INTERNAL,
+        EXTERNAL
+    };
+
+    void mark_classes(std::string_view name) {
+        for (auto id: ids(name)) mark_class(id);
+    }
+
+    [[nodiscard]] auto _method(uint32_t id, const std::string &key) const -> uint32_t {
+        auto found = _scans[id].method_ids.find(key);
+        return found == _scans[id].method_ids.end() ? UINT32_MAX : found->second;
+    }
+
+    [[nodiscard]] auto _is_virtual(uint32_t id, uint32_t index) const -> bool {
+        const auto &class_file = *_scans[id].class_file;
+        const auto &method_info = class_file.methods[index];
+        return !(method_info.access_flags & (MethodInfo::STATIC | MethodInfo::PRIVATE))
+               && !class_file.utf8(method_info.name_index).starts_with('<');
+    }
+
+    // Whether a supertype other than java/lang/Object lies outside of the JAR.
+    auto _has_external_supertype(uint32_t id) -> bool {
+        if (_external_supertypes[id] == VISITING) return false;
+        if (_external_supertypes[id] != UNKNOWN) return _external_supertypes[id] == EXTERNAL;
+
+        _external_supertypes[id] = VISITING;
+        auto external = false;
+        for (auto supertype: _scans[id].supertypes) {
+            const auto &super_ids = ids(supertype);
+            if (super_ids.empty()) {
+                external = external || supertype != "java/lang/Object";
+            }
+            for (auto super_id: super_ids) external = _has_external_supertype(super_id) || external;
+        }
+
+        _external_supertypes[id] = external ? EXTERNAL : INTERNAL;
+        return external;
+    }
+
+    void _process_class(uint32_t id) {
+        const auto &scan = _scans[id];
+        const auto &class_file = *scan.class_file;
+
+        for (auto supertype: scan.supertypes) mark_classes(supertype);
+        _apply(scan.references);
+
+        auto whole = class_file.access_flags & ClassFile::ANNOTATION;
+        auto all_fields = (class_file.access_flags & ClassFile::ENUM)
+                          || class_file.class_name(class_file.super_class) == "java/lang/Record";
+        auto external = _has_external_supertype(id);
+
+        for (uint32_t index = 0; index < class_file.methods.size(); index++) {
+            const auto &method_info = class_file.methods[index];
+            auto name = class_file.utf8(method_info.name_index);
+            auto key = member_key(name, class_file.utf8(method_info.descriptor_index));
+
+            auto keep = whole || name == "<clinit>"
+                        || std::find(std::begin(SERIALIZATION_MEMBERS), std::end(SERIALIZATION_MEMBERS), name)
+                           != std::end(SERIALIZATION_MEMBERS)
+                        || ((class_file.access_flags & ClassFile::ENUM) && (name == "values" || name == "valueOf"));
+
+            if (!keep && _is_virtual(id, index)) {
+                keep = external || std::find(std::begin(OBJECT_METHODS), std::end(OBJECT_METHODS), key)
+                                   != std::end(OBJECT_METHODS);
+            }
+
+            if (keep) mark_method(id, index);
+        }
+
+        for (uint32_t index = 0; index < class_file.fields.size(); index++) {
+            auto name = class_file.utf8(class_file.fields[index].name_index);
+            if (all_fields || std::find(std::begin(SERIALIZATION_MEMBERS), std::end(SERIALIZATION_MEMBERS), name)
+                              != std::end(SERIALIZATION_MEMBERS)) {
+                mark_field(id, index);
+            }
+        }
+
+        // Live methods of the supertypes may now dispatch to this class.
+        std::vector<uint32_t> supertypes;
+        _collect_supertypes(id, supertypes);
+        for (auto super_id: supertypes) {
+            const auto &super_class_file = *_scans[super_id].class_file;
+            for (uint32_t index = 0; index < super_class_file.methods.size(); index++) {
+                if (!_live_methods[super_id][index] || !_is_virtual(super_id, index)) continue;
+
+                const auto &method_info = super_class_file.methods[index];
+                _dispatch(id, member_key(super_class_file.utf8(method_info.name_index),
+                                         super_class_file.utf8(method_info.descriptor_index)));
+            }
+        }
+    }
+
+    void _process_method(uint32_t id, uint32_t index) {
+        const auto &class_file = *_scans[id].class_file;
+        const auto &method_info = class_file.methods[index];
+
+        mark_class(id);
+
+        std::vector<std::string_view> classes;
+        add_descriptor_classes(class_file.utf8(method_info.descriptor_index), classes);
+        for (auto name: classes) mark_classes(name);
+
+        _apply(_scans[id].methods[index]);
+
+        if (!_is_virtual(id, index)) return;
+
+        // Subclasses inherit from within the subtree, classes implementing an interface maybe from elsewhere.
+        auto key = member_key(class_file.utf8(method_info.name_index), class_file.utf8(method_info.descriptor_index));
+        auto interface = class_file.access_flags & ClassFile::INTERFACE;
+
+        std::vector<uint32_t> pending(_subtypes[id].begin(), _subtypes[id].end());
+        _subtypes_visited.clear(_scans.size());
+        while (!pending.empty()) {
+            auto subtype = pending.back();
+            pending.pop_back();
+            if (!_subtypes_visited.insert(subtype)) continue;
+
+            if (_live_classes[subtype]) {
+                if (interface) {
+                    _dispatch(subtype, key);
+                } else if (auto found = _method(subtype, key); found != UINT32_MAX) {
+                    mark_method(subtype, found);
+                }
+            }
+
+            pending.insert(pending.end(), _subtypes[subtype].begin(), _subtypes[subtype].end());
+        }
+    }
+
+    void _collect_supertypes(uint32_t id, std::vector<uint32_t> &result) {
+        std::vector<uint32_t> pending{id};
+        _supertypes_visited.clear(_scans.size());
+        _supertypes_visited.insert(id);
+
+        while (!pending.empty()) {
+            auto current = pending.back();
+            pending.pop_back();
+
+            for (auto supertype: _scans[current].supertypes) {
+                for (auto super_id: ids(supertype)) {
+                    if (!_supertypes_visited.insert(super_id)) continue;
+                    result.push_back(super_id);
+                    pending.push_back(super_id);
+                }
+            }
+        }
+    }
+
+    // Marks the method that a call on an instance of the class selects, or the default methods that may be it.
+    void _dispatch(uint32_t id, const std::string &key) {
+        _superclasses_visited.clear(_scans.size());
+        for (auto current = id; current != UINT32_MAX;) {
+            if (!_superclasses_visited.insert(current)) break;
+
+            if (auto found = _method(current, key); found != UINT32_MAX && _is_virtual(current, found)) {
+                mark_method(current, found);
+                return;
+            }
+
+            const auto &class_file = *_scans[current].class_file;
+            const auto &super_ids = ids(class_file.class_name(class_file.super_class));
+            current = super_ids.empty() ? UINT32_MAX : super_ids.front();
+        }
+
+        std::vector<uint32_t> supertypes;
+        _collect_supertypes(id, supertypes);
+        for (auto super_id: supertypes) {
+            if (!(_scans[super_id].class_file->access_flags & ClassFile::INTERFACE)) continue;
+            if (auto found = _method(super_id, key); found != UINT32_MAX) mark_method(super_id, found);
+        }
+    }
+
+    // Marks the declarations a symbolic reference resolves to: along the superclasses, then the superinterfaces.
+    template<typename Lookup, typename Mark>
+    void _resolve(const MemberRef &reference, Lookup &&lookup, Mark &&mark) {
+        const auto &owner_ids = ids(reference.owner);
+        if (owner_ids.empty()) return;
+
+        auto key = member_key(reference.name, reference.descriptor);
+        for (auto owner: owner_ids) {
+            mark_class(owner);
+
+            _superclasses_visited.clear(_scans.size());
+            for (auto current = owner; current != UINT32_MAX;) {
+                if (!_superclasses_visited.insert(current)) break;
+
+                if (auto found = lookup(current, key); found != UINT32_MAX) {
+                    mark(current, found);
+                    return;
+                }
+
+                const auto &class_file = *_scans[current].class_file;
+                const auto &super_ids = ids(class_file.class_name(class_file.super_class));
+                current = super_ids.empty() ? UINT32_MAX : super_ids.front();
+            }
+
+            std::vector<uint32_t> supertypes;
+            _collect_supertypes(owner, supertypes);
+            for (auto super_id: supertypes) {
+                if (auto found = lookup(super_id, key); found != UINT32_MAX) mark(super_id, found);
+            }
+        }
+    }
+
+    void _apply(const References &references) {
+        for (auto name: references.classes) mark_classes(name);
+
+        for (const auto &reference: references.methods) {
+            _resolve(reference, [&](uint32_t id, const std::string &key) { return _method(id, key); },
+                     [&](uint32_t id, uint32_t index) { mark_method(id, index); });
+        }
+
+        for (const auto &reference: references.fields) {
+            auto lookup = [&](uint32_t id, const std::string &key) {
+                auto found = _scans[id].field_ids.find(key);
+                return found == _scans[id].field_ids.end() ? UINT32_MAX : found->second;
+            };
+            _resolve(reference, lookup, [&](uint32_t id, uint32_t index) { mark_field(id, index); });
+        }
+
+        if (!_reflection_hints) return;
+
+        for (auto value: references.strings) {
+            if (value.empty() || value.size() > 1024) continue;
+
+            std::string name(value);
+            std::replace(name.begin(), name.end(), '.', '/');
+            for (auto id: ids(name)) keep_class(id);
+        }
+    }
+
+private:
+    std::vector<ClassScan> &_scans;
+    bool _reflection_hints;
+    std::unordered_map<std::string_view, std::vector<uint32_t>> _ids{};
+    std::vector<std::vector<uint32_t>> _subtypes{};
+    std::vector<uint8_t> _live_classes{};
+    std::vector<uint8_t> _external_supertypes{};
+    std::vector<std::vector<uint8_t>> _live_methods{};
+    std::vector<std::vector<uint8_t>> _live_fields{};
+    std::vector<uint32_t> _pending_classes{};
+    std::vector<std::pair<uint32_t, uint32_t>> _pending_methods{};
+    // Separate, since dispatching from within the walk over the subtypes collects supertypes.
+    VisitedSet _subtypes_visited{};
+    VisitedSet _supertypes_visited{};
+    VisitedSet _superclasses_visited{};
+};
+
+} // namespace
+
+auto Shrinker::shrink(JARFile &jar_file, const Options &options) -> Result {
+    std::vector<std::pair<std::string, ClassFile *>> entries;
+    for (auto &[entry_name, class_file]: jar_file.classes) entries.emplace_back(entry_name, &class_file);
+
+    std::vector<ClassScan> scans(entries.size());
+    parallel_for(entries.size(), [&](size_t index) {
+        scans[index] = scan_class(*entries[index].second);
+    }, options.thread_count);
+
+    Reachability reachability(scans, options.reflection_hints);
+    auto has_roots = false;
+
+    if (auto main_class = jar_file.manifest.value("Main-Class")) {
+        std::string name(*main_class);
+        std::replace(name.begin(), name.end(), '.', '/');
+
+        for (auto id: reachability.ids(name)) {
+            has_roots = true;
+            reachability.mark_class(id);
+
+            auto found = scans[id].method_ids.find("main([Ljava/lang/String;)V");
+            if (found != scans[id].method_ids.end()) reachability.mark_method(id, found->second);
+        }
+    }
+
+    for (uint32_t id = 0; id < scans.size(); id++) {
+        for (const auto &pattern: options.keep) {
+            if (!matches(pattern, scans[id].name)) continue;
+
+            has_roots = true;
+            reachability.keep_class(id);
+            break;
+        }
+    }
+
+    if (!has_roots) throw std::invalid_argument("Warning: The JAR has neither a Main-Class nor kept classes.");
+
+    // Service providers are instantiated through reflection, one class name per line.
+    if (options.reflection_hints) {
+        for (const auto &[entry_name, data]: jar_file.others) {
+            if (!entry_name.starts_with("META-INF/services/")) continue;
+
+            std::string_view content(reinterpret_cast<const char *>(data.data()), data.size());
+            while (!content.empty()) {
+                auto end = content.find('\n');
+                auto line = content.substr(0, end);
+                content = end == std::string_view::npos ? std::string_view() : content.substr(end + 1);
+
+                line = line.substr(0, line.find('#'));
+                while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) line.remove_prefix(1);
+                while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.remove_suffix(1);
+
+                std::string name(line);
+                std::replace(name.begin(), name.end(), '.', '/');
+                for (auto id: reachability.ids(name)) reachability.keep_class(id);
+            }
+        }
+    }
+
+    reachability.run();
+
+    Result result;
+    std::vector<ClassFile *> live_classes;
+    std::vector<uint8_t> shrunk;
+    for (uint32_t id = 0; id < scans.size(); id++) {
+        auto &class_file = *scans[id].class_file;
+        if (!reachability.is_live_class(id)) {
+            result.removed_classes++;
+            result.removed_methods += class_file.methods.size();
+            result.removed_fields += class_file.fields.size();
+            jar_file.classes.erase(entries[id].first);
+            continue;
+        }
+
+        std::vector<MethodInfo> methods;
+        for (uint32_t index = 0; index < class_file.methods.size(); index++) {
+            if (reachability.is_live_method(id, index)) methods.push_back(std::move(class_file.methods[index]));
+        }
+        result.removed_methods += class_file.methods.size() - methods.size();
+        auto removed_members = methods.size() < class_file.methods.size();
+        class_file.methods = std::move(methods);
+        class_file.method_count = static_cast<uint16_t>(class_file.methods.size());
+
+        std::vector<FieldInfo> fields;
+        for (uint32_t index = 0; index < class_file.fields.size(); index++) {
+            if (reachability.is_live_field(id, index)) fields.push_back(std::move(class_file.fields[index]));
+        }
+        result.removed_fields += class_file.fields.size() - fields.size();
+        shrunk.push_back(removed_members || fields.size() < class_file.fields.size());
+        class_file.fields = std::move(fields);
+        class_file.fields_count = static_cast<uint16_t>(class_file.fields.size());
+
+        live_classes.push_back(&class_file);
+    }
+
+    std::vector<size_t> removed_constants(live_classes.size());
+    parallel_for(live_classes.size(), [&](size_t index) {
+        removed_constants[index] = ConstantPoolCompactor::compact(*live_classes[index]);
+        if (removed_constants[index] == 0 && shrunk[index]) ClassWriter::update_byte_code(*live_classes[index]);
+    }, options.thread_count);
+
+    for (auto removed: removed_constants) result.removed_constants += removed;
+    return result;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "signature_walker.h"
+
+#include <cstring>
+#include <string>
+
+using namespace ares;
+
+namespace {
+
+class SignatureCursor {
+public:
+    SignatureCursor(std::string_view signature, const SignatureWalker::ClassVisitor &visitor)
+            : _signature(signature), _visitor(visitor) {}
+
+    auto run() -> bool {
+        if (_peek() == '<') _type_parameters();
+
+        while (_valid && _position < _signature.size()) {
+            auto current = _peek();
+            if (current == '(' || current == ')' || current == '^' || current == 'V') {
+                _position++;
+            } else {
+                _type();
+            }
+        }
+
+        return _valid;
+    }
+
+private:
+    [[nodiscard]] auto _peek() const -> char {
+        return _position < _signature.size() ? _signature[_position] : '\0';
+    }
+
+    void _type_parameters() {
+        _position++;
+        while (_valid && _peek() != '>') {
+            auto end = _signature.find(':', _position);
+            if (end == std::string_view::npos || end == _position) {
+                _valid = false;
+                return;
+            }
+
+            _position = end;
+            while (_valid && _peek() == ':') {
+                _position++;
+                if (_peek() == 'L' || _peek() == 'T' || _peek() == '[') _type();
+            }
+        }
+        _position++;
+    }
+
+    void _type() {
+        switch (_peek()) {
+            case 'L':
+                _class_type();
+                return;
+            case 'T': {
+                auto end = _signature.find(';', _position);
+                if (end == std::string_view::npos) _valid = false;
+                _position = end + 1;
+                return;
+            }
+            case '[':
+                _position++;
+                _type();
+                return;
+            case 'B':
+            case 'C':
+            case 'D':
+            case 'F':
+            case 'I':
+            case 'J':
+            case 'S':
+            case 'Z':
+                _position++;
+                return;
+            default:
+                _valid = false;
+        }
+    }
+
+    void _class_type() {
+        auto start = ++_position;
+        _skip_identifier();
+        if (!_valid) return;
+
+        auto name = _signature.substr(start, _position - start);
+        _visitor(start, _position, name, false);
+
+        std::string binary_name;
+        while (_valid) {
+            auto current = _peek();
+            if (current == '<') {
+                _type_arguments();
+            } else if (current == '.') {
+                start = ++_position;
+                _skip_identifier();
+                if (!_valid) return;
+
+                if (binary_name.empty()) binary_name = name;
+                binary_name.append(1, '$').append(_signature.substr(start, _position - start));
+                _visitor(start, _position, binary_name, true);
+            } else if (current == ';') {
+                _position++;
+                return;
+            } else {
+                _valid = false;
+            }
+        }
+    }
+
+    void _type_arguments() {
+        _position++;
+        while (_valid && _peek() != '>') {
+            if (_peek() == '*') {
+                _position++;
+                continue;
+            }
+            if (_peek() == '+' || _peek() == '-') _position++;
+            _type();
+        }
+        _position++;
+    }
+
+    void _skip_identifier() {
+        while (_position < _signature.size() && !std::strchr("<.;", _signature[_position])) _position++;
+        if (_position >= _signature.size()) _valid = false;
+    }
+
+private:
+    std::string_view _signature;
+    const SignatureWalker::ClassVisitor &_visitor;
+    size_t _position{};
+    bool _valid{true};
+};
+
+} // namespace
+
+auto SignatureWalker::walk(std::string_view signature, const ClassVisitor &visitor) -> bool {
+    return SignatureCursor(signature, visitor).run();
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,510 @@
+#include "snapshot.h"
+
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cassert>
+#include <deque>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "attribute_info.h"
+#include "class_writer.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "binary_io.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x50534E41; // "ANSP"
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+static_assert(sizeof(SnapshotHeader) == 64 && std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(sizeof(SnapshotClassRecord) == 80 && std::is_trivially_copyable_v<SnapshotClassRecord>);
+static_assert(sizeof(SnapshotConstant) == 8 && sizeof(SnapshotMember) == 16);
+static_assert(sizeof(SnapshotAttribute) == 16 && sizeof(SnapshotEntryRecord) == 32);
+
+class SnapshotBuffer {
+public:
+    auto append(const void *data, size_t size) -> uint64_t {
+        auto offset = _bytes.size();
+        _bytes.resize(offset + size);
+        if (size) std::memcpy(_bytes.data() + offset, data, size);
+        align();
+        return offset;
+    }
+
+    auto reserve(size_t size) -> uint64_t {
+        auto offset = _bytes.size();
+        _bytes.resize(offset + size);
+        align();
+        return offset;
+    }
+
+    template<typename Record>
+    void put(uint64_t offset, const Record &record) {
+        std::memcpy(_bytes.data() + offset, &record, sizeof(Record));
+    }
+
+    auto bytes() -> std::vector<uint8_t> & {
+        return _bytes;
+    }
+
+private:
+    void align() {
+        _bytes.resize((_bytes.size() + 7) & ~static_cast<size_t>(7));
+    }
+
+private:
+    std::vector<uint8_t> _bytes{};
+};
+
+auto in_bounds(uint64_t offset, uint64_t count, uint64_t element_size, uint64_t size) -> bool {
+    return offset <= size && count <= (size - offset) / element_size;
+}
+
+// Records are read in place, so their offsets also have to be aligned for the record type. The mapping itself starts
+// at a page boundary.
+template<typename Record>
+auto records_in_bounds(uint64_t offset, uint64_t count, uint64_t size) -> bool {
+    return offset % alignof(Record) == 0 && in_bounds(offset, count, sizeof(Record), size);
+}
+
+void add_attribute(std::vector<SnapshotAttribute> &attributes, const AttributeInfo &attribute_info,
+                   uint32_t &offset) {
+    attributes.push_back({attribute_info.attribute_name_index, 0, attribute_info.attribute_length, offset + 6, 0});
+    offset += attribute_info.size();
+}
+
+} // namespace
+
+SnapshotClass::SnapshotClass(const uint8_t *base, const SnapshotClassRecord *record)
+        : _base(base), _record(record) {}
+
+auto SnapshotClass::record() const -> const SnapshotClassRecord & {
+    return *_record;
+}
+
+auto SnapshotClass::name() const -> std::string_view {
+    return {reinterpret_cast<const char *>(_base + _record->name_offset), _record->name_size};
+}
+
+auto SnapshotClass::byte_code() const -> std::span<const uint8_t> {
+    return {_base + _record->byte_code_offset, _record->byte_code_size};
+}
+
+auto SnapshotClass::is_valid_index(unsigned int index) const -> bool {
+    return index > 0 && index < _record->constant_pool_count;
+}
+
+auto SnapshotClass::tag(unsigned int index) const -> ConstantPoolInfo::ConstantTag {
+    if (!is_valid_index(index)) return ConstantPoolInfo::UNDEFINED;
+
+    const auto *constants = reinterpret_cast<const SnapshotConstant *>(_base + _record->constant_pool_offset);
+    return ConstantPoolInfo::ConstantTag(constants[index].tag);
+}
+
+auto SnapshotClass::constant_u16(unsigned int index, unsigned int position) const -> uint16_t {
+    if (!is_valid_index(index)) return 0;
+
+    const auto *constants = reinterpret_cast<const SnapshotConstant *>(_base + _record->constant_pool_offset);
+    auto offset = static_cast<size_t>(constants[index].offset) + 1 + position;
+    if (offset + 2 > _record->byte_code_size) return 0;
+
+    const auto *bytes = _base + _record->byte_code_offset + offset;
+    return static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+}
+
+auto SnapshotClass::utf8(unsigned int index) const -> std::string_view {
+    if (tag(index) != ConstantPoolInfo::UTF_8) return {};
+
+    const auto *constants = reinterpret_cast<const SnapshotConstant *>(_base + _record->constant_pool_offset);
+    auto offset = static_cast<size_t>(constants[index].offset) + 3;
+    auto length = constant_u16(index, 0);
+    if (offset + length > _record->byte_code_size) return {};
+
+    return {reinterpret_cast<const char *>(_base + _record->byte_code_offset + offset), length};
+}
+
+auto SnapshotClass::class_name(unsigned int index) const -> std::string_view {
+    if (tag(index) != ConstantPoolInfo::CLASS) return {};
+    return utf8(constant_u16(index, 0));
+}
+
+auto SnapshotClass::interfaces() const -> std::span<const uint16_t> {
+    return {reinterpret_cast<const uint16_t *>(_base + _record->interfaces_offset), _record->interfaces_count};
+}
+
+auto SnapshotClass::fields() const -> std::span<const SnapshotMember> {
+    return {reinterpret_cast<const SnapshotMember *>(_base + _record->members_offset), _record->fields_count};
+}
+
+auto SnapshotClass::methods() const -> std::span<const SnapshotMember> {
+    const auto *members = reinterpret_cast<const SnapshotMember *>(_base + _record->members_offset);
+    return {members + _record->fields_count, _record->method_count};
+}
+
+auto SnapshotClass::attributes() const -> std::span<const SnapshotAttribute> {
+    return {reinterpret_cast<const SnapshotAttribute *>(_base + _record->attributes_offset),
+            _record->attributes_count};
+}
+
+auto SnapshotClass::attributes(const SnapshotMember &member) const -> std::span<const SnapshotAttribute> {
+    const auto *attributes = reinterpret_cast<const SnapshotAttribute *>(_base + _record->attributes_offset);
+    return {attributes + member.first_attribute, member.attributes_count};
+}
+
+auto SnapshotClass::attribute_data(const SnapshotAttribute &attribute) const -> std::span<const uint8_t> {
+    return byte_code().subspan(attribute.data_offset, attribute.length);
+}
+
+auto SnapshotClass::to_class_file() const -> ClassFile {
+    return JARFile::read_class(std::vector<uint8_t>(byte_code().begin(), byte_code().end()));
+}
+
+void Snapshot::write(JARFile &jar_file, const std::string &path) {
+    std::vector<std::pair<const std::string *, ClassFile *>> classes;
+    for (auto &class_file: jar_file.classes) {
+        classes.emplace_back(&class_file.first, &class_file.second);
+    }
+    std::sort(classes.begin(), classes.end(), [](const auto &first, const auto &second) {
+        return *first.first < *second.first;
+    });
+
+    std::vector<const std::pair<const std::string, std::vector<uint8_t>> *> entries;
+    for (const auto &entry: jar_file.others) {
+        entries.push_back(&entry);
+    }
+
+    // The snapshot has to be self-contained, so streamed entries are read from their origin and embedded.
+    std::deque<std::pair<const std::string, std::vector<uint8_t>>> streamed;
+    for (const auto &entry: jar_file.streamed) {
+        auto &loaded = streamed.emplace_back(entry.first, std::vector<uint8_t>{});
+        loaded.second.reserve(entry.second.size);
+        jar_file.read_entry(entry.first, [&loaded](const uint8_t *data, size_t size) {
+            loaded.second.insert(loaded.second.end(), data, data + size);
+        });
+        entries.push_back(&loaded);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto *first, const auto *second) {
+        return first->first < second->first;
+    });
+
+    SnapshotBuffer buffer;
+    buffer.reserve(sizeof(SnapshotHeader));
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.class_count = classes.size();
+    header.classes_offset = buffer.reserve(classes.size() * sizeof(SnapshotClassRecord));
+    header.entry_count = entries.size();
+    header.entries_offset = buffer.reserve(entries.size() * sizeof(SnapshotEntryRecord));
+
+    for (size_t index = 0; index < classes.size(); index++) {
+        auto &class_file = *classes[index].second;
+
+        ClassWriter writer;
+        writer.visit_class(class_file);
+        const auto &byte_code = writer.byte_code();
+
+        SnapshotClassRecord record{};
+        record.name_size = static_cast<uint32_t>(classes[index].first->size());
+        record.name_offset = buffer.append(classes[index].first->data(), record.name_size);
+        record.minor_version = class_file.minor_version;
+        record.major_version = class_file.major_version;
+        record.constant_pool_count = class_file.constant_pool_count;
+        record.access_flags = class_file.access_flags;
+        record.this_class = class_file.this_class;
+        record.super_class = class_file.super_class;
+        record.interfaces_count = class_file.interfaces_count;
+        record.fields_count = class_file.fields_count;
+        record.method_count = class_file.method_count;
+        record.attributes_count = class_file.attributes_count;
+
+        // The offsets follow the layout that the class writer produced: magic, versions and the pool count first.
+        uint32_t offset = 10;
+        std::vector<SnapshotConstant> constants(class_file.constant_pool_count);
+        for (size_t pool_index = 0; pool_index < class_file.constant_pool.size(); pool_index++) {
+            const auto &info = class_file.constant_pool[pool_index];
+            constants[pool_index + 1] = {offset, info.tag, {}};
+            offset += info.size();
+        }
+
+        // Access flags, this and super class, the interfaces and the field count.
+        offset += 10 + 2 * class_file.interfaces_count;
+
+        std::vector<SnapshotMember> members;
+        std::vector<SnapshotAttribute> member_attributes;
+        for (const auto &field_info: class_file.fields) {
+            members.push_back({field_info.access_flags, field_info.name_index, field_info.descriptor_index,
+                               field_info.attributes_count, static_cast<uint32_t>(member_attributes.size()), 0});
+            offset += 8;
+            for (const auto &attribute_info: field_info.attributes) {
+                add_attribute(member_attributes, *attribute_info, offset);
+            }
+        }
+
+        offset += 2;
+        for (const auto &method_info: class_file.methods) {
+            members.push_back({method_info.access_flags, method_info.name_index, method_info.descriptor_index,
+                               method_info.attributes_count, static_cast<uint32_t>(member_attributes.size()), 0});
+            offset += 8;
+            for (const auto &attribute_info: method_info.attributes) {
+                add_attribute(member_attributes, attribute_info, offset);
+            }
+        }
+
+        // The class attributes come first, so the member attributes are shifted behind them.
+        offset += 2;
+        std::vector<SnapshotAttribute> attributes;
+        for (const auto &attribute_info: class_file.attributes) {
+            add_attribute(attributes, attribute_info, offset);
+        }
+        for (auto &member: members) {
+            member.first_attribute += static_cast<uint32_t>(attributes.size());
+        }
+        attributes.insert(attributes.end(), member_attributes.begin(), member_attributes.end());
+
+        assert(offset == byte_code.size());
+
+        record.constant_pool_offset = buffer.append(constants.data(), constants.size() * sizeof(SnapshotConstant));
+        record.interfaces_offset = buffer.append(class_file.interfaces.data(),
+                                                 class_file.interfaces.size() * sizeof(uint16_t));
+        record.members_offset = buffer.append(members.data(), members.size() * sizeof(SnapshotMember));
+        record.attribute_total = static_cast<uint32_t>(attributes.size());
+        record.attributes_offset = buffer.append(attributes.data(), attributes.size() * sizeof(SnapshotAttribute));
+        record.byte_code_size = static_cast<uint32_t>(byte_code.size());
+        record.byte_code_offset = buffer.append(byte_code.data(), byte_code.size());
+
+        buffer.put(header.classes_offset + index * sizeof(SnapshotClassRecord), record);
+    }
+
+    for (size_t index = 0; index < entries.size(); index++) {
+        SnapshotEntryRecord record{};
+        record.name_size = static_cast<uint32_t>(entries[index]->first.size());
+        record.name_offset = buffer.append(entries[index]->first.data(), record.name_size);
+        record.data_size = entries[index]->second.size();
+        record.data_offset = buffer.append(entries[index]->second.data(), record.data_size);
+
+        buffer.put(header.entries_offset + index * sizeof(SnapshotEntryRecord), record);
+    }
+
+    auto manifest = jar_file.manifest.content();
+    header.manifest_size = manifest.size();
+    header.manifest_offset = buffer.append(manifest.data(), manifest.size());
+    header.file_size = buffer.bytes().size();
+    buffer.put(0, header);
+
+    // Processes that still map the old snapshot keep its pages, the rename only affects later opens.
+    write_file_atomically(path, {buffer.bytes()}, "snapshot");
+}
+
+auto Snapshot::open(const std::string &path) -> Snapshot {
+    auto file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0) {
+        throw std::runtime_error("Warning: Couldn't open the snapshot: " + path);
+    }
+
+    struct stat stat{};
+    if (fstat(file_descriptor, &stat) != 0 || static_cast<size_t>(stat.st_size) < sizeof(SnapshotHeader)) {
+        close(file_descriptor);
+        throw std::runtime_error("Warning: The snapshot is too small: " + path);
+    }
+
+    auto size = static_cast<size_t>(stat.st_size);
+    auto *memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Warning: Couldn't map the snapshot: " + path);
+    }
+
+    Snapshot snapshot(static_cast<const uint8_t *>(memory), size);
+
+    // Everything that is reached through offsets is checked once here, so the accessors can trust the records.
+    const auto &header = snapshot._header();
+    auto valid = header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION && header.file_size == size
+                 && records_in_bounds<SnapshotClassRecord>(header.classes_offset, header.class_count, size)
+                 && records_in_bounds<SnapshotEntryRecord>(header.entries_offset, header.entry_count, size)
+                 && in_bounds(header.manifest_offset, header.manifest_size, 1, size);
+
+    for (size_t index = 0; valid && index < header.class_count; index++) {
+        const auto &record = snapshot.class_at(index).record();
+        const auto *constants = reinterpret_cast<const SnapshotConstant *>(
+                snapshot._data + record.constant_pool_offset);
+
+        valid = in_bounds(record.name_offset, record.name_size, 1, size)
+                && in_bounds(record.byte_code_offset, record.byte_code_size, 1, size)
+                && records_in_bounds<SnapshotConstant>(record.constant_pool_offset, record.constant_pool_count, size)
+                && records_in_bounds<uint16_t>(record.interfaces_offset, record.interfaces_count, size)
+                && records_in_bounds<SnapshotMember>(record.members_offset, record.fields_count + record.method_count,
+                                                    size)
+                && records_in_bounds<SnapshotAttribute>(record.attributes_offset, record.attribute_total, size)
+                && record.attributes_count <= record.attribute_total;
+
+        for (size_t pool_index = 1; valid && pool_index < record.constant_pool_count; pool_index++) {
+            valid = constants[pool_index].offset < record.byte_code_size;
+        }
+
+        auto snapshot_class = snapshot.class_at(index);
+        auto check_attributes = [&](std::span<const SnapshotAttribute> attributes) {
+            for (const auto &attribute: attributes) {
+                valid = valid && in_bounds(attribute.data_offset, attribute.length, 1, record.byte_code_size);
+            }
+        };
+
+        if (valid) check_attributes(snapshot_class.attributes());
+        for (size_t member_index = 0; valid && member_index < record.fields_count + record.method_count;
+             member_index++) {
+            const auto &member = reinterpret_cast<const SnapshotMember *>(
+                    snapshot._data + record.members_offset)[member_index];
+            valid = in_bounds(member.first_attribute, member.attributes_count, 1, record.attribute_total);
+            if (valid) check_attributes(snapshot_class.attributes(member));
+        }
+    }
+
+    for (size_t index = 0; valid && index < header.entry_count; index++) {
+        const auto &record = snapshot._entry(index);
+        valid = in_bounds(record.name_offset, record.name_size, 1, size)
+                && in_bounds(record.data_offset, record.data_size, 1, size);
+    }
+
+    if (!valid) {
+        throw std::runtime_error("Warning: The snapshot is damaged or has an unsupported version: " + path);
+    }
+
+    return snapshot;
+}
+
+Snapshot::Snapshot(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+Snapshot::Snapshot(Snapshot &&other) noexcept: _data(other._data), _size(other._size) {
+    other._data = nullptr;
+    other._size = 0;
+}
+
+auto Snapshot::operator=(Snapshot &&other) noexcept -> Snapshot & {
+    if (this != &other) {
+        if (_data) munmap(const_cast<uint8_t *>(_data), _size);
+
+        _data = other._data;
+        _size = other._size;
+        other._data = nullptr;
+        other._size = 0;
+    }
+    return *this;
+}
+
+Snapshot::~Snapshot() {
+    if (_data) munmap(const_cast<uint8_t *>(_data), _size);
+}
+
+auto Snapshot::class_count() const -> size_t {
+    return _header().class_count;
+}
+
+auto Snapshot::class_at(size_t index) const -> SnapshotClass {
+    const auto *records = reinterpret_cast<const SnapshotClassRecord *>(_data + _header().classes_offset);
+    return {_data, records + index};
+}
+
+auto Snapshot::find_class(std::string_view name) const -> std::optional<SnapshotClass> {
+    size_t low = 0, high = class_count();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (class_at(middle).name() < name) low = middle + 1;
+        else high = middle;
+    }
+
+    if (low < class_count() && class_at(low).name() == name) {
+        return class_at(low);
+    }
+
+    return std::nullopt;
+}
+
+auto Snapshot::entry_count() const -> size_t {
+    return _header().entry_count;
+}
+
+auto Snapshot::entry_name(size_t index) const -> std::string_view {
+    const auto &record = _entry(index);
+    return {reinterpret_cast<const char *>(_data + record.name_offset), record.name_size};
+}
+
+auto Snapshot::entry_data(size_t index) const -> std::span<const uint8_t> {
+    const auto &record = _entry(index);
+    return {_data + record.data_offset, record.data_size};
+}
+
+auto Snapshot::manifest() const -> std::string_view {
+    return {reinterpret_cast<const char *>(_data + _header().manifest_offset), _header().manifest_size};
+}
+
+auto Snapshot::to_jar_file() const -> JARFile {
+    JARFile jar_file;
+
+    for (size_t index = 0; index < class_count(); index++) {
+        auto snapshot_class = class_at(index);
+        jar_file.classes.emplace(snapshot_class.name(), snapshot_class.to_class_file());
+    }
+
+    for (size_t index = 0; index < entry_count(); index++) {
+        auto data = entry_data(index);
+        jar_file.add_entry(std::string(entry_name(index)), std::vector<uint8_t>(data.begin(), data.end()));
+    }
+
+    if (!manifest().empty()) {
+        jar_file.add_entry("META-INF/MANIFEST.MF", std::vector<uint8_t>(manifest().begin(), manifest().end()));
+    }
+
+    return jar_file;
+}
+
+auto Snapshot::_header() const -> const SnapshotHeader & {
+    return *reinterpret_cast<const SnapshotHeader *>(_data);
+}
+
+auto Snapshot::_entry(size_t index) const -> const SnapshotEntryRecord & {
+    const auto *records = reinterpret_cast<const SnapshotEntryRecord *>(_data + _header().entries_offset);
+    return records[index];
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "string_search.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <deque>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ARES_HAS_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "parallel.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr uint32_t MISSING = UINT32_MAX;
+
+} // namespace
+
+StringSearch::StringSearch(const std::vector<std::string> &patterns) {
+    for (const auto &pattern: patterns) {
+        if (pattern.empty()) throw std::invalid_argument("Warning: Empty search patterns can't be matched.");
+
+        // When all 256 bytes appear in patterns, the last one keeps class 0, which then stands for that byte alone.
+        for (auto byte: pattern) {
+            auto &byte_class = _classes[static_cast<uint8_t>(byte)];
+            if (byte_class == 0 && _class_count < 256) byte_class = static_cast<uint8_t>(_class_count++);
+        }
+
+        auto first = static_cast<uint8_t>(pattern.front());
+        _first_bytes[first] = true;
+        _low_nibbles[first & 0x0F] |= uint8_t(1) << (first >> 4 & 7);
+        _high_nibbles[first >> 4] |= uint8_t(1) << (first >> 4 & 7);
+    }
+
+    // The trie, states are numbered in insertion order.
+    std::vector<uint32_t> trie(_class_count, MISSING);
+    std::vector<std::vector<uint32_t>> outputs(1);
+
+    for (uint32_t index = 0; index < patterns.size(); index++) {
+        uint32_t state = 0;
+        for (auto byte: patterns[index]) {
+            auto &next = trie[state * _class_count + _classes[static_cast<uint8_t>(byte)]];
+            if (next == MISSING) {
+                next = static_cast<uint32_t>(outputs.size());
+                outputs.emplace_back();
+                trie.resize(trie.size() + _class_count, MISSING);
+            }
+            state = trie[state * _class_count + _classes[static_cast<uint8_t>(byte)]];
+        }
+
+        outputs[state].push_back(index);
+        _lengths.push_back(static_cast<uint32_t>(patterns[index].size()));
+    }
+
+    // The failure links in breadth-first order turn the trie into the complete transition function, a state
+    // inherits the outputs of its failure state, which is always closer to the start.
+    _transitions = std::move(trie);
+    std::vector<uint32_t> failures(outputs.size());
+    std::deque<uint32_t> pending;
+
+    for (size_t byte_class = 0; byte_class < _class_count; byte_class++) {
+        auto &next = _transitions[byte_class];
+        if (next == MISSING) {
+            next = 0;
+        } else {
+            pending.push_back(next);
+        }
+    }
+
+    while (!pending.empty()) {
+        auto state = pending.front();
+        pending.pop_front();
+
+        const auto &inherited = outputs[failures[state]];
+        outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+
+        for (size_t byte_class = 0; byte_class < _class_count; byte_class++) {
+            auto fallback = _transitions[failures[state] * _class_count + byte_class];
+            auto &next = _transitions[state * _class_count + byte_class];
+            if (next == MISSING) {
+                next = fallback;
+            } else {
+                failures[next] = fallback;
+                pending.push_back(next);
+            }
+        }
+    }
+
+    _output_offsets.reserve(outputs.size() + 1);
+    for (auto &state_outputs: outputs) {
+        _output_offsets.push_back(static_cast<uint32_t>(_outputs.size()));
+        std::sort(state_outputs.begin(), state_outputs.end());
+        _outputs.insert(_outputs.end(), state_outputs.begin(), state_outputs.end());
+    }
+    _output_offsets.push_back(static_cast<uint32_t>(_outputs.size()));
+}
+
+auto StringSearch::pattern_count() const -> size_t {
+    return _lengths.size();
+}
+
+auto StringSearch::search(const ClassFile &class_file) const -> std::vector<Match> {
+    std::vector<Match> matches;
+
+    for (size_t index = 1; index <= class_file.constant_pool.size(); index++) {
+        const auto &info = class_file.constant_pool[index - 1];
+        if (info.tag != ConstantPoolInfo::UTF_8 || !info.info.utf8_info.bytes) continue;
+
+        auto first = matches.size();
+        _scan(info.info.utf8_info.bytes, info.info.utf8_info.length, [&](uint32_t pattern, size_t offset) {
+            matches.push_back({{}, static_cast<uint16_t>(index), pattern, static_cast<uint32_t>(offset)});
+        });
+        std::sort(matches.begin() + static_cast<std::ptrdiff_t>(first), matches.end());
+    }
+
+    return matches;
+}
+
+auto StringSearch::search(JARFile &jar_file, unsigned int thread_count) const -> std::vector<Match> {
+    std::vector<std::pair<std::string, const ClassFile *>> classes;
+    jar_file.visit_classes([&](const std::string &entry_name, ClassFile &class_file) {
+        classes.emplace_back(entry_name, &class_file);
+    });
+    std::sort(classes.begin(), classes.end());
+
+    std::vector<std::vector<Match>> results(classes.size());
+    parallel_for(classes.size(), [&](size_t index) {
+        results[index] = search(*classes[index].second);
+        for (auto &match: results[index]) match.class_name = classes[index].first;
+    }, thread_count);
+
+    std::vector<Match> matches;
+    for (auto &result: results) {
+        std::move(result.begin(), result.end(), std::back_inserter(matches));
+    }
+    return matches;
+}
+
+template<typename Function>
+void StringSearch::_scan(const uint8_t *data, size_t size, Function &&function) const {
+    uint32_t state = 0;
+
+    for (size_t position = 0; position < size;) {
+        if (state == 0) {
+            position = _skip(data, position, size);
+            if (position == size) return;
+        }
+
+        state = _transitions[state * _class_count + _classes[data[position++]]];
+        for (auto output = _output_offsets[state]; output < _output_offsets[state + 1]; output++) {
+            function(_outputs[output], position - _lengths[_outputs[output]]);
+        }
+    }
+}
+
+auto StringSearch::_skip(const uint8_t *data, size_t position, size_t size) const -> size_t {
+#ifdef ARES_HAS_AVX2_KERNEL
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2 && size - position >= 32) position = _skip_avx2(data, position, size);
+#endif
+
+    while (position < size && !_first_bytes[data[position]]) position++;
+    return position;
+}
+
+#ifdef ARES_HAS_AVX2_KERNEL
+
+// Returns the first byte of the whole blocks which starts a pattern, or the start of the remaining partial block.
+__attribute__((target("avx2")))
+auto StringSearch::_skip_avx2(const uint8_t *data, size_t position, size_t size) const -> size_t {
+    auto low_table = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(_low_nibbles.data())));
+    auto high_table = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(_high_nibbles.data())));
+    auto nibble_mask = _mm256_set1_epi8(0x0F);
+
+    for (; position + 32 <= size; position += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + position));
+        auto low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(block, nibble_mask));
+        auto high = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble_mask));
+
+        // High nibbles eight apart share a bit, so candidates are checked against the exact set.
+        auto misses = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+        auto candidates = ~static_cast<uint32_t>(_mm256_movemask_epi8(misses));
+        while (candidates) {
+            auto lane = static_cast<size_t>(__builtin_ctz(candidates));
+            if (_first_bytes[data[position + lane]]) return position + lane;
+            candidates &= candidates - 1;
+        }
+    }
+
+    return position;
+}
+
+#else
+
+auto StringSearch::_skip_avx2(const uint8_t *, size_t position, size_t) const -> size_t {
+    return position;
+}
+
+#endif
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -3,6 +3,10 @@
 #include <filesystem>
 #include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <cctype>
 
 #include <boost/algorithm/string.hpp>
 
@@ -11,46 +15,278 @@
 
 using namespace ares;
 
-auto Manifest::content() const -> std::string {
-    std::stringstream content;
-    for (const auto &line: data) {
-        content << line.first << ": " << line.second << std::endl;
+namespace {
+
+// Returns the end of the line content and the start of the next line, lines end with CR LF, LF or CR.
+auto next_line(std::string_view content, size_t offset) -> std::pair<size_t, size_t> {
+    const auto *begin = content.data() + offset;
+    const auto *end = content.data() + content.size();
+
+    const auto *line_feed = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+    const auto *limit = line_feed ? line_feed : end;
+    const auto *carriage_return = static_cast<const char *>(std::memchr(begin, '\r', limit - begin));
+
+    if (carriage_return) {
+        auto line_end = static_cast<size_t>(carriage_return - content.data());
+        return {line_end, line_end + (carriage_return + 1 == line_feed ? 2 : 1)};
+    }
+
+    if (line_feed) {
+        auto line_end = static_cast<size_t>(line_feed - content.data());
+        return {line_end, line_end + 1};
     }
-    return content.str();
+
+    return {content.size(), content.size()};
 }
 
-auto Manifest::read_manifest(std::string &content) -> Manifest {
-    std::istringstream stream(content);
-    std::string line;
+auto equals_ignore_case(std::string_view first, std::string_view second) -> bool {
+    return first.size() == second.size() && std::equal(first.begin(), first.end(), second.begin(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
 
-    Manifest manifest;
-    while (std::getline(stream, line)) {
-        boost::algorithm::trim(line);
+} // namespace
 
-        // Ignore comments and empty lines
-        if (line.empty() || line[0] == '#') continue;
+auto ares::trim(std::string_view value) -> std::string_view {
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) value.remove_prefix(1);
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) value.remove_suffix(1);
+    return value;
+}
 
-        std::vector<std::string> tokens;
-        boost::split(tokens, line, boost::is_any_of(":"), boost::token_compress_on);
+auto Manifest::Section::find(std::string_view name) const -> const Attribute * {
+    for (const auto &attribute: attributes) {
+        if (equals_ignore_case(attribute.name, name)) return &attribute;
+    }
+    return nullptr;
+}
 
-        // Skip malformed lines without a key-value pair
-        if (tokens.size() < 2) continue;
+auto Manifest::Section::name() const -> std::string_view {
+    const auto *attribute = find("Name");
+    return attribute ? attribute->value : std::string_view{};
+}
 
-        auto key = tokens[0];
-        boost::algorithm::trim(key);
+auto Manifest::read_manifest(std::string content) -> Manifest {
+    Manifest manifest;
+    manifest._content = std::make_shared<const std::string>(std::move(content));
+    manifest._storage = std::make_shared<std::deque<std::string>>();
+
+    std::string_view view = *manifest._content;
+    auto *section = &manifest._sections.back();
+    Attribute *attribute = nullptr;
+    bool joined = false;
+    size_t section_start = 0;
+    size_t trailer_start = 0;
+    bool in_trailer = false;
+
+    size_t offset = 0;
+    while (offset < view.size()) {
+        auto [line_end, next] = next_line(view, offset);
+        auto line = view.substr(offset, line_end - offset);
+
+        if (offset == 0 && next > line_end) {
+            manifest._line_break = view.substr(line_end, next - line_end);
+        }
 
-        if (key.empty()) continue;
+        if (line.empty()) {
+            if (!in_trailer) trailer_start = offset;
+            in_trailer = true;
+            attribute = nullptr;
 
-        auto value = tokens[1];
-        boost::algorithm::trim(value);
+            section->trailer = view.substr(trailer_start, next - trailer_start);
+            offset = next;
+            continue;
+        }
 
-        manifest.data.emplace(std::move(key), std::move(value));
+        if (in_trailer) {
+            // A header after blank lines starts the next per-entry section.
+            section->raw = view.substr(section_start, offset - section_start);
+            section = &manifest._sections.emplace_back();
+            section_start = offset;
+            in_trailer = false;
+        }
+
+        if (line[0] == ' ' && attribute) {
+            // The first continuation copies the value out of the manifest, later ones grow the copy.
+            if (joined) {
+                manifest._storage->back().append(line.substr(1));
+            } else {
+                manifest._storage->emplace_back(attribute->value).append(line.substr(1));
+                joined = true;
+            }
+
+            attribute->value = manifest._storage->back();
+            auto start = static_cast<size_t>(attribute->raw.data() - view.data());
+            attribute->raw = view.substr(start, next - start);
+            offset = next;
+            continue;
+        }
+
+        // Lines without a colon are kept as nameless attributes, so that they survive a rewrite.
+        auto colon = line.find(':');
+        auto &added = section->attributes.emplace_back();
+        added.raw = view.substr(offset, next - offset);
+        joined = false;
+
+        if (colon != std::string_view::npos && colon > 0 && line[0] != ' ') {
+            added.name = line.substr(0, colon);
+            added.value = line.substr(colon + 1);
+            if (!added.value.empty() && added.value[0] == ' ') added.value.remove_prefix(1);
+            attribute = &added;
+        } else {
+            attribute = nullptr;
+        }
+
+        offset = next;
     }
 
+    section->raw = view.substr(section_start);
+    manifest._index_entries();
+
     return manifest;
 }
 
-auto JARFile::read_file(const std::string &path) -> JARFile {
+auto Manifest::content() const -> std::string {
+    if (!_modified) return _content ? *_content : std::string();
+
+    std::string content;
+    for (size_t index = 0; index < _sections.size(); index++) {
+        const auto &section = _sections[index];
+        for (const auto &attribute: section.attributes) {
+            _write_attribute(content, attribute, _line_break);
+        }
+
+        // Sections need a blank line in between, even if a section was changed from the last one.
+        if (!section.trailer.empty()) {
+            content.append(section.trailer);
+        } else if (index + 1 < _sections.size()) {
+            content.append(_line_break);
+        }
+    }
+
+    return content;
+}
+
+auto Manifest::empty() const -> bool {
+    return (!_content || _content->empty()) && !_modified;
+}
+
+auto Manifest::main_section() const -> const Section & {
+    return _sections.front();
+}
+
+auto Manifest::sections() const -> const std::vector<Section> & {
+    return _sections;
+}
+
+auto Manifest::entry(std::string_view name) const -> const Section * {
+    auto found = _entries.find(name);
+    return found == _entries.end() ? nullptr : &_sections[found->second];
+}
+
+auto Manifest::value(std::string_view name) const -> std::optional<std::string_view> {
+    const auto *attribute = main_section().find(name);
+    if (!attribute) return std::nullopt;
+    return attribute->value;
+}
+
+void Manifest::set(std::string_view name, std::string_view value) {
+    _detach();
+    _modified = true;
+
+    auto &main = _sections.front();
+    main.raw = {};
+
+    auto found = std::find_if(main.attributes.begin(), main.attributes.end(), [&](const Attribute &attribute) {
+        return equals_ignore_case(attribute.name, name);
+    });
+
+    if (found == main.attributes.end()) {
+        main.attributes.push_back({_store(std::string(name)), _store(std::string(value)), {}});
+    } else {
+        found->value = _store(std::string(value));
+        found->raw = {};
+    }
+}
+
+auto Manifest::_store(std::string value) -> std::string_view {
+    return _storage->emplace_back(std::move(value));
+}
+
+void Manifest::_detach() {
+    if (_storage && _storage.use_count() == 1) return;
+
+    // Copies share the storage until one of them changes, which then moves the strings it refers to into storage of
+    // its own. The content is never changed and stays shared.
+    auto shared = std::move(_storage);
+    _storage = std::make_shared<std::deque<std::string>>();
+
+    auto in_content = [this](std::string_view view) {
+        if (view.empty()) return true;
+        if (!_content) return false;
+
+        std::less_equal<const char *> less_equal;
+        return less_equal(_content->data(), view.data())
+               && less_equal(view.data() + view.size(), _content->data() + _content->size());
+    };
+
+    for (auto &section: _sections) {
+        for (auto &attribute: section.attributes) {
+            if (!in_content(attribute.name)) attribute.name = _store(std::string(attribute.name));
+            if (!in_content(attribute.value)) attribute.value = _store(std::string(attribute.value));
+        }
+    }
+
+    _index_entries();
+}
+
+void Manifest::_index_entries() {
+    _entries.clear();
+    for (size_t index = 1; index < _sections.size(); index++) {
+        auto name = _sections[index].name();
+        if (!name.empty()) _entries.emplace(name, index);
+    }
+}
+
+void Manifest::_write_attribute(std::string &content, const Attribute &attribute, std::string_view line_break) {
+    if (!attribute.raw.empty()) {
+        content.append(attribute.raw);
+        return;
+    }
+
+    std::string line;
+    line.append(attribute.name).append(": ").append(attribute.value);
+
+    // Lines are at most 72 bytes, continuations start with a space and never split a UTF-8 sequence.
+    size_t offset = 0;
+    size_t limit = 72;
+    while (line.size() - offset > limit) {
+        auto end = offset + limit;
+        while (end > offset + 1 && (static_cast<uint8_t>(line[end]) & 0xC0) == 0x80) end--;
+
+        content.append(line, offset, end - offset).append(line_break).append(" ");
+        offset = end;
+        limit = 71;
+    }
+
+    content.append(line, offset).append(line_break);
+}
+
+JARFile::JARFile(const JARFile &other)
+        : others(other.others), classes(other.classes), streamed(other.streamed), manifest(other.manifest) {}
+
+auto JARFile::operator=(const JARFile &other) -> JARFile & {
+    if (this != &other) {
+        others = other.others;
+        classes = other.classes;
+        streamed = other.streamed;
+        manifest = other.manifest;
+        _nested.clear();
+    }
+
+    return *this;
+}
+
+auto JARFile::read_file(const std::string &path, zip_uint64_t streaming_threshold) -> JARFile {
     if (!boost::algorithm::iends_with(path, ".jar")) {
         throw std::invalid_argument("Warning: You can only enter \".jar\" files.");
     }
@@ -67,54 +303,243 @@ auto JARFile::read_file(const std::string &path) -> JARFile {
         throw std::runtime_error("Warning: Couldn't open the ZIP File: " + error_message);
     }
 
+    return _read_zip(zip, path, streaming_threshold);
+}
+
+auto JARFile::read_memory(const std::vector<uint8_t> &data) -> JARFile {
+    zip_error_t zip_error;
+    zip_error_init(&zip_error);
+
+    // The source only borrows the data, which outlives the archive as it is closed before returning.
+    zip_source_t *source = zip_source_buffer_create(data.data(), data.size(), 0, &zip_error);
+    zip_t *zip = source ? zip_open_from_source(source, ZIP_RDONLY, &zip_error) : nullptr;
+
+    if (!zip) {
+        if (source) zip_source_free(source);
+
+        std::string error_message = zip_error_strerror(&zip_error);
+        zip_error_fini(&zip_error);
+
+        throw std::runtime_error("Warning: Couldn't open the ZIP File from memory: " + error_message);
+    }
+
+    zip_error_fini(&zip_error);
+
+    // Nothing can be streamed from memory, as there is no path to reopen the archive from.
+    return _read_zip(zip, {}, std::numeric_limits<zip_uint64_t>::max());
+}
+
+auto JARFile::_read_zip(zip_t *zip, const std::string &path, zip_uint64_t streaming_threshold) -> JARFile {
     JARFile jar_file;
 
     zip_int64_t entries = zip_get_num_entries(zip, 0);
     for (zip_int64_t index = 0; index < entries; index++) {
-        const char *file_name = zip_get_name(zip, index, 0);
-        if (!file_name) continue;
-
-        std::string name(file_name);
-
+        // Entries are accessed by index, as name lookups get expensive for archives with a lot of entries.
         zip_stat_t stat;
         zip_stat_init(&stat);
-        if (zip_stat(zip, name.c_str(), 0, &stat) != 0) {
-            throw std::runtime_error("Warning: Failed to retrieve ZIP entry info for: " + name);
+        if (zip_stat_index(zip, index, 0, &stat) != 0 || !stat.name) {
+            continue;
         }
 
-        auto data = std::vector<uint8_t>(stat.size);
-        zip_file_t *file = zip_fopen(zip, name.c_str(), 0);
+        std::string name(stat.name);
+        if (!name.empty() && name.back() == '/') continue;
+
+        if (stat.size > streaming_threshold && name != "META-INF/MANIFEST.MF"
+            && !boost::algorithm::iends_with(name, ".class")) {
+            jar_file.streamed.emplace(name, StreamedEntry{path, index, stat.size});
+            continue;
+        }
+
+        if (stat.size > std::numeric_limits<size_t>::max()) {
+            zip_close(zip);
+            throw std::runtime_error("Warning: The ZIP entry is too large to be loaded: " + name);
+        }
+
+        zip_file_t *file = zip_fopen_index(zip, index, 0);
         if (!file) {
+            zip_close(zip);
             throw std::runtime_error("Warning: Failed to open file in ZIP: " + name);
         }
 
-        auto read = zip_fread(file, data.data(), stat.size);
+        // zip_fread may return less than requested, so read until the entry is exhausted.
+        auto data = std::vector<uint8_t>(stat.size);
+        zip_uint64_t offset = 0;
+        while (offset < stat.size) {
+            auto read = zip_fread(file, data.data() + offset, stat.size - offset);
+            if (read <= 0) break;
+
+            offset += read;
+        }
+
         zip_fclose(file);
 
-        if (read < 0) {
+        if (offset != stat.size) {
+            zip_close(zip);
             throw std::runtime_error("Failed to read data from ZIP file: " + name);
         }
 
-        if (name == "META-INF/MANIFEST.MF") {
-            auto content = std::string(reinterpret_cast<char *>(data.data()), stat.size);
-            jar_file.manifest = Manifest::read_manifest(content);
-        } else if (boost::algorithm::iends_with(name, ".class")) {
-            ClassFile class_file;
-            class_file.byte_code = std::move(data);
+        jar_file.add_entry(name, std::move(data));
+    }
 
-            ClassReader classReader;
-            classReader.visit_class(class_file);
-            assert(classReader.offset() == stat.size);
+    zip_close(zip);
 
-            jar_file.classes.emplace(name, class_file);
-        } else {
-            jar_file.others.emplace(name, std::move(data));
+    return jar_file;
+}
+
+auto JARFile::read_class(std::vector<uint8_t> data, bool verify) -> ClassFile {
+    ClassFile class_file;
+    class_file.byte_code = std::move(data);
+
+    ClassReader classReader(0, verify);
+    classReader.visit_class(class_file);
+    assert(classReader.offset() == class_file.byte_code.size());
+
+    return class_file;
+}
+
+void JARFile::add_entry(const std::string &name, std::vector<uint8_t> data) {
+    if (name == "META-INF/MANIFEST.MF") {
+        manifest = Manifest::read_manifest(std::string(reinterpret_cast<char *>(data.data()), data.size()));
+    } else if (boost::algorithm::iends_with(name, ".class")) {
+        classes.emplace(name, read_class(std::move(data)));
+    } else {
+        invalidate_nested(name);
+        streamed.erase(name);
+        others.emplace(name, std::move(data));
+    }
+}
+
+void JARFile::add_file(const std::string &name, const std::string &path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        throw std::invalid_argument("Warning: Couldn't read the size of the file: " + path);
+    }
+
+    invalidate_nested(name);
+    others.erase(name);
+    streamed.insert_or_assign(name, StreamedEntry{path, -1, size});
+}
+
+void JARFile::read_entry(const std::string &name,
+                         const std::function<void(const uint8_t *, size_t)> &consumer) const {
+    if (auto other = others.find(name); other != others.end()) {
+        consumer(other->second.data(), other->second.size());
+        return;
+    }
+
+    if (name == "META-INF/MANIFEST.MF") {
+        auto content = manifest.content();
+        consumer(reinterpret_cast<const uint8_t *>(content.data()), content.size());
+        return;
+    }
+
+    auto entry = streamed.find(name);
+    if (entry == streamed.end()) {
+        throw std::invalid_argument("Warning: There is no entry named: " + name);
+    }
+
+    const auto &streamed_entry = entry->second;
+    // At least one byte, as a read into an empty buffer never reaches the end of the data.
+    auto buffer = std::vector<uint8_t>(std::clamp<zip_uint64_t>(streamed_entry.size, 1, 1 << 20));
+
+    if (streamed_entry.index < 0) {
+        std::ifstream stream(streamed_entry.path, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("Warning: Couldn't open the file: " + streamed_entry.path);
+        }
+
+        while (stream.read(reinterpret_cast<char *>(buffer.data()), std::streamsize(buffer.size())).gcount() > 0) {
+            consumer(buffer.data(), stream.gcount());
         }
+
+        return;
+    }
+
+    int error = 0;
+    zip_t *zip = zip_open(streamed_entry.path.c_str(), ZIP_RDONLY, &error);
+    if (!zip) {
+        throw std::runtime_error("Warning: Couldn't reopen the ZIP File: " + streamed_entry.path);
+    }
+
+    zip_file_t *file = zip_fopen_index(zip, streamed_entry.index, 0);
+    if (!file) {
+        zip_close(zip);
+        throw std::runtime_error("Warning: Failed to open file in ZIP: " + name);
     }
 
+    zip_int64_t read;
+    while ((read = zip_fread(file, buffer.data(), buffer.size())) > 0) {
+        consumer(buffer.data(), read);
+    }
+
+    zip_fclose(file);
     zip_close(zip);
 
-    return jar_file;
+    if (read < 0) {
+        throw std::runtime_error("Failed to read data from ZIP file: " + name);
+    }
+}
+
+auto JARFile::nested_names() const -> std::vector<std::string> {
+    std::vector<std::string> names;
+    for (const auto &item: others) {
+        if (boost::algorithm::iends_with(item.first, ".jar")) {
+            names.push_back(item.first);
+        }
+    }
+
+    for (const auto &item: streamed) {
+        if (boost::algorithm::iends_with(item.first, ".jar")) {
+            names.push_back(item.first);
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void JARFile::invalidate_nested(const std::string &name) {
+    if (name.empty()) {
+        _nested.clear();
+    } else {
+        _nested.erase(name);
+    }
+}
+
+auto JARFile::nested(const std::string &name) -> JARFile & {
+    auto cached = _nested.find(name);
+    if (cached != _nested.end()) {
+        return *cached->second;
+    }
+
+    std::shared_ptr<JARFile> jar_file;
+    if (auto entry = others.find(name); entry != others.end()) {
+        jar_file = std::make_shared<JARFile>(read_memory(entry->second));
+    } else if (streamed.contains(name)) {
+        // libzip needs the whole archive to parse it, so a streamed nested JAR is loaded for its view.
+        std::vector<uint8_t> data;
+        read_entry(name, [&data](const uint8_t *chunk, size_t size) {
+            data.insert(data.end(), chunk, chunk + size);
+        });
+        jar_file = std::make_shared<JARFile>(read_memory(data));
+    } else {
+        throw std::invalid_argument("Warning: There is no nested JAR named: " + name);
+    }
+
+    return *_nested.emplace(name, std::move(jar_file)).first->second;
+}
+
+void JARFile::visit_classes(const std::function<void(const std::string &, ClassFile &)> &function) {
+    for (auto &class_file: classes) {
+        function(class_file.first, class_file.second);
+    }
+
+    for (const auto &name: nested_names()) {
+        nested(name).visit_classes([&](const std::string &class_name, ClassFile &class_file) {
+            function(name + "!/" + class_name, class_file);
+        });
+    }
 }
 
 auto JARFile::write_file(const std::string &path) -> void {
@@ -122,6 +547,13 @@ auto JARFile::write_file(const std::string &path) -> void {
         throw std::runtime_error("Warning: You can only enter \".jar\" files.");
     }
 
+    for (const auto &item: streamed) {
+        std::error_code error;
+        if (std::filesystem::equivalent(item.second.path, path, error)) {
+            throw std::invalid_argument("Warning: Streamed entries can't be written back into their origin: " + path);
+        }
+    }
+
     if (std::filesystem::exists(path)) {
         std::filesystem::remove(path);
     }
@@ -150,26 +582,70 @@ auto JARFile::write_file(const std::string &path) -> void {
         _add_to_zip(zip, item.first, item.second);
     }
 
+    // Streamed entries are copied straight from their origin while closing, so their sources have to stay open.
+    // ZIP_FL_COMPRESSED hands over the raw compressed data, which libzip copies without inflating it again.
+    std::unordered_map<std::string, zip_t *> origins;
+    auto close_origins = [&origins]() {
+        for (auto &origin: origins) {
+            zip_discard(origin.second);
+        }
+    };
+
+    for (auto &item: streamed) {
+        const auto &streamed_entry = item.second;
+
+        zip_source_t *source;
+        if (streamed_entry.index < 0) {
+            source = zip_source_file(zip, streamed_entry.path.c_str(), 0, -1);
+        } else {
+            auto &origin = origins[streamed_entry.path];
+            if (!origin) {
+                origin = zip_open(streamed_entry.path.c_str(), ZIP_RDONLY, &error);
+            }
+
+            source = origin ? zip_source_zip_file(zip, origin, streamed_entry.index, ZIP_FL_COMPRESSED, 0, -1,
+                                                        nullptr) : nullptr;
+        }
+
+        if (!source || zip_file_add(zip, item.first.c_str(), source, ZIP_FL_OVERWRITE) < 0) {
+            if (source) zip_source_free(source);
+
+            std::string error_message = zip_strerror(zip);
+            zip_discard(zip);
+            close_origins();
+
+            throw std::runtime_error("Warning: Error adding streamed file to zip: " + error_message);
+        }
+    }
+
     auto manifest_content = manifest.content();
     std::vector<uint8_t> content(manifest_content.begin(), manifest_content.end());
 
     _add_to_zip(zip, "META-INF/MANIFEST.MF", content);
 
     if (zip_close(zip) < 0) {
+        zip_discard(zip);
+        close_origins();
+
         throw std::runtime_error("Warning: Failed to close the ZIP archive.");
     }
+
+    close_origins();
 }
 
 void JARFile::_add_to_zip(zip_t *zip, const std::string &file_name, const std::vector<uint8_t> &data) {
     // Weird workaround. zip_file_add is not directly using the data and instead stores it until zip_close is being called.
     // The problem is that data is not always present (like generating bytecode using ClassWriter in a for loop).
-    auto *data_copy = new uint8_t[data.size()];
+    // The copy is owned by the source, which frees it once it isn't needed anymore.
+    auto *data_copy = static_cast<uint8_t *>(std::malloc(std::max<size_t>(data.size(), 1)));
     if (!data.empty()) {
         std::memcpy(data_copy, data.data(), data.size());
     }
 
-    zip_source_t *source = zip_source_buffer(zip, data_copy, data.size(), 0);
+    zip_source_t *source = zip_source_buffer(zip, data_copy, data.size(), 1);
     if (!source) {
+        std::free(data_copy);
+
         std::string error_message = zip_strerror(zip);
         throw std::runtime_error("Warning: Error creating source: " + error_message);
     }
@@ -1,178 +1,303 @@
 #include "vm_check.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+
+#include "constant_pool_table.h"
+#include "bootstrap_methods.h"
+#include "parallel.h"
 
 using namespace ares;
 
+VMCheck::VMCheck(Mode mode) : _mode(mode) {}
+
+auto VMCheck::verify(JARFile &jar_file, unsigned int thread_count) -> std::vector<Diagnostic> {
+    std::vector<std::pair<const std::string, ClassFile> *> class_files;
+    class_files.reserve(jar_file.classes.size());
+    for (auto &class_file: jar_file.classes) {
+        class_files.push_back(&class_file);
+    }
+
+    std::vector<Diagnostic> report;
+    std::mutex report_mutex;
+
+    parallel_for(class_files.size(), [&](size_t index) {
+        auto &[name, class_file] = *class_files[index];
+
+        VMCheck vm_check(VMCheck::COLLECT);
+        vm_check.visit_class(class_file);
+        if (vm_check._diagnostics.empty()) return;
+
+        // The entry identifies the class even if its "this class" index is broken.
+        for (auto &diagnostic: vm_check._diagnostics) {
+            diagnostic.entry = name;
+        }
+
+        std::lock_guard<std::mutex> lock(report_mutex);
+        report.insert(report.end(), std::make_move_iterator(vm_check._diagnostics.begin()),
+                      std::make_move_iterator(vm_check._diagnostics.end()));
+    }, thread_count);
+
+    std::sort(report.begin(), report.end());
+    return report;
+}
+
+auto VMCheck::diagnostics() const -> const std::vector<Diagnostic> & {
+    return _diagnostics;
+}
+
 void VMCheck::visit_class(ClassFile &class_file) {
+    VMCheck::check_magic_number(class_file);
+    VMCheck::check_class_version(class_file);
+
+    VMCheck::check_constant_pool(class_file);
+    VMCheck::check_access_flags(class_file);
+    VMCheck::check_this_class(class_file);
+    VMCheck::check_super_class(class_file);
+
+    for (auto &interface : class_file.interfaces)
+        VMCheck::visit_class_interface(class_file, interface);
+
+    for (auto &field_info : class_file.fields)
+        VMCheck::visit_class_field(class_file, field_info);
+
+    for (auto &method_info : class_file.methods)
+        VMCheck::visit_class_method(class_file, method_info);
+
+    for (auto &attribute_info : class_file.attributes)
+        VMCheck::visit_class_attribute(class_file, attribute_info);
+
+    VMCheck::check_bootstrap_methods(class_file);
+}
+
+void VMCheck::check_magic_number(ClassFile &class_file) {
+    // Every pass over a class starts here, even if the class file reuses the address of the previous one.
+    _reset(class_file);
+
     if (class_file.magic_number != 0xCAFEBABE) {
-        std::cerr << "The magic number doesn't match \"0xCAFEBABE\"." << std::endl;
-        abort();
+        _report(class_file, 0, "The magic number doesn't match \"0xCAFEBABE\".");
     }
+}
 
+void VMCheck::check_class_version(ClassFile &class_file) {
     if (class_file.class_version == ClassFile::UNDEFINED) {
-        std::cerr << "Couldn't set the class file version because it is an undefined value."
-                  << std::endl;
-        abort();
+        _report(class_file, 0, "Couldn't set the class file version because it is an undefined value.");
     }
 
     if (class_file.class_version > ClassFile::VERSION_12
         && (class_file.minor_version != 0 && class_file.minor_version != 65535)) {
-        std::cerr << "All Java 12 class files need a minor version of 0 or 65535." << std::endl;
-        abort();
+        _report(class_file, 0, "All Java 12 class files need a minor version of 0 or 65535.");
+    }
+}
+
+void VMCheck::check_constant_pool(ClassFile &class_file) {
+    // Names are compared by their flags afterward instead of materializing and comparing the strings each time.
+    _class_file = &class_file;
+    _utf8_flags.assign(class_file.constant_pool.size() + 1, 0);
+    for (size_t index = 1; index < _utf8_flags.size(); index++) {
+        _utf8_flags[index] = _compute_utf8_flags(class_file.utf8(index));
+    }
+
+    _descriptors.reset(class_file);
+
+    // The plain references are validated in bulk, the remaining entries one by one.
+    ConstantPoolTable table(class_file);
+    for (const auto &result: table.validate()) {
+        _constant_pool_index = result.index;
+        _report_references(class_file, table.tag(result.index), result.violations);
+        _constant_pool_index = 0;
     }
 
-    for (auto &constantPoolInfo : class_file.constant_pool)
+    for (auto &constantPoolInfo : class_file.constant_pool) {
+        if (ConstantPoolTable::covers(constantPoolInfo.tag)) continue;
         VMCheck::visit_classpool_info(class_file, constantPoolInfo);
+    }
+}
 
+void VMCheck::check_bootstrap_methods(ClassFile &class_file) {
+    auto bootstrapMethods = BootstrapMethods::read(class_file);
+    if (!bootstrapMethods) {
+        _report(class_file, 0, "The BootstrapMethods attribute is malformed or present more than once.");
+        return;
+    }
+
+    for (size_t index = 0; index < bootstrapMethods->size(); index++) {
+        auto method = bootstrapMethods->method(index);
+        if (!class_file.is_valid_index(method.method_ref)
+            || class_file.constant_pool[method.method_ref - 1].tag != ConstantPoolInfo::METHOD_HANDLE) {
+            _report(class_file, method.method_ref, "The bootstrap method is not a method handle constant pool info.");
+        }
+
+        for (auto argument : method.arguments) {
+            if (!class_file.is_valid_index(argument)) {
+                _report(class_file, argument, "The bootstrap argument is not a valid constant pool index.");
+                continue;
+            }
+
+            switch (class_file.constant_pool[argument - 1].tag) {
+                case ConstantPoolInfo::INTEGER:
+                case ConstantPoolInfo::FLOAT:
+                case ConstantPoolInfo::LONG:
+                case ConstantPoolInfo::DOUBLE:
+                case ConstantPoolInfo::CLASS:
+                case ConstantPoolInfo::STRING:
+                case ConstantPoolInfo::METHOD_HANDLE:
+                case ConstantPoolInfo::METHOD_TYPE:
+                case ConstantPoolInfo::DYNAMIC:
+                    break;
+                default:
+                    _report(class_file, argument, "The bootstrap argument is not a loadable constant pool info.");
+            }
+        }
+    }
+
+    for (size_t index = 0; index < class_file.constant_pool.size(); index++) {
+        const auto &constantPoolInfo = class_file.constant_pool[index];
+        if (constantPoolInfo.tag != ConstantPoolInfo::DYNAMIC
+            && constantPoolInfo.tag != ConstantPoolInfo::INVOKE_DYNAMIC) {
+            continue;
+        }
+
+        if (constantPoolInfo.info.dynamic_info.boostrap_method_attr_index >= bootstrapMethods->size()) {
+            _report(class_file, static_cast<uint16_t>(index + 1),
+                    "The bootstrap method index is not a valid BootstrapMethods index.");
+        }
+    }
+}
+
+void VMCheck::check_access_flags(ClassFile &class_file) {
     if (class_file.has_access_flag(ClassFile::INTERFACE)) {
         if (!class_file.has_access_flag(ClassFile::ABSTRACT)
             || class_file.has_access_flag(ClassFile::FINAL)
             || class_file.has_access_flag(ClassFile::SUPER)
             || class_file.has_access_flag(ClassFile::ENUM)
             || class_file.has_access_flag(ClassFile::MODULE)) {
-            std::cerr << "The class file has invalid interface access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The class file has invalid interface access flags.");
         }
     } else if (class_file.has_access_flag(ClassFile::ANNOTATION)) {
         if (!class_file.has_access_flag(ClassFile::INTERFACE)
             || class_file.has_access_flag(ClassFile::ABSTRACT)
             || class_file.has_access_flag(ClassFile::FINAL)) {
-            std::cerr << "The class file has invalid annotation access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The class file has invalid annotation access flags.");
         }
     } else if (class_file.has_access_flag(ClassFile::MODULE)) {
         if (class_file.has_access_flag(ClassFile::ABSTRACT)
             || class_file.has_access_flag(ClassFile::FINAL)) {
-            std::cerr << "The class file has invalid module access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The class file has invalid module access flags.");
         }
     }
+}
 
+void VMCheck::check_this_class(ClassFile &class_file) {
     if (!class_file.is_valid_index(class_file.this_class)) {
-        std::cerr << "The \"this class\" index is not a valid constant pool index." << std::endl;
-        abort();
+        _report(class_file, class_file.this_class, "The \"this class\" index is not a valid constant pool index.");
+        return;
     }
 
-    auto thisClass = class_file.constant_pool[class_file.this_class - 1];
+    const auto &thisClass = class_file.constant_pool[class_file.this_class - 1];
     if (thisClass.tag != ConstantPoolInfo::CLASS) {
-        std::cerr << "The \"this class\" is not a class constant pool info." << std::endl;
-        abort();
+        _report(class_file, class_file.this_class, "The \"this class\" is not a class constant pool info.");
     }
+}
 
+void VMCheck::check_super_class(ClassFile &class_file) {
     if (class_file.super_class != 0) {
         if (!class_file.is_valid_index(class_file.super_class)) {
-            std::cerr << "The \"super class\" index is not a valid constant pool index."
-                      << std::endl;
-            abort();
+            _report(class_file, class_file.super_class,
+                    "The \"super class\" index is not a valid constant pool index.");
+            return;
         }
 
-        auto superClass = class_file.constant_pool[class_file.super_class - 1];
+        const auto &superClass = class_file.constant_pool[class_file.super_class - 1];
         if (superClass.tag != ConstantPoolInfo::CLASS) {
-            std::cerr << "The \"super class\" is not a class constant pool info." << std::endl;
-            abort();
+            _report(class_file, class_file.super_class, "The \"super class\" is not a class constant pool info.");
         }
     }
-
-    for (auto &interface : class_file.interfaces)
-        VMCheck::visit_class_interface(class_file, interface);
-
-    for (auto &field_info : class_file.fields)
-        VMCheck::visit_class_field(class_file, field_info);
-
-    for (auto &method_info : class_file.methods)
-        VMCheck::visit_class_method(class_file, method_info);
-
-    for (auto &attribute_info : class_file.attributes)
-        VMCheck::visit_class_attribute(class_file, attribute_info);
 }
 
 void VMCheck::visit_class_interface(ClassFile &class_file, uint16_t interface) {
     if (!class_file.is_valid_index(interface)) {
-        std::cerr << "The interface index is not a valid constant pool index." << std::endl;
-        abort();
+        _report(class_file, interface, "The interface index is not a valid constant pool index.");
+        return;
     }
 
-    auto constantPoolInfo = class_file.constant_pool[interface - 1];
+    const auto &constantPoolInfo = class_file.constant_pool[interface - 1];
     if (constantPoolInfo.tag != ConstantPoolInfo::CLASS) {
-        std::cerr << "The interface is not a class constant pool info." << std::endl;
-        abort();
+        _report(class_file, interface, "The interface is not a class constant pool info.");
     }
 }
 
 void VMCheck::visit_class_field(ClassFile &class_file, FieldInfo &field_info) {
+    _enter_class(class_file);
+    _enter_member(class_file, field_info.name_index, field_info.descriptor_index);
+
     if (field_info.has_access_flag(FieldInfo::PUBLIC)) {
         if (field_info.has_access_flag(FieldInfo::PRIVATE) || field_info.has_access_flag(FieldInfo::PROTECTED)) {
-            std::cerr << "The field has invalid public access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The field has invalid public access flags.");
         }
     } else if (field_info.has_access_flag(FieldInfo::PRIVATE)) {
         if (field_info.has_access_flag(FieldInfo::PUBLIC) || field_info.has_access_flag(FieldInfo::PROTECTED)) {
-            std::cerr << "The field has invalid private access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The field has invalid private access flags.");
         }
     } else if (field_info.has_access_flag(FieldInfo::PROTECTED)) {
         if (field_info.has_access_flag(FieldInfo::PUBLIC) || field_info.has_access_flag(FieldInfo::PRIVATE)) {
-            std::cerr << "The field has invalid protected access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The field has invalid protected access flags.");
         }
     }
 
     if (class_file.has_access_flag(ClassFile::INTERFACE)) {
         if (!field_info.has_access_flag(FieldInfo::PUBLIC) || !field_info.has_access_flag(FieldInfo::STATIC)
             || !field_info.has_access_flag(FieldInfo::FINAL)) {
-            std::cerr << "Fields of interfaces need to have public, static and final access "
-                         "modifier set." << std::endl;
-            abort();
+            _report(class_file, 0, "Fields of interfaces need to have public, static and final access "
+                                   "modifier set.");
         }
     }
 
     if (!class_file.is_valid_index(field_info.name_index)) {
-        std::cerr << "The name index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-
-    auto fieldName = class_file.constant_pool[field_info.name_index - 1];
-    if (fieldName.tag != ConstantPoolInfo::UTF_8) {
-        std::cerr << "The name is not a utf8 class pool info." << std::endl;
-        abort();
+        _report(class_file, field_info.name_index, "The name index is not a valid constant pool index.");
+    } else {
+        const auto &fieldName = class_file.constant_pool[field_info.name_index - 1];
+        if (fieldName.tag != ConstantPoolInfo::UTF_8) {
+            _report(class_file, field_info.name_index, "The name is not a utf8 class pool info.");
+        }
     }
 
     if (!class_file.is_valid_index(field_info.descriptor_index)) {
-        std::cerr << "The descriptor index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-
-    auto fieldDescriptor = class_file.constant_pool[field_info.descriptor_index - 1];
-    if (fieldDescriptor.tag != ConstantPoolInfo::UTF_8) {
-        std::cerr << "The descriptor is not a utf8 class pool info." << std::endl;
-        abort();
+        _report(class_file, field_info.descriptor_index, "The descriptor index is not a valid constant pool index.");
+    } else {
+        const auto &fieldDescriptor = class_file.constant_pool[field_info.descriptor_index - 1];
+        if (fieldDescriptor.tag != ConstantPoolInfo::UTF_8) {
+            _report(class_file, field_info.descriptor_index, "The descriptor is not a utf8 class pool info.");
+        } else if (!_descriptors.field(class_file, field_info.descriptor_index)) {
+            _report(class_file, field_info.descriptor_index, "The descriptor is not a valid field descriptor.");
+        }
     }
 
     for (auto &attribute : field_info.attributes)
         VMCheck::visit_field_attribute(class_file, field_info, *attribute);
+
+    _member.clear();
 }
 
-// TODO: Do checks for the descriptor_index in
-//  https://docs.oracle.com/javase/specs/jvms/se15/html/jvms-4.html#jvms-4.6
 void VMCheck::visit_class_method(ClassFile &class_file, MethodInfo &method_info) {
+    _enter_class(class_file);
+    _enter_member(class_file, method_info.name_index, method_info.descriptor_index);
+
     if (method_info.has_access_flag(MethodInfo::PUBLIC)) {
         if (method_info.has_access_flag(MethodInfo::PRIVATE)
             || method_info.has_access_flag(MethodInfo::PROTECTED)) {
-            std::cerr << "The method has invalid public access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The method has invalid public access flags.");
         }
     } else if (method_info.has_access_flag(MethodInfo::PRIVATE)) {
         if (method_info.has_access_flag(MethodInfo::PUBLIC)
             || method_info.has_access_flag(MethodInfo::PROTECTED)) {
-            std::cerr << "The method has invalid private access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The method has invalid private access flags.");
         }
     } else if (method_info.has_access_flag(MethodInfo::PROTECTED)) {
         if (method_info.has_access_flag(MethodInfo::PUBLIC)
             || method_info.has_access_flag(MethodInfo::PRIVATE)) {
-            std::cerr << "The method has invalid protected access flags." << std::endl;
-            abort();
+            _report(class_file, 0, "The method has invalid protected access flags.");
         }
     }
 
@@ -181,23 +306,18 @@ void VMCheck::visit_class_method(ClassFile &class_file, MethodInfo &method_info)
             || method_info.has_access_flag(MethodInfo::FINAL)
             || method_info.has_access_flag(MethodInfo::SYNCHRONIZED)
             || method_info.has_access_flag(MethodInfo::NATIVE)) {
-            std::cerr << "The access flags for an interface methods are invalid." << std::endl;
-            abort();
+            _report(class_file, 0, "The access flags for an interface methods are invalid.");
         }
 
         if (class_file.class_version < ClassFile::VERSION_8) {
             if (!method_info.has_access_flag(MethodInfo::PUBLIC)
                 || !method_info.has_access_flag(MethodInfo::ABSTRACT)) {
-                std::cerr << "The access flags for an interface methods are invalid."
-                          << std::endl;
-                abort();
+                _report(class_file, 0, "The access flags for an interface methods are invalid.");
             }
         } else if (class_file.class_version >= ClassFile::VERSION_8) {
             if (method_info.has_access_flag(MethodInfo::PUBLIC)
                 && method_info.has_access_flag(MethodInfo::PRIVATE)) {
-                std::cerr << "The access flags for an interface methods are invalid."
-                          << std::endl;
-                abort();
+                _report(class_file, 0, "The access flags for an interface methods are invalid.");
             }
         }
     }
@@ -209,63 +329,66 @@ void VMCheck::visit_class_method(ClassFile &class_file, MethodInfo &method_info)
             || method_info.has_access_flag(MethodInfo::SYNCHRONIZED)
             || method_info.has_access_flag(MethodInfo::NATIVE)
             || method_info.has_access_flag(MethodInfo::STRICT)) {
-            std::cerr << "The access flags for an interface methods are invalid."
-                      << std::endl;
-            abort();
+            _report(class_file, 0, "The access flags for an interface methods are invalid.");
         }
     }
 
     if (!class_file.is_valid_index(method_info.name_index)) {
-        std::cerr << "The name index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-
-    auto methodName = class_file.constant_pool[method_info.name_index - 1];
-    if (methodName.tag != ConstantPoolInfo::UTF_8) {
-        std::cerr << "The name index is not a utf8 constant pool info." << std::endl;
-        abort();
-    }
-
-    std::string name;
-    name.assign((char *) methodName.info.utf8_info.bytes, methodName.info.utf8_info.length);
-    if (name == "<init>") {
-        if (method_info.has_access_flag(MethodInfo::ABSTRACT)
-            || method_info.has_access_flag(MethodInfo::NATIVE)
-            || method_info.has_access_flag(MethodInfo::BRIDGE)
-            || method_info.has_access_flag(MethodInfo::SYNCHRONIZED)
-            || method_info.has_access_flag(MethodInfo::FINAL)
-            || method_info.has_access_flag(MethodInfo::STATIC)) {
-            std::cerr << "The access flags for an interface methods are invalid."
-                      << std::endl;
-            abort();
+        _report(class_file, method_info.name_index, "The name index is not a valid constant pool index.");
+    } else {
+        const auto &methodName = class_file.constant_pool[method_info.name_index - 1];
+        if (methodName.tag != ConstantPoolInfo::UTF_8) {
+            _report(class_file, method_info.name_index, "The name index is not a utf8 constant pool info.");
+        } else {
+            if (_utf8_flags_of(class_file, method_info.name_index) & VMCheck::IS_INIT) {
+                if (method_info.has_access_flag(MethodInfo::ABSTRACT)
+                    || method_info.has_access_flag(MethodInfo::NATIVE)
+                    || method_info.has_access_flag(MethodInfo::BRIDGE)
+                    || method_info.has_access_flag(MethodInfo::SYNCHRONIZED)
+                    || method_info.has_access_flag(MethodInfo::FINAL)
+                    || method_info.has_access_flag(MethodInfo::STATIC)) {
+                    _report(class_file, 0, "The access flags for an interface methods are invalid.");
+                }
+            }
         }
     }
 
     if (!class_file.is_valid_index(method_info.descriptor_index)) {
-        std::cerr << "The descriptor index is not a valid constant pool index." << std::endl;
-        abort();
-    }
+        _report(class_file, method_info.descriptor_index, "The descriptor index is not a valid constant pool index.");
+    } else {
+        const auto &methodDescriptor = class_file.constant_pool[method_info.descriptor_index - 1];
+        if (methodDescriptor.tag != ConstantPoolInfo::UTF_8) {
+            _report(class_file, method_info.descriptor_index, "The name index is not a utf8 constant pool info.");
+        } else if (auto descriptor = _descriptors.method(class_file, method_info.descriptor_index); !descriptor) {
+            _report(class_file, method_info.descriptor_index, "The descriptor is not a valid method descriptor.");
+        } else {
+            auto slots = descriptor->parameter_slots + (method_info.has_access_flag(MethodInfo::STATIC) ? 0 : 1);
+            if (slots > 255) {
+                _report(class_file, method_info.descriptor_index, "The method has more than 255 parameter slots.");
+            }
 
-    auto methodDescriptor = class_file.constant_pool[method_info.descriptor_index - 1];
-    if (methodDescriptor.tag != ConstantPoolInfo::UTF_8) {
-        std::cerr << "The name index is not a utf8 constant pool info." << std::endl;
-        abort();
+            auto nameFlags = _utf8_flags_of(class_file, method_info.name_index);
+            if ((nameFlags & (VMCheck::IS_INIT | VMCheck::IS_CLINIT)) && descriptor->return_kind != Descriptor::VOID) {
+                _report(class_file, method_info.descriptor_index, "Initialization methods need to return void.");
+            }
+        }
     }
 
     for (auto &attribute_info : method_info.attributes)
         VMCheck::visit_method_attribute(class_file, method_info, attribute_info);
+
+    _member.clear();
 }
 
 void VMCheck::visit_class_attribute(ClassFile &class_file, AttributeInfo &attribute_info) {
     if (!class_file.is_valid_index(attribute_info.attribute_name_index)) {
-        std::cerr << "The name index is not a valid constant pool index." << std::endl;
-        abort();
+        _report(class_file, attribute_info.attribute_name_index, "The name index is not a valid constant pool index.");
+        return;
     }
 
-    auto attributeName = class_file.constant_pool[attribute_info.attribute_name_index - 1];
+    const auto &attributeName = class_file.constant_pool[attribute_info.attribute_name_index - 1];
     if (attributeName.tag != ConstantPoolInfo::UTF_8) {
-        std::cerr << "The name index is not a utf8 class pool info." << std::endl;
-        abort();
+        _report(class_file, attribute_info.attribute_name_index, "The name index is not a utf8 class pool info.");
     }
 }
 
@@ -278,29 +401,10 @@ void VMCheck::visit_method_attribute(ClassFile &class_file, MethodInfo &, Attrib
 }
 
 void VMCheck::visit_classpool_info(ClassFile &class_file, ConstantPoolInfo &constantPoolInfo) {
+    // Diagnostics of an entry refer to the entry itself, as its contents are what is broken.
+    _constant_pool_index = static_cast<uint16_t>(&constantPoolInfo - class_file.constant_pool.data() + 1);
+
     switch (constantPoolInfo.tag) {
-        case ConstantPoolInfo::CLASS: {
-            VMCheck::visit_class_info(class_file, constantPoolInfo.info.class_info);
-            break;
-        }
-        case ConstantPoolInfo::FIELD_REF:
-        case ConstantPoolInfo::METHOD_REF:
-        case ConstantPoolInfo::INTERFACE_METHOD_REF: {
-            VMCheck::visit_field_method_info(class_file, constantPoolInfo.info.field_method_info);
-            break;
-        }
-        case ConstantPoolInfo::NAME_AND_TYPE: {
-            VMCheck::visit_name_and_type_info(class_file, constantPoolInfo.info.name_and_type_info);
-            break;
-        }
-        case ConstantPoolInfo::STRING: {
-            VMCheck::visit_string_info(class_file, constantPoolInfo.info.string_info);
-            break;
-        }
-        case ConstantPoolInfo::METHOD_TYPE: {
-            VMCheck::visit_method_type_info(class_file, constantPoolInfo.info.method_type_info);
-            break;
-        }
         case ConstantPoolInfo::METHOD_HANDLE: {
             VMCheck::visit_method_handle_info(class_file, constantPoolInfo.info.method_handle_info);
             break;
@@ -310,9 +414,19 @@ void VMCheck::visit_classpool_info(ClassFile &class_file, ConstantPoolInfo &cons
             VMCheck::visit_dynamic_info(class_file, constantPoolInfo.info.dynamic_info);
             break;
         }
+        case ConstantPoolInfo::CLASS:
+        case ConstantPoolInfo::FIELD_REF:
+        case ConstantPoolInfo::METHOD_REF:
+        case ConstantPoolInfo::INTERFACE_METHOD_REF:
+        case ConstantPoolInfo::NAME_AND_TYPE:
+        case ConstantPoolInfo::STRING:
+        case ConstantPoolInfo::METHOD_TYPE:
         case ConstantPoolInfo::MODULE:
         case ConstantPoolInfo::PACKAGE: {
-            VMCheck::visit_module_package_info(class_file, constantPoolInfo.info.module_package_info);
+            // check_constant_pool skips these and validates them through the ConstantPoolTable, this path only
+            // serves direct calls for a single entry.
+            _report_references(class_file, constantPoolInfo.tag,
+                               ConstantPoolTable::validate_entry(class_file, constantPoolInfo));
             break;
         }
         case ConstantPoolInfo::UTF_8:
@@ -326,65 +440,24 @@ void VMCheck::visit_classpool_info(ClassFile &class_file, ConstantPoolInfo &cons
             break;
         }
     }
-}
-
-void VMCheck::visit_class_info(ClassFile &class_file, ConstantInfo::ClassInfo &info) {
-    if (!class_file.is_valid_index(info.name_index)) {
-        std::cout << "The name index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-}
 
-void VMCheck::visit_field_method_info(ClassFile &class_file, ConstantInfo::FieldMethodInfo &info) {
-    if (!class_file.is_valid_index(info.class_index)) {
-        std::cerr << "The class index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-
-    if (!class_file.is_valid_index(info.name_and_type_index)) {
-        std::cerr << "The name and type index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-}
-
-void VMCheck::visit_name_and_type_info(ClassFile &class_file, ConstantInfo::NameAndTypeInfo &info) {
-    if (!class_file.is_valid_index(info.name_index)) {
-        std::cerr << "The name index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-
-    if (!class_file.is_valid_index(info.descriptor_index)) {
-        std::cerr << "The descriptor index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-}
-
-void VMCheck::visit_string_info(ClassFile &class_file, ConstantInfo::StringInfo &info) {
-    if (!class_file.is_valid_index(info.string_index)) {
-        std::cerr << "The string index is not a valid constant pool index." << std::endl;
-        abort();
-    }
-}
-
-void VMCheck::visit_method_type_info(ClassFile &class_file, ConstantInfo::MethodTypeInfo &info) {
-    if (!class_file.is_valid_index(info.descriptor_index)) {
-        std::cerr << "The descriptor index is not a valid constant pool index" << std::endl;
-        abort();
-    }
+    _constant_pool_index = 0;
 }
 
 void VMCheck::visit_method_handle_info(ClassFile &class_file, ConstantInfo::MethodHandleInfo &info) {
+    _enter_class(class_file);
+
     if (info.reference_kind < 1 || info.reference_kind > 9) {
-        std::cerr << "The reference kind is not in range of 0 to 9." << std::endl;
-        abort();
+        _report(class_file, 0, "The reference kind is not in range of 0 to 9.");
+        return;
     }
 
     if (!class_file.is_valid_index(info.reference_index)) {
-        std::cerr << "The reference index is not a valid constant pool index." << std::endl;
-        abort();
+        _report(class_file, 0, "The reference index is not a valid constant pool index.");
+        return;
     }
 
-    auto constantPoolInfo = class_file.constant_pool[info.reference_index - 1];
+    const auto &constantPoolInfo = class_file.constant_pool[info.reference_index - 1];
     auto referenceKind = info.reference_kind;
 
     if (referenceKind == ConstantInfo::MethodHandleKind::GetField
@@ -392,35 +465,32 @@ void VMCheck::visit_method_handle_info(ClassFile &class_file, ConstantInfo::Meth
         || referenceKind == ConstantInfo::MethodHandleKind::PutField
         || referenceKind == ConstantInfo::MethodHandleKind::PutStatic) {
         if (constantPoolInfo.tag != ConstantPoolInfo::FIELD_REF) {
-            std::cerr << "The reference index of the method handle needs to be a field ref."
-                      << std::endl;
-            abort();
+            _report(class_file, 0, "The reference index of the method handle needs to be a field ref.");
+            return;
         }
     } else if (referenceKind == ConstantInfo::MethodHandleKind::InvokeVirtual
                || referenceKind == ConstantInfo::MethodHandleKind::NewInvokeSpecial) {
-        if (constantPoolInfo.tag != ConstantPoolInfo::FIELD_REF) {
-            std::cerr << "The reference index of the method handle needs to be a method ref."
-                      << std::endl;
-            abort();
+        if (constantPoolInfo.tag != ConstantPoolInfo::METHOD_REF) {
+            _report(class_file, 0, "The reference index of the method handle needs to be a method ref.");
+            return;
         }
     } else if (referenceKind == ConstantInfo::MethodHandleKind::InvokeStatic
                || referenceKind == ConstantInfo::MethodHandleKind::InvokeSpecial) {
         if (class_file.class_version < ClassFile::VERSION_8
             && constantPoolInfo.tag != ConstantPoolInfo::METHOD_REF) {
-            std::cerr << "The reference index of the method handle needs to be a method ref."
-                      << std::endl;
-            abort();
+            _report(class_file, 0, "The reference index of the method handle needs to be a method ref.");
+            return;
         } else if (constantPoolInfo.tag != ConstantPoolInfo::METHOD_REF
                    && constantPoolInfo.tag != ConstantPoolInfo::INTERFACE_METHOD_REF) {
-            std::cerr << "The reference index of the method handle needs to be a method ref or "
-                         "interface method ref." << std::endl;
-            abort();
+            _report(class_file, 0, "The reference index of the method handle needs to be a method ref or "
+                                   "interface method ref.");
+            return;
         }
     } else if (referenceKind == ConstantInfo::MethodHandleKind::InvokeInterface) {
         if (constantPoolInfo.tag != ConstantPoolInfo::INTERFACE_METHOD_REF) {
-            std::cerr << "The reference index of the method handle needs to be a interface method "
-                         "ref." << std::endl;
-            abort();
+            _report(class_file, 0, "The reference index of the method handle needs to be a interface method "
+                                   "ref.");
+            return;
         }
     }
 
@@ -429,42 +499,110 @@ void VMCheck::visit_method_handle_info(ClassFile &class_file, ConstantInfo::Meth
         || referenceKind == ConstantInfo::MethodHandleKind::InvokeSpecial
         || referenceKind == ConstantInfo::MethodHandleKind::InvokeInterface
         || referenceKind == ConstantInfo::MethodHandleKind::NewInvokeSpecial) {
-        auto nameAndType = class_file.constant_pool[
-            constantPoolInfo.info.field_method_info.name_and_type_index - 1];
-        auto nameUTF8 = class_file.constant_pool[
-            nameAndType.info.name_and_type_info.name_index - 1];
+        // The referenced entries are checked on their own, broken ones are just skipped here.
+        auto nameAndTypeIndex = constantPoolInfo.info.field_method_info.name_and_type_index;
+        if (!class_file.is_valid_index(nameAndTypeIndex)) return;
+
+        const auto &nameAndType = class_file.constant_pool[nameAndTypeIndex - 1];
+        if (nameAndType.tag != ConstantPoolInfo::NAME_AND_TYPE) return;
 
-        std::string name;
-        name.assign((char *) nameUTF8.info.utf8_info.bytes, nameUTF8.info.utf8_info.length);
+        auto nameFlags = _utf8_flags_of(class_file, nameAndType.info.name_and_type_info.name_index);
 
         if (referenceKind == ConstantInfo::MethodHandleKind::NewInvokeSpecial) {
-            if (name != "<init>") {
-                std::cerr << "The name of the method ref must be \"<init>\"" << std::endl;
-                abort();
+            if (!(nameFlags & VMCheck::IS_INIT)) {
+                _report(class_file, 0, "The name of the method ref must be \"<init>\"");
             }
         } else {
-            if (name == "<init>" || name == "<clinit>") {
-                std::cerr << R"(The name of the method ref can't be "<init>" or "<clinit>".)"
-                          << std::endl;
-                abort();
+            if (nameFlags & (VMCheck::IS_INIT | VMCheck::IS_CLINIT)) {
+                _report(class_file, 0, R"(The name of the method ref can't be "<init>" or "<clinit>".)");
             }
         }
     }
 }
 
-// TODO: Check if the bootstrap method index if correct.
+// The bootstrap method index is checked by check_bootstrap_methods, as the attribute is decoded last.
 void VMCheck::visit_dynamic_info(ClassFile &class_file, ConstantInfo::DynamicInfo &info) {
     if (!class_file.is_valid_index(info.name_and_type_index)) {
-        std::cerr << "The name and type index is not a valid constant pool index." << std::endl;
-        abort();
+        _report(class_file, 0, "The name and type index is not a valid constant pool index.");
+        return;
+    }
+
+    const auto &nameAndType = class_file.constant_pool[info.name_and_type_index - 1];
+    if (nameAndType.tag != ConstantPoolInfo::NAME_AND_TYPE) {
+        _report(class_file, 0, "The name and type index is not a name and type constant pool info.");
     }
 }
 
-void VMCheck::visit_module_package_info(ClassFile &class_file, ConstantInfo::ModulePackageInfo &info) {
-    if (!class_file.is_valid_index(info.name_index)) {
-        std::cerr << "The name index is not a valid constant pool index." << std::endl;
+void VMCheck::_report_references(ClassFile &class_file, uint8_t tag, uint8_t violations) {
+    auto first = (violations & ConstantPoolTable::FIRST) != 0;
+    auto second = (violations & ConstantPoolTable::SECOND) != 0;
+
+    switch (tag) {
+        case ConstantPoolInfo::CLASS:
+        case ConstantPoolInfo::MODULE:
+        case ConstantPoolInfo::PACKAGE:
+            if (first) _report(class_file, 0, "The name index is not a UTF-8 constant pool info.");
+            break;
+        case ConstantPoolInfo::STRING:
+            if (first) _report(class_file, 0, "The string index is not a UTF-8 constant pool info.");
+            break;
+        case ConstantPoolInfo::METHOD_TYPE:
+            if (first) _report(class_file, 0, "The descriptor index is not a UTF-8 constant pool info.");
+            break;
+        case ConstantPoolInfo::NAME_AND_TYPE:
+            if (first) _report(class_file, 0, "The name index is not a UTF-8 constant pool info.");
+            if (second) _report(class_file, 0, "The descriptor index is not a UTF-8 constant pool info.");
+            break;
+        default:
+            if (first) _report(class_file, 0, "The class index is not a class constant pool info.");
+            if (second) _report(class_file, 0, "The name and type index is not a name and type constant pool info.");
+    }
+}
+
+auto VMCheck::_compute_utf8_flags(std::string_view utf8) -> uint8_t {
+    if (utf8 == "<init>") return VMCheck::IS_INIT;
+    if (utf8 == "<clinit>") return VMCheck::IS_CLINIT;
+    return 0;
+}
+
+auto VMCheck::_utf8_flags_of(ClassFile &class_file, uint16_t index) const -> uint8_t {
+    // Single members can be checked without visiting the class first, then the flags are computed on demand.
+    if (index < _utf8_flags.size()) return _utf8_flags[index];
+    return _compute_utf8_flags(class_file.utf8(index));
+}
+
+void VMCheck::_reset(ClassFile &class_file) {
+    _class_file = &class_file;
+    _utf8_flags.clear();
+    _descriptors.reset(class_file);
+}
+
+void VMCheck::_enter_class(ClassFile &class_file) {
+    // The caches describe a single class, so a check of another one mustn't see its flags or descriptors.
+    if (_class_file != &class_file) _reset(class_file);
+}
+
+void VMCheck::_enter_member(ClassFile &class_file, uint16_t name_index, uint16_t descriptor_index) {
+    _member.clear();
+    if (_mode != VMCheck::COLLECT) return;
+
+    _member.append(class_file.utf8(name_index));
+    _member.append(class_file.utf8(descriptor_index));
+}
+
+void VMCheck::_report(ClassFile &class_file, uint16_t constant_pool_index, const char *message) {
+    if (_mode != VMCheck::COLLECT) {
+        std::cerr << message << std::endl;
         abort();
     }
+
+    Diagnostic diagnostic;
+    diagnostic.class_name = class_file.class_name(class_file.this_class);
+    diagnostic.member = _member;
+    diagnostic.constant_pool_index = constant_pool_index ? constant_pool_index : _constant_pool_index;
+    diagnostic.message = message;
+
+    _diagnostics.push_back(std::move(diagnostic));
 }
 
 //==============================================================================
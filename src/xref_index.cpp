@@ -0,0 +1,408 @@
+#include "xref_index.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "attribute_info.h"
+#include "constant_info.h"
+#include "method_info.h"
+#include "field_info.h"
+#include "binary_io.h"
+#include "parallel.h"
+#include "bytecode.h"
+#include "hash.h"
+
+using namespace ares;
+
+namespace {
+
+constexpr uint32_t INDEX_MAGIC = 0x49585241; // "ARXI"
+constexpr uint16_t INDEX_VERSION = 1;
+constexpr size_t HEADER_SIZE = 20;
+constexpr uint32_t NO_MEMBER = UINT32_MAX;
+
+// The key of a CLASS, FIELD_REF, METHOD_REF or INTERFACE_METHOD_REF constant. Arrays are keyed by their element
+// class, arrays of primitives not at all.
+auto key_of(const ClassFile &class_file, uint16_t index) -> std::string {
+    if (!class_file.is_valid_index(index)) return {};
+
+    const auto &info = class_file.constant_pool[index - 1];
+    if (info.tag == ConstantPoolInfo::CLASS) {
+        auto name = class_file.class_name(index);
+        if (!name.starts_with('[')) return XrefIndex::class_key(name);
+
+        name.remove_prefix(name.find_first_not_of('['));
+        if (!name.starts_with('L') || !name.ends_with(';')) return {};
+        return XrefIndex::class_key(name.substr(1, name.size() - 2));
+    }
+
+    // Dynamic constants have no owner and aren't keyed.
+    auto reference = class_file.member_ref(index);
+    if (!reference || reference->owner.empty()) return {};
+
+    if (info.tag == ConstantPoolInfo::FIELD_REF) {
+        return XrefIndex::field_key(reference->owner, reference->name, reference->descriptor);
+    }
+    return XrefIndex::method_key(reference->owner, reference->name, reference->descriptor);
+}
+
+// Returns the constant pool index an instruction refers to, or 0.
+auto constant_operand(std::span<const uint8_t> code, size_t pc) -> uint16_t {
+    switch (code[pc]) {
+        case Bytecode::LDC:
+            return code[pc + 1];
+        case Bytecode::LDC_W:
+        case Bytecode::GETSTATIC:
+        case Bytecode::PUTSTATIC:
+        case Bytecode::GETFIELD:
+        case Bytecode::PUTFIELD:
+        case Bytecode::INVOKEVIRTUAL:
+        case Bytecode::INVOKESPECIAL:
+        case Bytecode::INVOKESTATIC:
+        case Bytecode::INVOKEINTERFACE:
+        case Bytecode::NEW:
+        case Bytecode::ANEWARRAY:
+        case Bytecode::CHECKCAST:
+        case Bytecode::INSTANCEOF:
+        case Bytecode::MULTIANEWARRAY:
+            return Bytecode::read_u16(code, pc + 1);
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+XrefIndex::XrefIndex(bool record_offsets) : _record_offsets(record_offsets) {}
+
+auto XrefIndex::class_key(std::string_view class_name) -> std::string {
+    return std::string(class_name);
+}
+
+auto XrefIndex::field_key(std::string_view class_name, std::string_view name,
+                          std::string_view descriptor) -> std::string {
+    std::string key;
+    key.reserve(class_name.size() + name.size() + descriptor.size() + 2);
+    key.append(class_name).append(1, '.').append(name).append(1, ':').append(descriptor);
+    return key;
+}
+
+auto XrefIndex::method_key(std::string_view class_name, std::string_view name,
+                           std::string_view descriptor) -> std::string {
+    std::string key;
+    key.reserve(class_name.size() + name.size() + descriptor.size() + 1);
+    key.append(class_name).append(1, '.').append(name).append(descriptor);
+    return key;
+}
+
+auto XrefIndex::_scan(const ClassFile &class_file, bool record_offsets) -> Scan {
+    Scan scan;
+    std::vector<bool> used(class_file.constant_pool.size() + 1, false);
+
+    auto mark_used = [&](uint16_t index) {
+        used[index] = true;
+
+        const auto &info = class_file.constant_pool[index - 1];
+        if (info.tag == ConstantPoolInfo::FIELD_REF || info.tag == ConstantPoolInfo::METHOD_REF
+            || info.tag == ConstantPoolInfo::INTERFACE_METHOD_REF) {
+            auto class_index = info.info.field_method_info.class_index;
+            if (class_file.is_valid_index(class_index)) used[class_index] = true;
+        }
+    };
+
+    for (const auto &method_info: class_file.methods) {
+        const auto *attribute_info = CodeAttribute::find(class_file, method_info);
+        if (!attribute_info) continue;
+
+        auto code = CodeAttribute::read(*attribute_info);
+        if (!code) continue;
+
+        auto member = static_cast<uint32_t>(scan.members.size());
+        scan.members.emplace_back(class_file.utf8(method_info.name_index));
+        scan.members.back().append(class_file.utf8(method_info.descriptor_index));
+
+        for (size_t pc = 0; pc < code->code.size();) {
+            auto length = Bytecode::instruction_length(code->code, pc);
+            if (length == 0) break;
+
+            auto index = constant_operand(code->code, pc);
+            auto key = key_of(class_file, index);
+            if (!key.empty()) {
+                mark_used(index);
+                auto offset = record_offsets ? static_cast<uint32_t>(pc) : NO_OFFSET;
+                scan.references.push_back({std::move(key), {0, member, offset}});
+            }
+
+            pc += length;
+        }
+    }
+
+    // Whatever isn't referenced by code is attributed to the class, except the class itself.
+    for (uint16_t index = 1; index < used.size(); index++) {
+        if (used[index] || index == class_file.this_class) continue;
+
+        auto key = key_of(class_file, index);
+        if (!key.empty()) scan.references.push_back({std::move(key), {0, NO_MEMBER, NO_OFFSET}});
+    }
+
+    std::sort(scan.references.begin(), scan.references.end());
+    scan.references.erase(std::unique(scan.references.begin(), scan.references.end()), scan.references.end());
+    return scan;
+}
+
+void XrefIndex::_insert(const std::string &source, Scan scan) {
+    remove(source);
+
+    uint32_t id;
+    if (!_free_ids.empty()) {
+        id = _free_ids.back();
+        _free_ids.pop_back();
+    } else {
+        id = static_cast<uint32_t>(_sources.size());
+        _sources.emplace_back();
+    }
+
+    auto &entry = _sources[id];
+    entry.name = source;
+    entry.members = std::move(scan.members);
+    _source_ids.emplace(source, id);
+
+    for (auto &[key, posting]: scan.references) {
+        posting.source = id;
+
+        if (entry.keys.empty() || entry.keys.back().first != key) entry.keys.emplace_back(key, 0);
+        entry.keys.back().second++;
+        _postings[key].postings.push_back(posting);
+    }
+}
+
+void XrefIndex::update(const std::string &source, const ClassFile &class_file) {
+    _insert(source, _scan(class_file, _record_offsets));
+}
+
+void XrefIndex::update(JARFile &jar_file, unsigned int thread_count) {
+    std::vector<std::pair<std::string, const ClassFile *>> classes;
+    jar_file.visit_classes([&](const std::string &entry_name, ClassFile &class_file) {
+        classes.emplace_back(entry_name, &class_file);
+    });
+
+    std::vector<Scan> scans(classes.size());
+    parallel_for(classes.size(), [&](size_t index) {
+        scans[index] = _scan(*classes[index].second, _record_offsets);
+    }, thread_count);
+
+    for (size_t index = 0; index < classes.size(); index++) {
+        _insert(classes[index].first, std::move(scans[index]));
+    }
+}
+
+void XrefIndex::remove(const std::string &source) {
+    auto found = _source_ids.find(source);
+    if (found == _source_ids.end()) return;
+
+    auto id = found->second;
+    _source_ids.erase(found);
+
+    // The compaction may release the source, so its keys are taken out first.
+    auto &entry = _sources[id];
+    auto keys = std::move(entry.keys);
+    entry.members.clear();
+    entry.removed = true;
+    for (const auto &key: keys) entry.stale_postings += key.second;
+
+    if (entry.stale_postings == 0) {
+        entry = {};
+        _free_ids.push_back(id);
+        return;
+    }
+
+    for (const auto &[key, count]: keys) {
+        auto postings = _postings.find(key);
+        if (postings == _postings.end()) continue;
+
+        postings->second.stale += count;
+        if (postings->second.stale * 2 > postings->second.postings.size()) _compact(postings);
+    }
+}
+
+void XrefIndex::_compact(std::unordered_map<std::string, Postings>::iterator found) {
+    std::erase_if(found->second.postings, [this](const Posting &posting) {
+        auto &source = _sources[posting.source];
+        if (!source.removed) return false;
+
+        if (--source.stale_postings == 0) {
+            source = {};
+            _free_ids.push_back(posting.source);
+        }
+        return true;
+    });
+
+    found->second.stale = 0;
+    if (found->second.postings.empty()) _postings.erase(found);
+}
+
+auto XrefIndex::usages(const std::string &key) const -> std::vector<Usage> {
+    std::vector<Usage> result;
+
+    auto found = _postings.find(key);
+    if (found == _postings.end()) return result;
+
+    result.reserve(found->second.postings.size() - found->second.stale);
+    for (const auto &posting: found->second.postings) {
+        const auto &source = _sources[posting.source];
+        if (source.removed) continue;
+
+        std::string_view member;
+        if (posting.member != NO_MEMBER) member = source.members[posting.member];
+        result.push_back({source.name, member, posting.offset});
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+auto XrefIndex::contains(const std::string &source) const -> bool {
+    return _source_ids.contains(source);
+}
+
+auto XrefIndex::source_count() const -> size_t {
+    return _source_ids.size();
+}
+
+auto XrefIndex::key_count() const -> size_t {
+    return _postings.size();
+}
+
+void XrefIndex::save(const std::string &path) const {
+    // The sources are renumbered densely, the slots of removed ones aren't stored.
+    std::vector<uint32_t> dense_ids(_sources.size(), NO_MEMBER);
+    BinaryWriter payload;
+
+    payload.write_u32(static_cast<uint32_t>(_source_ids.size()));
+    uint32_t next_id = 0;
+    for (uint32_t id = 0; id < _sources.size(); id++) {
+        const auto &source = _sources[id];
+        if (!_source_ids.contains(source.name) || _source_ids.at(source.name) != id) continue;
+
+        dense_ids[id] = next_id++;
+        payload.write_string32(source.name);
+        payload.write_u32(static_cast<uint32_t>(source.members.size()));
+        for (const auto &member: source.members) payload.write_string32(member);
+    }
+
+    payload.write_u32(static_cast<uint32_t>(_postings.size()));
+    for (const auto &[key, postings]: _postings) {
+        payload.write_string32(key);
+        payload.write_u32(static_cast<uint32_t>(postings.postings.size() - postings.stale));
+        for (const auto &posting: postings.postings) {
+            if (dense_ids[posting.source] == NO_MEMBER) continue;
+
+            payload.write_u32(dense_ids[posting.source]);
+            payload.write_u32(posting.member);
+            payload.write_u32(posting.offset);
+        }
+    }
+
+    auto &payload_bytes = payload.bytes();
+
+    BinaryWriter header;
+    header.write_u32(INDEX_MAGIC);
+    header.write_u16(INDEX_VERSION);
+    header.write_u16(_record_offsets ? 1 : 0);
+    header.write_u64(hash64(payload_bytes.data(), payload_bytes.size()));
+    header.write_u32(static_cast<uint32_t>(payload_bytes.size()));
+
+    write_file_atomically(path, {header.bytes(), payload_bytes}, "cross-reference index");
+}
+
+auto XrefIndex::load(const std::string &path) -> std::optional<XrefIndex> {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) return std::nullopt;
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_SIZE) return std::nullopt;
+
+    BinaryReader header(data.data(), HEADER_SIZE);
+    uint32_t magic{}, payload_size{};
+    uint16_t version{}, flags{};
+    uint64_t checksum{};
+
+    auto valid = header.read_u32(magic) && header.read_u16(version) && header.read_u16(flags)
+                 && header.read_u64(checksum) && header.read_u32(payload_size)
+                 && magic == INDEX_MAGIC && version == INDEX_VERSION && payload_size == data.size() - HEADER_SIZE
+                 && hash64(data.data() + HEADER_SIZE, payload_size) == checksum;
+    if (!valid) return std::nullopt;
+
+    XrefIndex index(flags & 1);
+    BinaryReader reader(data.data() + HEADER_SIZE, payload_size);
+
+    uint32_t source_count{};
+    valid = reader.read_count(source_count, 8);
+    index._sources.resize(valid ? source_count : 0);
+    for (uint32_t id = 0; valid && id < source_count; id++) {
+        auto &source = index._sources[id];
+
+        uint32_t member_count{};
+        valid = reader.read_string32(source.name) && reader.read_count(member_count, 4)
+                && index._source_ids.emplace(source.name, id).second;
+        source.members.resize(valid ? member_count : 0);
+        for (auto &member: source.members) valid = valid && reader.read_string32(member);
+    }
+
+    uint32_t key_count{};
+    valid = valid && reader.read_count(key_count, 8);
+    for (uint32_t key_index = 0; valid && key_index < key_count; key_index++) {
+        std::string key;
+        uint32_t posting_count{};
+        valid = reader.read_string32(key) && reader.read_count(posting_count, 12);
+
+        auto &postings = index._postings[key].postings;
+        postings.resize(valid ? posting_count : 0);
+        for (auto &posting: postings) {
+            valid = valid && reader.read_u32(posting.source) && reader.read_u32(posting.member)
+                    && reader.read_u32(posting.offset) && posting.source < source_count
+                    && (posting.member == NO_MEMBER || posting.member < index._sources[posting.source].members.size());
+            if (!valid) break;
+
+            auto &keys = index._sources[posting.source].keys;
+            if (keys.empty() || keys.back().first != key) keys.emplace_back(key, 0);
+            keys.back().second++;
+        }
+    }
+
+    if (!valid || !reader.at_end()) return std::nullopt;
+    return index;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "zip_reader.h"
+
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
+
+using namespace ares;
+
+auto ares::open_zip(const std::string &path) -> zip_t * {
+    int error = 0;
+    zip_t *zip = zip_open(path.c_str(), ZIP_RDONLY, &error);
+    if (!zip) throw std::runtime_error("Warning: Couldn't open the ZIP File: " + path);
+    return zip;
+}
+
+auto ares::read_directory(zip_t *zip) -> std::vector<ZipEntry> {
+    std::vector<ZipEntry> entries;
+
+    zip_int64_t entry_count = zip_get_num_entries(zip, 0);
+    for (zip_int64_t index = 0; index < entry_count; index++) {
+        zip_stat_t stat;
+        zip_stat_init(&stat);
+        if (zip_stat_index(zip, index, 0, &stat) != 0 || !stat.name) continue;
+
+        ZipEntry entry{stat.name, index, stat.size};
+        if (entry.name.empty() || entry.name.back() == '/') continue;
+        if (stat.valid & ZIP_STAT_CRC) entry.crc = stat.crc;
+
+        entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+auto ares::read_directory(const std::string &path) -> std::vector<ZipEntry> {
+    zip_t *zip = open_zip(path);
+    auto entries = read_directory(zip);
+    zip_discard(zip);
+    return entries;
+}
+
+void ares::read_entry(zip_t *zip, const ZipEntry &entry, const std::string &path, std::vector<uint8_t> &data) {
+    zip_file_t *file = zip_fopen_index(zip, entry.index, 0);
+    if (!file) throw std::runtime_error("Warning: Failed to open file in ZIP: " + path + "!/" + entry.name);
+
+    data.resize(entry.size);
+    zip_uint64_t offset = 0;
+    while (offset < entry.size) {
+        auto read = zip_fread(file, data.data() + offset, entry.size - offset);
+        if (read <= 0) break;
+
+        offset += read;
+    }
+
+    zip_fclose(file);
+
+    if (offset != entry.size) {
+        throw std::runtime_error("Failed to read data from ZIP file: " + path + "!/" + entry.name);
+    }
+}
+
+auto ares::read_entry(zip_t *zip, const ZipEntry &entry, const std::string &path) -> std::vector<uint8_t> {
+    std::vector<uint8_t> data;
+    read_entry(zip, entry, path, data);
+    return data;
+}
+
+auto ares::read_class_directory(const std::string &path) -> std::vector<ZipEntry> {
+    auto entries = read_directory(path);
+    std::erase_if(entries, [](const ZipEntry &entry) { return !boost::algorithm::iends_with(entry.name, ".class"); });
+    return entries;
+}
+
+//==============================================================================
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, Timo Behrend
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//==============================================================================
\ No newline at end of file
@@ -1,14 +1,58 @@
+#include <filesystem>
 #include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <cstring>
 #include <chrono>
 
 #include "gtest/gtest.h"
 
+#include "dependency_extractor.h"
+#include "constant_pool_table.h"
+#include "abi_fingerprint.h"
+#include "bytecode_verifier.h"
+#include "bootstrap_methods.h"
+#include "class_directory.h"
+#include "class_hierarchy.h"
+#include "jar_signature.h"
+#include "class_writer.h"
+#include "jar_merger.h"
+#include "jar_diff.h"
+#include "parse_cache.h"
+#include "call_graph.h"
+#include "descriptor.h"
+#include "string_search.h"
+#include "xref_index.h"
+#include "remapper.h"
+#include "shrinker.h"
 #include "vm_check.h"
+#include "snapshot.h"
+#include "bytecode.h"
+#include "hash.h"
 #include "utils.h"
 
 using namespace ares;
 
+static auto add_constant(ClassFile &class_file, ConstantPoolInfo info) -> uint16_t {
+    class_file.constant_pool.push_back(info);
+    return class_file.constant_pool_count++;
+}
+
+static auto add_utf8(ClassFile &class_file, const char *value) -> uint16_t {
+    ConstantPoolInfo info;
+    info.tag = ConstantPoolInfo::UTF_8;
+    info.info.utf8_info.length = static_cast<uint16_t>(std::strlen(value));
+    info.info.utf8_info.bytes = reinterpret_cast<uint8_t *>(const_cast<char *>(value));
+    return add_constant(class_file, info);
+}
+
+static auto find_constant(const ClassFile &class_file, ConstantPoolInfo::ConstantTag tag) -> uint16_t {
+    for (size_t index = 0; index < class_file.constant_pool.size(); index++) {
+        if (class_file.constant_pool[index].tag == tag) return static_cast<uint16_t>(index + 1);
+    }
+    return 0;
+}
+
 TEST(General, Works) {
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -26,6 +70,1219 @@ TEST(General, Works) {
     std::cout << "Time taken: " << duration.count() << "µs" << std::endl;
 }
 
+TEST(ClassDirectory, MatchesJARFile) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+
+    auto directory = std::filesystem::temp_directory_path() / "aresbc_class_directory";
+    std::filesystem::remove_all(directory);
+
+    for (const auto &class_file: jar_file.classes) {
+        auto path = directory / class_file.first;
+        std::filesystem::create_directories(path.parent_path());
+
+        std::ofstream stream(path, std::ios::binary);
+        stream.write(reinterpret_cast<const char *>(class_file.second.byte_code.data()),
+                     static_cast<std::streamsize>(class_file.second.byte_code.size()));
+    }
+
+    auto directory_file = ClassDirectory::read_directory(directory.string(), 1);
+    std::filesystem::remove_all(directory);
+
+    ASSERT_EQ(directory_file.classes.size(), jar_file.classes.size());
+    for (const auto &class_file: jar_file.classes) {
+        auto iterator = directory_file.classes.find(class_file.first);
+        ASSERT_NE(iterator, directory_file.classes.end());
+        EXPECT_EQ(iterator->second.byte_code, class_file.second.byte_code);
+        EXPECT_EQ(iterator->second.this_class, class_file.second.this_class);
+    }
+}
+
+TEST(JARFile, NestedJARs) {
+    std::ifstream stream(TEST_PATH "/resources/hello_world_in.jar", std::ios::binary);
+    std::vector<uint8_t> inner_bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    JARFile outer;
+    outer.others.emplace("BOOT-INF/lib/hello_world.jar", inner_bytes);
+
+    auto path = (std::filesystem::temp_directory_path() / "aresbc_fat.jar").string();
+    outer.write_file(path);
+
+    auto fat_jar = JARFile::read_file(path);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(fat_jar.nested_names(), std::vector<std::string>{"BOOT-INF/lib/hello_world.jar"});
+
+    auto &inner = fat_jar.nested("BOOT-INF/lib/hello_world.jar");
+    EXPECT_EQ(&inner, &fat_jar.nested("BOOT-INF/lib/hello_world.jar"));
+    EXPECT_EQ(inner.classes.size(), 1u);
+
+    std::vector<std::string> names;
+    fat_jar.visit_classes([&](const std::string &name, ClassFile &) { names.push_back(name); });
+    EXPECT_EQ(names, std::vector<std::string>{"BOOT-INF/lib/hello_world.jar!/org/example/Main.class"});
+
+    // Copies open their own views, so changing one doesn't show through the other.
+    auto copy = fat_jar;
+    copy.nested("BOOT-INF/lib/hello_world.jar").classes.clear();
+    EXPECT_EQ(inner.classes.size(), 1u);
+    EXPECT_NE(&copy.nested("BOOT-INF/lib/hello_world.jar"), &inner);
+}
+
+TEST(ParseCache, ReusesSummaries) {
+    auto directory = std::filesystem::temp_directory_path() / "aresbc_parse_cache";
+    std::filesystem::remove_all(directory);
+
+    ParseCache cache(directory.string());
+    auto first = cache.summarize_jar(TEST_PATH "/resources/hello_world_in.jar");
+    auto second = cache.summarize_jar(TEST_PATH "/resources/hello_world_in.jar");
+
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first, second);
+
+    const auto &summary = first.at("org/example/Main.class");
+    EXPECT_EQ(summary.name, "org/example/Main");
+    EXPECT_EQ(summary.super_name, "java/lang/Object");
+
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.at("org/example/Main.class");
+    auto key = ParseCache::key_of(class_file.byte_code);
+
+    EXPECT_FALSE(cache.lookup(key).has_value());
+    cache.store(key, summary);
+    EXPECT_EQ(cache.lookup(key), summary);
+
+    // A damaged entry is a miss instead of an error.
+    for (const auto &entry: std::filesystem::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file()) std::filesystem::resize_file(entry.path(), entry.file_size() - 1);
+    }
+    EXPECT_FALSE(cache.lookup(key).has_value());
+    EXPECT_EQ(cache.summarize_jar(TEST_PATH "/resources/hello_world_in.jar"), first);
+
+    // Neither can a cache that can't be written to fail the summary.
+    std::filesystem::remove_all(directory);
+    std::ofstream(directory).put('x');
+    EXPECT_EQ(cache.summarize_jar(TEST_PATH "/resources/hello_world_in.jar"), first);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(Snapshot, MapsParsedJAR) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto path = (std::filesystem::temp_directory_path() / "aresbc_hello_world.snapshot").string();
+    Snapshot::write(jar_file, path);
+
+    {
+        auto snapshot = Snapshot::open(path);
+        ASSERT_EQ(snapshot.class_count(), 1u);
+        EXPECT_FALSE(snapshot.find_class("org/example/Missing.class").has_value());
+
+        auto main_class = snapshot.find_class("org/example/Main.class");
+        ASSERT_TRUE(main_class.has_value());
+        EXPECT_EQ(main_class->class_name(main_class->record().this_class), "org/example/Main");
+        EXPECT_EQ(main_class->class_name(main_class->record().super_class), "java/lang/Object");
+
+        auto &class_file = jar_file.classes.at("org/example/Main.class");
+        ASSERT_EQ(main_class->methods().size(), class_file.methods.size());
+        for (size_t index = 0; index < class_file.methods.size(); index++) {
+            const auto &method = main_class->methods()[index];
+            EXPECT_EQ(main_class->utf8(method.name_index), class_file.utf8(class_file.methods[index].name_index));
+            ASSERT_EQ(main_class->attributes(method).size(), class_file.methods[index].attributes.size());
+
+            auto data = main_class->attribute_data(main_class->attributes(method)[0]);
+            const auto &attribute = class_file.methods[index].attributes[0];
+            EXPECT_TRUE(std::equal(data.begin(), data.end(), attribute.info, attribute.info + attribute.attribute_length));
+        }
+
+        auto round_trip = snapshot.to_jar_file();
+        EXPECT_EQ(round_trip.classes.at("org/example/Main.class").byte_code, class_file.byte_code);
+        EXPECT_EQ(round_trip.manifest.content(), jar_file.manifest.content());
+    }
+
+    // A misaligned record offset is refused instead of being read in place.
+    {
+        std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        SnapshotHeader header{};
+        stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+        header.classes_offset++;
+        stream.seekp(0);
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    EXPECT_THROW(Snapshot::open(path), std::runtime_error);
+
+    Snapshot::write(jar_file, path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_THROW(Snapshot::open(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(JARFile, StreamsLargeEntries) {
+    std::vector<uint8_t> payload(4096);
+    for (size_t index = 0; index < payload.size(); index++) {
+        payload[index] = uint8_t(index * 31);
+    }
+
+    std::ifstream stream(TEST_PATH "/resources/hello_world_in.jar", std::ios::binary);
+    std::vector<uint8_t> inner_bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    JARFile jar_file;
+    jar_file.others.emplace("assets/large.bin", payload);
+    jar_file.others.emplace("lib/hello_world.jar", inner_bytes);
+
+    auto directory = std::filesystem::temp_directory_path();
+    auto first_path = (directory / "aresbc_streamed_first.jar").string();
+    auto second_path = (directory / "aresbc_streamed_second.jar").string();
+    auto snapshot_path = (directory / "aresbc_streamed.snapshot").string();
+    jar_file.write_file(first_path);
+
+    // The threshold is below the size of both entries, so neither of them is loaded.
+    auto streamed = JARFile::read_file(first_path, 512);
+    ASSERT_EQ(streamed.streamed.count("assets/large.bin"), 1u);
+    ASSERT_EQ(streamed.streamed.count("lib/hello_world.jar"), 1u);
+    EXPECT_EQ(streamed.others.count("assets/large.bin"), 0u);
+
+    ASSERT_EQ(streamed.nested_names(), std::vector<std::string>{"lib/hello_world.jar"});
+    EXPECT_EQ(streamed.nested("lib/hello_world.jar").classes.size(), 1u);
+
+    Snapshot::write(streamed, snapshot_path);
+    {
+        auto snapshot = Snapshot::open(snapshot_path);
+        auto round_trip = snapshot.to_jar_file();
+        EXPECT_EQ(round_trip.others.at("assets/large.bin"), payload);
+        EXPECT_EQ(round_trip.others.at("lib/hello_world.jar"), inner_bytes);
+    }
+
+    std::vector<uint8_t> read;
+    streamed.read_entry("assets/large.bin", [&](const uint8_t *data, size_t size) {
+        read.insert(read.end(), data, data + size);
+    });
+    EXPECT_EQ(read, payload);
+
+    streamed.write_file(second_path);
+    auto copied = JARFile::read_file(second_path);
+    EXPECT_EQ(copied.others.at("assets/large.bin"), payload);
+    EXPECT_EQ(copied.others.at("lib/hello_world.jar"), inner_bytes);
+
+    std::filesystem::remove(first_path);
+    std::filesystem::remove(second_path);
+    std::filesystem::remove(snapshot_path);
+}
+
+TEST(JARFile, StreamsEmptyFiles) {
+    auto directory = std::filesystem::temp_directory_path() / "aresbc_empty_entry";
+    std::filesystem::create_directories(directory);
+    auto path = (directory / "empty.txt").string();
+    std::ofstream(path, std::ios::binary).close();
+
+    JARFile jar_file;
+    jar_file.add_file("empty.txt", path);
+
+    size_t calls = 0, size = 0;
+    jar_file.read_entry("empty.txt", [&](const uint8_t *, size_t length) {
+        calls++;
+        size += length;
+    });
+    std::filesystem::remove_all(directory);
+
+    EXPECT_EQ(calls, 0u);
+    EXPECT_EQ(size, 0u);
+}
+
+// Writes an archive that needs Zip64 for both its entry count and size. Run with --gtest_also_run_disabled_tests.
+TEST(JARFile, DISABLED_Zip64Benchmark) {
+    auto directory = std::filesystem::temp_directory_path();
+    auto large_path = (directory / "aresbc_zip64_large.bin").string();
+    auto jar_path = (directory / "aresbc_zip64.jar").string();
+
+    std::ofstream(large_path).close();
+    std::filesystem::resize_file(large_path, 5ull << 30);
+
+    JARFile jar_file;
+    jar_file.add_file("assets/large.bin", large_path);
+    for (int index = 0; index < 70000; index++) {
+        jar_file.others.emplace("entries/" + std::to_string(index) + ".txt", std::vector<uint8_t>{'a'});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    jar_file.write_file(jar_path);
+    auto written = std::chrono::steady_clock::now();
+
+    auto read = JARFile::read_file(jar_path);
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(read.others.size(), 70000u);
+    EXPECT_EQ(read.streamed.at("assets/large.bin").size, 5ull << 30);
+
+    std::cout << "write: " << std::chrono::duration<double>(written - start).count() << "s, read: "
+              << std::chrono::duration<double>(end - written).count() << "s" << std::endl;
+
+    std::filesystem::remove(large_path);
+    std::filesystem::remove(jar_path);
+}
+
+TEST(ClassReader, VerifiesWhileReading) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.begin()->second;
+
+    auto verified = JARFile::read_class(class_file.byte_code, true);
+    EXPECT_EQ(verified.this_class, class_file.this_class);
+    EXPECT_EQ(verified.methods.size(), class_file.methods.size());
+
+    auto corrupted = class_file.byte_code;
+    corrupted[0] = 0;
+    EXPECT_DEATH(JARFile::read_class(corrupted, true), "magic number");
+}
+
+TEST(VMCheck, CollectsDiagnostics) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    EXPECT_TRUE(VMCheck::verify(jar_file).empty());
+
+    auto &[name, class_file] = *jar_file.classes.begin();
+    class_file.this_class = 0xFFFF;
+    class_file.methods[0].access_flags |= MethodInfo::PUBLIC | MethodInfo::PRIVATE;
+
+    auto report = VMCheck::verify(jar_file, 2);
+    ASSERT_EQ(report.size(), 2u);
+    EXPECT_TRUE(std::is_sorted(report.begin(), report.end()));
+
+    for (const auto &diagnostic: report) {
+        EXPECT_EQ(diagnostic.entry, name);
+        EXPECT_EQ(diagnostic.class_name, class_file.class_name(class_file.this_class));
+    }
+
+    auto this_class = std::find_if(report.begin(), report.end(), [](const Diagnostic &diagnostic) {
+        return diagnostic.member.empty();
+    });
+    ASSERT_NE(this_class, report.end());
+    EXPECT_EQ(this_class->constant_pool_index, 0xFFFF);
+}
+
+TEST(VMCheck, FlagsConstructorNames) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.begin()->second;
+
+    auto constructor = std::find_if(class_file.methods.begin(), class_file.methods.end(), [&](const MethodInfo &method) {
+        return class_file.utf8(method.name_index) == "<init>";
+    });
+    ASSERT_NE(constructor, class_file.methods.end());
+    constructor->access_flags |= MethodInfo::STATIC;
+
+    auto report = VMCheck::verify(jar_file);
+    ASSERT_EQ(report.size(), 1u);
+    EXPECT_EQ(report[0].member.rfind("<init>", 0), 0u);
+}
+
+TEST(Descriptor, ParsesAndValidates) {
+    auto method = Descriptor::parse("(IJ[Ljava/lang/String;Ljava/util/List;)[[D");
+    ASSERT_TRUE(method.has_value());
+    EXPECT_TRUE(method->method);
+    EXPECT_EQ(method->parameter_count, 4u);
+    EXPECT_EQ(method->parameter_slots, 5u);
+    EXPECT_EQ(method->return_kind, Descriptor::ARRAY);
+    EXPECT_EQ(method->referenced_classes, (std::vector<std::string_view>{"java/lang/String", "java/util/List"}));
+
+    auto field = Descriptor::parse_field("J");
+    ASSERT_TRUE(field.has_value());
+    EXPECT_EQ(field->return_kind, Descriptor::LONG);
+
+    for (auto invalid: {"", "V", "(V)V", "(I", "(I)", "L;", "Ljava.lang.String;", "La//b;", "(I)VV", "[V"}) {
+        EXPECT_FALSE(Descriptor::parse(invalid).has_value()) << invalid;
+    }
+}
+
+TEST(VMCheck, ChecksBootstrapMethods) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.begin()->second;
+
+    ConstantPoolInfo handle;
+    handle.tag = ConstantPoolInfo::METHOD_HANDLE;
+    handle.info.method_handle_info = {ConstantInfo::InvokeStatic, 0};
+    for (uint16_t index = 1; index < class_file.constant_pool_count; index++) {
+        const auto &info = class_file.constant_pool[index - 1];
+        if (info.tag == ConstantPoolInfo::METHOD_REF && class_file.utf8(class_file.constant_pool[
+            info.info.field_method_info.name_and_type_index - 1].info.name_and_type_info.name_index) != "<init>") {
+            handle.info.method_handle_info.reference_index = index;
+        }
+    }
+    auto handle_index = add_constant(class_file, handle);
+
+    ConstantPoolInfo dynamic;
+    dynamic.tag = ConstantPoolInfo::INVOKE_DYNAMIC;
+    dynamic.info.dynamic_info = {0, find_constant(class_file, ConstantPoolInfo::NAME_AND_TYPE)};
+    auto dynamic_index = add_constant(class_file, dynamic);
+
+    auto string_index = find_constant(class_file, ConstantPoolInfo::STRING);
+    uint8_t info[] = {0, 1, uint8_t(handle_index >> 8), uint8_t(handle_index), 0, 1,
+                      uint8_t(string_index >> 8), uint8_t(string_index)};
+    class_file.attributes.push_back({add_utf8(class_file, "BootstrapMethods"), sizeof(info), info});
+    class_file.attributes_count++;
+
+    EXPECT_TRUE(VMCheck::verify(jar_file).empty());
+
+    auto bootstrap_methods = BootstrapMethods::read(class_file);
+    ASSERT_TRUE(bootstrap_methods && bootstrap_methods->present());
+
+    auto method = bootstrap_methods->of_constant(class_file, dynamic_index);
+    ASSERT_TRUE(method.has_value());
+    EXPECT_EQ(method->method_ref, handle_index);
+    EXPECT_EQ(std::vector<uint16_t>(method->arguments.begin(), method->arguments.end()),
+              std::vector<uint16_t>{string_index});
+
+    class_file.constant_pool[dynamic_index - 1].info.dynamic_info.boostrap_method_attr_index = 1;
+    auto report = VMCheck::verify(jar_file);
+    ASSERT_EQ(report.size(), 1u);
+    EXPECT_EQ(report[0].constant_pool_index, dynamic_index);
+}
+
+TEST(BytecodeVerifier, ChecksStackMapFrames) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.begin()->second;
+    EXPECT_TRUE(BytecodeVerifier::verify(jar_file).empty());
+
+    // static int f(int x) { return x >= 0 ? x : 0; } with a same_frame at the branch target.
+    auto stack_map_index = add_utf8(class_file, "StackMapTable");
+    uint8_t code[] = {0, 1, 0, 1, 0, 0, 0, 8, 0x1a, 0x9c, 0, 5, 0x03, 0xac, 0x1a, 0xac, 0, 0, 0, 1,
+                      uint8_t(stack_map_index >> 8), uint8_t(stack_map_index), 0, 0, 0, 3, 0, 1, 6};
+
+    MethodInfo method_info;
+    method_info.access_flags = MethodInfo::STATIC;
+    method_info.name_index = add_utf8(class_file, "f");
+    method_info.descriptor_index = add_utf8(class_file, "(I)I");
+    method_info.attributes_count = 1;
+    method_info.attributes.push_back({add_utf8(class_file, "Code"), sizeof(code), code});
+    class_file.methods.push_back(method_info);
+    class_file.method_count++;
+
+    EXPECT_TRUE(BytecodeVerifier::verify(jar_file).empty());
+
+    // Without the StackMapTable the branch target has no frame, unless the frames are inferred for old classes.
+    code[19] = 0;
+    class_file.methods.back().attributes[0].attribute_length = sizeof(code) - 9;
+    auto report = BytecodeVerifier::verify(jar_file);
+    ASSERT_EQ(report.size(), 1u);
+    EXPECT_EQ(report[0].entry, jar_file.classes.begin()->first);
+    EXPECT_EQ(report[0].class_name, class_file.class_name(class_file.this_class));
+    EXPECT_EQ(report[0].member, "f(I)I");
+    EXPECT_EQ(report[0].message, "pc 1: There is no stack map frame at the branch target.");
+
+    class_file.major_version = 49;
+    EXPECT_TRUE(BytecodeVerifier::verify(class_file).empty());
+
+    // Returning a float from an int method fails in both modes.
+    code[12] = 0x0b;
+    report = BytecodeVerifier::verify(class_file);
+    ASSERT_EQ(report.size(), 1u);
+    EXPECT_EQ(report[0].message, "pc 5: The operand stack has a wrong type.");
+}
+
+// Appends blocks of UTF_8, CLASS, NAME_AND_TYPE and METHOD_REF constants until the pool has the given size.
+static void fill_constant_pool(ClassFile &class_file, size_t size) {
+    while (class_file.constant_pool.size() + 4 < size) {
+        auto utf8 = add_utf8(class_file, "()V");
+
+        ConstantPoolInfo class_info;
+        class_info.tag = ConstantPoolInfo::CLASS;
+        class_info.info.class_info.name_index = utf8;
+        auto class_index = add_constant(class_file, class_info);
+
+        ConstantPoolInfo name_and_type;
+        name_and_type.tag = ConstantPoolInfo::NAME_AND_TYPE;
+        name_and_type.info.name_and_type_info = {utf8, utf8};
+        auto name_and_type_index = add_constant(class_file, name_and_type);
+
+        ConstantPoolInfo method_ref;
+        method_ref.tag = ConstantPoolInfo::METHOD_REF;
+        method_ref.info.field_method_info = {class_index, name_and_type_index};
+        add_constant(class_file, method_ref);
+    }
+}
+
+TEST(ConstantPoolTable, ValidatesReferencesInBulk) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.begin()->second;
+    fill_constant_pool(class_file, 12000);
+
+    EXPECT_TRUE(ConstantPoolTable(class_file).validate().empty());
+    EXPECT_TRUE(VMCheck::verify(jar_file).empty());
+
+    auto &last = class_file.constant_pool.back();
+    ASSERT_EQ(last.tag, ConstantPoolInfo::METHOD_REF);
+    std::swap(last.info.field_method_info.class_index, last.info.field_method_info.name_and_type_index);
+    class_file.constant_pool[class_file.constant_pool.size() - 3].info.class_info.name_index = 0xFFFF;
+
+    ConstantPoolTable table(class_file);
+    auto results = table.validate();
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].index, class_file.constant_pool.size() - 2);
+    EXPECT_EQ(results[0].violations, ConstantPoolTable::FIRST);
+    EXPECT_EQ(results[1].index, class_file.constant_pool.size());
+    EXPECT_EQ(results[1].violations, ConstantPoolTable::FIRST | ConstantPoolTable::SECOND);
+
+    auto scalar = table.validate_scalar();
+    ASSERT_EQ(scalar.size(), results.size());
+    EXPECT_TRUE(std::equal(scalar.begin(), scalar.end(), results.begin(), [](auto &first, auto &second) {
+        return first.index == second.index && first.violations == second.violations;
+    }));
+    EXPECT_EQ(ConstantPoolTable::validate_entry(class_file, last), ConstantPoolTable::FIRST | ConstantPoolTable::SECOND);
+
+    EXPECT_EQ(VMCheck::verify(jar_file).size(), 3u);
+
+    // Unknown tags don't fit into the masks, references to them are rejected instead of shifting by 32 or more.
+    auto utf8_index = static_cast<uint16_t>(class_file.constant_pool.size() - 3);
+    class_file.constant_pool[utf8_index].info.class_info.name_index = utf8_index;
+    class_file.constant_pool[utf8_index - 1].tag = static_cast<ConstantPoolInfo::ConstantTag>(200);
+
+    ConstantPoolTable unknown(class_file);
+    EXPECT_EQ(unknown.validate().size(), 3u);
+    EXPECT_EQ(unknown.validate_scalar().size(), 3u);
+    EXPECT_EQ(ConstantPoolTable::validate_entry(class_file, class_file.constant_pool[utf8_index]),
+              ConstantPoolTable::FIRST);
+}
+
+// Compares the bulk kernel against the scalar one. Run with --gtest_also_run_disabled_tests.
+TEST(ConstantPoolTable, DISABLED_ValidationBenchmark) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.begin()->second;
+    fill_constant_pool(class_file, 65000);
+
+    ConstantPoolTable table(class_file);
+    auto measure = [&](auto &&validate) {
+        auto start = std::chrono::steady_clock::now();
+        size_t violations = 0;
+        for (int iteration = 0; iteration < 1000; iteration++) {
+            violations += validate().size();
+        }
+        EXPECT_EQ(violations, 0u);
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 1000;
+    };
+
+    auto bulk = measure([&]() { return table.validate(); });
+    auto scalar = measure([&]() { return table.validate_scalar(); });
+
+    std::cout << class_file.constant_pool.size() << " constants, bulk: " << bulk << "us, scalar: " << scalar << "us"
+              << std::endl;
+}
+
+static auto make_class(const char *name, const char *super_name, std::vector<const char *> interfaces,
+                       uint16_t access_flags = ClassFile::PUBLIC) -> ClassFile {
+    ClassFile class_file;
+    class_file.constant_pool_count = 1;
+    class_file.access_flags = access_flags;
+
+    auto add_class = [&](const char *class_name) {
+        ConstantPoolInfo info;
+        info.tag = ConstantPoolInfo::CLASS;
+        info.info.class_info.name_index = add_utf8(class_file, class_name);
+        return add_constant(class_file, info);
+    };
+
+    class_file.this_class = add_class(name);
+    class_file.super_class = add_class(super_name);
+    for (auto interface: interfaces) {
+        class_file.interfaces.push_back(add_class(interface));
+    }
+
+    return class_file;
+}
+
+TEST(ClassHierarchy, ChecksAcrossJARs) {
+    JARFile app;
+    app.classes.emplace("A.class", make_class("A", "F", {"I"}));
+    app.classes.emplace("B.class", make_class("B", "I", {}));
+    app.classes.emplace("C.class", make_class("C", "java/lang/Object", {"A"}));
+    app.classes.emplace("D.class", make_class("D", "E", {}));
+    app.classes.emplace("E.class", make_class("E", "D", {}));
+    app.classes.emplace("F.class", make_class("F", "java/lang/Object", {}, ClassFile::PUBLIC | ClassFile::FINAL));
+    app.classes.emplace("I.class", make_class("I", "java/lang/Object", {}, ClassFile::INTERFACE | ClassFile::ABSTRACT));
+
+    JARFile library;
+    library.classes.emplace("A.class", make_class("A", "java/lang/Object", {}));
+
+    auto hierarchy = ClassHierarchy::build({{"app.jar", &app}, {"library.jar", &library}}, 2);
+    EXPECT_EQ(hierarchy.size(), 8u);
+    ASSERT_NE(hierarchy.find("A"), ClassHierarchy::NONE);
+    EXPECT_EQ(hierarchy.node(hierarchy.find("A")).source, "app.jar!/A.class");
+    EXPECT_FALSE(hierarchy.node(hierarchy.find("java/lang/Object")).defined);
+
+    std::vector<std::pair<std::string, std::string>> report;
+    for (const auto &diagnostic: hierarchy.check(2)) {
+        report.emplace_back(diagnostic.class_name, diagnostic.message);
+    }
+
+    std::vector<std::pair<std::string, std::string>> expected{
+            {"A", "The class is defined again in library.jar!/A.class, first in app.jar!/A.class."},
+            {"A", "The superclass F is final."},
+            {"B", "The superclass I is an interface."},
+            {"C", "The interface A is a class."},
+            {"D", "The class is its own ancestor."},
+            {"E", "The class is its own ancestor."}};
+    EXPECT_EQ(report, expected);
+
+    // One JAR per class fixes the search order: starting at P, S only reaches the cycle through the finished Q.
+    std::vector<ClassFile> classes;
+    classes.push_back(make_class("P", "Q", {"S"}));
+    classes.push_back(make_class("Q", "R", {}));
+    classes.push_back(make_class("R", "P", {}));
+    classes.push_back(make_class("S", "java/lang/Object", {"Q"}));
+    classes.push_back(make_class("T", "T", {}));
+
+    std::vector<JARFile> jars(classes.size());
+    std::vector<std::pair<std::string, JARFile *>> class_path;
+    for (size_t index = 0; index < classes.size(); index++) {
+        std::string name(classes[index].class_name(classes[index].this_class));
+        jars[index].classes.emplace(name + ".class", std::move(classes[index]));
+        class_path.emplace_back(name + ".jar", &jars[index]);
+    }
+
+    std::vector<std::string> ancestors;
+    for (const auto &diagnostic: ClassHierarchy::build(class_path).check()) {
+        if (diagnostic.message == "The class is its own ancestor.") ancestors.push_back(diagnostic.class_name);
+    }
+    EXPECT_EQ(ancestors, (std::vector<std::string>{"P", "Q", "R", "S", "T"}));
+}
+
+TEST(Manifest, ParsesSectionsAndContinuations) {
+    std::string content = "Manifest-Version: 1.0\r\n"
+                          "Created-By: a value that is long enough to be continued on the next line of the\r\n"
+                          "  manifest\r\n"
+                          "\r\n"
+                          "Name: org/example/Main.class\r\n"
+                          "SHA-256-Digest: AAAA\r\n"
+                          "\r\n";
+
+    auto manifest = Manifest::read_manifest(content);
+    EXPECT_EQ(manifest.content(), content);
+    EXPECT_EQ(manifest.value("manifest-version"), "1.0");
+    EXPECT_EQ(manifest.value("Created-By"),
+              "a value that is long enough to be continued on the next line of the manifest");
+
+    ASSERT_EQ(manifest.sections().size(), 2u);
+    const auto *entry = manifest.entry("org/example/Main.class");
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(entry->find("SHA-256-Digest"), nullptr);
+    EXPECT_EQ(entry->find("SHA-256-Digest")->value, "AAAA");
+
+    auto copy = manifest;
+    copy.set("Main-Class", std::string(80, 'x'));
+    EXPECT_EQ(manifest.content(), content);
+
+    auto rewritten = Manifest::read_manifest(copy.content());
+    EXPECT_EQ(rewritten.value("Main-Class"), std::string(80, 'x'));
+    EXPECT_EQ(rewritten.value("Created-By"), manifest.value("Created-By"));
+    EXPECT_NE(rewritten.entry("org/example/Main.class"), nullptr);
+    EXPECT_NE(copy.content().find("xxx\r\n xxx"), std::string::npos);
+
+    // The copy changed storage of its own, so its values outlive the original and don't show up in it.
+    auto original = std::make_unique<Manifest>(manifest);
+    auto changed = *original;
+    changed.set("Main-Class", "a.B");
+    original->set("Main-Class", "c.D");
+    EXPECT_EQ(original->value("Main-Class"), "c.D");
+    original.reset();
+    EXPECT_EQ(changed.value("Main-Class"), "a.B");
+    EXPECT_EQ(changed.value("Created-By"), manifest.value("Created-By"));
+}
+
+TEST(JARSignature, VerifiesDigests) {
+    auto abc = SHA256::digest("abc");
+    EXPECT_EQ(base64_encode(abc.data(), abc.size()), "ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=");
+
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    const auto &[class_name, class_file] = *jar_file.classes.begin();
+    jar_file.add_entry("data.txt", std::vector<uint8_t>(100000, 'a'));
+
+    auto digest_of = [](const auto &data) {
+        auto digest = SHA256::digest(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+        return base64_encode(digest.data(), digest.size());
+    };
+
+    std::string manifest = "Manifest-Version: 1.0\r\n\r\n"
+                           "Name: " + class_name + "\r\nSHA-256-Digest: " + digest_of(class_file.byte_code) + "\r\n\r\n"
+                           "Name: data.txt\r\nSHA-256-Digest: " + digest_of(jar_file.others.at("data.txt")) + "\r\n\r\n";
+    jar_file.manifest = Manifest::read_manifest(manifest);
+
+    std::string signature_file = "Signature-Version: 1.0\r\n\r\n";
+    for (const auto &section: jar_file.manifest.sections()) {
+        if (section.name().empty()) continue;
+        signature_file += "Name: " + std::string(section.name()) + "\r\nSHA-256-Digest: " + digest_of(section.raw)
+                          + "\r\n\r\n";
+    }
+    jar_file.add_entry("META-INF/SIGNER.SF", std::vector<uint8_t>(signature_file.begin(), signature_file.end()));
+
+    EXPECT_TRUE(JARSignature::verify(jar_file, 2).empty());
+
+    jar_file.others.at("data.txt")[0] = 'b';
+    jar_file.add_entry("unsigned.txt", {'x'});
+
+    std::vector<std::pair<std::string, std::string>> issues;
+    for (const auto &issue: JARSignature::verify(jar_file, 2)) {
+        issues.emplace_back(issue.entry, issue.message);
+    }
+
+    std::vector<std::pair<std::string, std::string>> expected{
+            {"data.txt", "The SHA-256 digest doesn't match the manifest."},
+            {"unsigned.txt", "The entry is not covered by the signature."}};
+    EXPECT_EQ(issues, expected);
+
+    // Older signers only write SHA1 digests, which cover the entries although they aren't verified.
+    auto sha1_signed = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    sha1_signed.manifest = Manifest::read_manifest("Manifest-Version: 1.0\r\n\r\nName: " + class_name
+                                                   + "\r\nSHA1-Digest: AAAA\r\n\r\n");
+    std::string sha1_signature = "Signature-Version: 1.0\r\nSHA1-Digest-Manifest: AAAA\r\n\r\n"
+                                 "Name: " + class_name + "\r\nSHA1-Digest: AAAA\r\n\r\n";
+    sha1_signed.add_entry("META-INF/OLD.SF", std::vector<uint8_t>(sha1_signature.begin(), sha1_signature.end()));
+    EXPECT_TRUE(JARSignature::verify(sha1_signed).empty());
+}
+
+TEST(ClassHierarchy, AnswersSubtypeQueries) {
+    JARFile jar_file;
+    jar_file.classes.emplace("A.class", make_class("A", "java/lang/Object", {"I"}));
+    jar_file.classes.emplace("B.class", make_class("B", "A", {}));
+    jar_file.classes.emplace("C.class", make_class("C", "B", {"java/io/Serializable"}));
+    jar_file.classes.emplace("D.class", make_class("D", "java/lang/Object", {}));
+    // E declares J again, which its superclass implements already.
+    jar_file.classes.emplace("E.class", make_class("E", "A", {"J"}));
+    jar_file.classes.emplace("I.class", make_class("I", "java/lang/Object", {"J"}, ClassFile::INTERFACE));
+    jar_file.classes.emplace("J.class", make_class("J", "java/lang/Object", {}, ClassFile::INTERFACE));
+
+    auto hierarchy = ClassHierarchy::build({{"app.jar", &jar_file}});
+    auto id = [&](const char *name) {
+        return hierarchy.find(name);
+    };
+
+    EXPECT_TRUE(hierarchy.is_subtype(id("C"), id("A")));
+    EXPECT_TRUE(hierarchy.is_subtype(id("C"), id("java/lang/Object")));
+    EXPECT_TRUE(hierarchy.is_subtype(id("C"), id("J")));
+    EXPECT_TRUE(hierarchy.is_subtype(id("C"), id("java/io/Serializable")));
+    EXPECT_TRUE(hierarchy.is_subtype(id("I"), id("J")));
+    EXPECT_TRUE(hierarchy.is_subtype(id("E"), id("J")));
+    EXPECT_TRUE(hierarchy.is_subtype(id("E"), id("I")));
+    EXPECT_FALSE(hierarchy.is_subtype(id("A"), id("B")));
+    EXPECT_FALSE(hierarchy.is_subtype(id("D"), id("I")));
+    EXPECT_TRUE(hierarchy.is_interface(id("java/io/Serializable")));
+
+    auto names = [&](const std::vector<uint32_t> &ids) {
+        std::vector<std::string_view> result;
+        for (auto subtype: ids) result.push_back(hierarchy.node(subtype).name);
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    EXPECT_EQ(names(hierarchy.subtypes(id("A"))), (std::vector<std::string_view>{"A", "B", "C", "E"}));
+    EXPECT_EQ(names(hierarchy.subtypes(id("J"))), (std::vector<std::string_view>{"A", "B", "C", "E", "I", "J"}));
+
+    auto direct = hierarchy.direct_subtypes(id("J"));
+    EXPECT_EQ(names({direct.begin(), direct.end()}), (std::vector<std::string_view>{"E", "I"}));
+    EXPECT_TRUE(hierarchy.check().empty());
+}
+
+// Adds a method with a Code attribute, the storage holds the attribute and has to outlive the class.
+static void add_method(ClassFile &class_file, const char *name, const char *descriptor, uint16_t access_flags,
+                       const std::vector<uint8_t> &code, std::vector<uint8_t> &storage) {
+    auto length = static_cast<uint32_t>(code.size());
+    storage = {0, 2, 0, 2, uint8_t(length >> 24), uint8_t(length >> 16), uint8_t(length >> 8), uint8_t(length)};
+    storage.insert(storage.end(), code.begin(), code.end());
+    storage.insert(storage.end(), {0, 0, 0, 0});
+
+    MethodInfo method_info;
+    method_info.access_flags = access_flags;
+    method_info.name_index = add_utf8(class_file, name);
+    method_info.descriptor_index = add_utf8(class_file, descriptor);
+    method_info.attributes_count = 1;
+    method_info.attributes.push_back({add_utf8(class_file, "Code"), static_cast<uint32_t>(storage.size()),
+                                      storage.data()});
+    class_file.methods.push_back(method_info);
+    class_file.method_count++;
+}
+
+static auto add_method_ref(ClassFile &class_file, const char *class_name, const char *name,
+                           const char *descriptor) -> uint16_t {
+    ConstantPoolInfo class_info;
+    class_info.tag = ConstantPoolInfo::CLASS;
+    class_info.info.class_info.name_index = add_utf8(class_file, class_name);
+    auto class_index = add_constant(class_file, class_info);
+
+    ConstantPoolInfo name_and_type;
+    name_and_type.tag = ConstantPoolInfo::NAME_AND_TYPE;
+    name_and_type.info.name_and_type_info = {add_utf8(class_file, name), add_utf8(class_file, descriptor)};
+    auto name_and_type_index = add_constant(class_file, name_and_type);
+
+    ConstantPoolInfo method_ref;
+    method_ref.tag = ConstantPoolInfo::METHOD_REF;
+    method_ref.info.field_method_info = {class_index, name_and_type_index};
+    return add_constant(class_file, method_ref);
+}
+
+TEST(CallGraph, ResolvesVirtualCalls) {
+    std::vector<std::vector<uint8_t>> storage(7);
+
+    JARFile jar_file;
+    auto &a = jar_file.classes.emplace("A.class", make_class("A", "java/lang/Object", {})).first->second;
+    add_method(a, "run", "()V", MethodInfo::PUBLIC, {0xb1}, storage[0]);
+    auto &b = jar_file.classes.emplace("B.class", make_class("B", "A", {})).first->second;
+    add_method(b, "run", "()V", MethodInfo::PUBLIC, {0xb1}, storage[1]);
+    auto &c = jar_file.classes.emplace("C.class", make_class("C", "A", {})).first->second;
+    add_method(c, "run", "()V", MethodInfo::PUBLIC, {0xb1}, storage[2]);
+    auto &d = jar_file.classes.emplace("D.class", make_class("D", "A", {})).first->second;
+    add_method(d, "<init>", "()V", MethodInfo::PUBLIC, {0xb1}, storage[5]);
+    add_method(d, "run", "()V", MethodInfo::PUBLIC, {0xb1}, storage[6]);
+
+    // new B; pop; aconst_null; invokevirtual A.run()V; invokestatic Main.helper()V; return
+    auto &main = jar_file.classes.emplace("Main.class", make_class("Main", "java/lang/Object", {})).first->second;
+    auto run = add_method_ref(main, "A", "run", "()V");
+    auto helper = add_method_ref(main, "Main", "helper", "()V");
+    ConstantPoolInfo b_info;
+    b_info.tag = ConstantPoolInfo::CLASS;
+    b_info.info.class_info.name_index = add_utf8(main, "B");
+    auto b_index = add_constant(main, b_info);
+
+    // D::new only creates instances through a constructor handle, there is no new instruction for it.
+    ConstantPoolInfo handle;
+    handle.tag = ConstantPoolInfo::METHOD_HANDLE;
+    handle.info.method_handle_info = {ConstantInfo::NewInvokeSpecial, add_method_ref(main, "D", "<init>", "()V")};
+    add_constant(main, handle);
+    add_method(main, "main", "()V", MethodInfo::PUBLIC | MethodInfo::STATIC,
+               {0xbb, uint8_t(b_index >> 8), uint8_t(b_index), 0x57, 0x01, 0xb6, uint8_t(run >> 8), uint8_t(run),
+                0xb8, uint8_t(helper >> 8), uint8_t(helper), 0xb1}, storage[3]);
+    add_method(main, "helper", "()V", MethodInfo::STATIC, {0xb1}, storage[4]);
+
+    auto hierarchy = ClassHierarchy::build({{"app.jar", &jar_file}});
+    auto rta = CallGraph::build(hierarchy, CallGraph::RTA);
+    auto method = [&](const char *class_name, const char *name) {
+        return rta.find(hierarchy.find(class_name), name, "()V");
+    };
+
+    auto main_id = rta.find(hierarchy.find("Main"), "main", "()V");
+    ASSERT_NE(main_id, CallGraph::NONE);
+    EXPECT_TRUE(rta.is_instantiated(hierarchy.find("B")));
+    EXPECT_TRUE(rta.is_instantiated(hierarchy.find("D")));
+    EXPECT_FALSE(rta.is_instantiated(hierarchy.find("A")));
+    EXPECT_FALSE(rta.is_instantiated(hierarchy.find("C")));
+
+    auto callees = rta.callees(main_id);
+    std::vector<uint32_t> expected{method("B", "run"), method("D", "run"), method("Main", "helper")};
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(std::vector<uint32_t>(callees.begin(), callees.end()), expected);
+
+    auto cha = CallGraph::build(hierarchy, CallGraph::CHA, 2);
+    callees = cha.callees(main_id);
+    expected = {method("A", "run"), method("B", "run"), method("C", "run"), method("D", "run"),
+                method("Main", "helper")};
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(std::vector<uint32_t>(callees.begin(), callees.end()), expected);
+    EXPECT_TRUE(cha.dynamic_sites(main_id).empty());
+}
+
+
+TEST(XrefIndex, UpdatesIncrementally) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    const auto *source = "org/example/Main.class";
+
+    XrefIndex index;
+    index.update(jar_file);
+    EXPECT_TRUE(index.contains(source));
+
+    auto println = XrefIndex::method_key("java/io/PrintStream", "println", "(Ljava/lang/String;)V");
+    auto usages = index.usages(println);
+    ASSERT_EQ(usages.size(), 1u);
+    EXPECT_EQ(usages[0].source, source);
+    EXPECT_EQ(usages[0].member, "main([Ljava/lang/String;)V");
+    EXPECT_NE(usages[0].offset, XrefIndex::NO_OFFSET);
+    EXPECT_FALSE(index.usages(XrefIndex::field_key("java/lang/System", "out", "Ljava/io/PrintStream;")).empty());
+
+    auto path = (std::filesystem::temp_directory_path() / "aresbc_xref.index").string();
+    index.save(path);
+    auto loaded = XrefIndex::load(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->usages(println), usages);
+    EXPECT_EQ(loaded->key_count(), index.key_count());
+
+    // Replacing the class drops its references, the superclass is referenced outside of code.
+    index.update(source, make_class("org/example/Main", "org/example/Base", {}));
+    EXPECT_TRUE(index.usages(println).empty());
+    usages = index.usages(XrefIndex::class_key("org/example/Base"));
+    ASSERT_EQ(usages.size(), 1u);
+    EXPECT_TRUE(usages[0].member.empty());
+
+    index.remove(source);
+    EXPECT_EQ(index.source_count(), 0u);
+    EXPECT_EQ(index.key_count(), 0u);
+
+    // Removed sources leave stale postings behind, which neither queries nor saved indices see.
+    for (const auto *name: {"a/One", "a/Two", "a/Three"}) {
+        index.update(std::string(name) + ".class", make_class(name, "org/example/Base", {}));
+    }
+    index.remove("a/One.class");
+    usages = index.usages(XrefIndex::class_key("org/example/Base"));
+    ASSERT_EQ(usages.size(), 2u);
+    EXPECT_EQ(usages[0].source, "a/Three.class");
+    EXPECT_EQ(usages[1].source, "a/Two.class");
+
+    index.save(path);
+    loaded = XrefIndex::load(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->usages(XrefIndex::class_key("org/example/Base")), usages);
+
+    index.remove("a/Two.class");
+    index.remove("a/Three.class");
+    EXPECT_EQ(index.key_count(), 0u);
+}
+
+
+TEST(Shrinker, RemovesUnreachableCode) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    jar_file.classes.emplace("org/example/Dead.class", make_class("org/example/Dead", "java/lang/Object", {}));
+    jar_file.classes.emplace("org/example/Anno.class", make_class("org/example/Anno", "java/lang/Object", {}));
+    jar_file.classes.emplace("org/example/Reader.class", make_class("org/example/Reader", "java/lang/Object", {}));
+    jar_file.classes.emplace("org/example/Item.class", make_class("org/example/Item", "java/lang/Object", {}));
+    auto &kept = jar_file.classes.emplace("org/other/Kept.class",
+                                          make_class("org/other/Kept", "java/lang/Object", {})).first->second;
+
+    // @Anno(using = Reader.class) on a method and a List<Item> signature only name the classes in UTF-8 constants.
+    std::vector<uint8_t> code_storage;
+    add_method(kept, "read", "()V", MethodInfo::PUBLIC, {0xb1}, code_storage);
+    auto type_index = add_utf8(kept, "Lorg/example/Anno;");
+    auto element_index = add_utf8(kept, "using");
+    auto value_index = add_utf8(kept, "Lorg/example/Reader;");
+    std::vector<uint8_t> annotations{0, 1, uint8_t(type_index >> 8), uint8_t(type_index), 0, 1,
+                                     uint8_t(element_index >> 8), uint8_t(element_index), 'c',
+                                     uint8_t(value_index >> 8), uint8_t(value_index)};
+    kept.methods.back().attributes.push_back({add_utf8(kept, "RuntimeVisibleAnnotations"),
+                                              static_cast<uint32_t>(annotations.size()), annotations.data()});
+    kept.methods.back().attributes_count++;
+
+    auto signature_index = add_utf8(kept, "Ljava/lang/Object;Ljava/lang/Iterable<Lorg/example/Item;>;");
+    std::vector<uint8_t> signature{uint8_t(signature_index >> 8), uint8_t(signature_index)};
+    kept.attributes.push_back({add_utf8(kept, "Signature"), 2, signature.data()});
+    kept.attributes_count++;
+
+    Shrinker::Options options;
+    options.keep = {"org/other/*"};
+    auto result = Shrinker::shrink(jar_file, options);
+    EXPECT_EQ(result.removed_classes, 1u);
+    EXPECT_TRUE(jar_file.classes.contains("org/other/Kept.class"));
+    EXPECT_TRUE(jar_file.classes.contains("org/example/Anno.class"));
+    EXPECT_TRUE(jar_file.classes.contains("org/example/Reader.class"));
+    EXPECT_TRUE(jar_file.classes.contains("org/example/Item.class"));
+
+    // Nothing calls the constructor of the main class, so it goes along with the constants only it used.
+    auto &class_file = jar_file.classes.at("org/example/Main.class");
+    ASSERT_EQ(class_file.methods.size(), 1u);
+    EXPECT_EQ(class_file.utf8(class_file.methods[0].name_index), "main");
+    EXPECT_EQ(result.removed_methods, 1u);
+    EXPECT_GT(result.removed_constants, 0u);
+
+    // The byte code is refreshed, so the byte based APIs see the shrunk class.
+    auto written = JARFile::read_class(class_file.byte_code, true);
+    EXPECT_EQ(written.methods.size(), 1u);
+    EXPECT_EQ(written.class_name(written.this_class), "org/example/Main");
+    EXPECT_TRUE(BytecodeVerifier::verify(written).empty());
+
+    options.keep.clear();
+    jar_file.manifest = {};
+    EXPECT_THROW((void) Shrinker::shrink(jar_file, options), std::invalid_argument);
+}
+
+TEST(Remapper, RenamesClassesAndMembers) {
+    auto remapper = Remapper::read_proguard("# comment\n"
+                                            "org.example.Util -> a.b:\n"
+                                            "    int count -> c\n"
+                                            "    1:4:java.lang.String[] split(java.lang.String,int):12:15 -> d\n");
+    remapper.add_relocation("org/example/", "x/");
+    EXPECT_EQ(remapper.map_class("org/example/Util"), "a/b");
+    EXPECT_EQ(remapper.map_class("org/example/Main"), "x/Main");
+    EXPECT_EQ(remapper.map_descriptor("([Lorg/example/Util;I)Ljava/lang/Object;"), "([La/b;I)Ljava/lang/Object;");
+    EXPECT_EQ(remapper.map_signature("<T:Lorg/example/Util;>Ljava/util/List<TT;>;"), "<T:La/b;>Ljava/util/List<TT;>;");
+    remapper.add_class("org/example/Util$Entry", "a/b$e");
+    EXPECT_EQ(remapper.map_signature("Lorg/example/Util<TT;>.Entry;"), "La/b<TT;>.e;");
+    EXPECT_EQ(remapper.map_member("org/example/Util", "split", "(Ljava/lang/String;I)[Ljava/lang/String;", true), "d");
+    EXPECT_EQ(remapper.map_member("org/example/Util", "count", "I", false), "c");
+    EXPECT_THROW((void) Remapper::read_proguard("    int count -> c\n"), std::invalid_argument);
+
+    // Record components and type annotations name classes too.
+    auto record = make_class("org/example/Point", "java/lang/Record", {});
+    auto component_name = add_utf8(record, "util");
+    auto descriptor = add_utf8(record, "Lorg/example/Util;");
+    auto signature = add_utf8(record, "Ljava/util/List<Lorg/example/Util;>;");
+    uint8_t record_info[] = {0, 1, 0, uint8_t(component_name), 0, uint8_t(descriptor), 0, 1,
+                             0, uint8_t(add_utf8(record, "Signature")), 0, 0, 0, 2, 0, uint8_t(signature)};
+    uint8_t annotation_info[] = {0, 1, 0x10, 0, 0, 0, 0, uint8_t(descriptor), 0, 0};
+    record.attributes.push_back({add_utf8(record, "Record"), sizeof(record_info), record_info});
+    record.attributes.push_back({add_utf8(record, "RuntimeVisibleTypeAnnotations"), sizeof(annotation_info),
+                                 annotation_info});
+    record.attributes_count = 2;
+
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    jar_file.classes.emplace("org/example/Point.class", std::move(record));
+    jar_file.streamed.emplace("org/example/large.bin", JARFile::StreamedEntry{"large.bin", -1, 1});
+    remapper.apply(jar_file);
+    ASSERT_TRUE(jar_file.classes.contains("x/Main.class"));
+    EXPECT_TRUE(jar_file.streamed.contains("x/large.bin"));
+    EXPECT_FALSE(jar_file.streamed.contains("org/example/large.bin"));
+    EXPECT_EQ(jar_file.manifest.value("Main-Class"), "x.Main");
+
+    const auto &point = jar_file.classes.at("x/Point.class");
+    std::span<const uint8_t> record_data(point.attributes[0].info, point.attributes[0].attribute_length);
+    std::span<const uint8_t> annotation_data(point.attributes[1].info, point.attributes[1].attribute_length);
+    EXPECT_EQ(point.utf8(Bytecode::read_u16(record_data, 4)), "La/b;");
+    EXPECT_EQ(point.utf8(Bytecode::read_u16(record_data, 14)), "Ljava/util/List<La/b;>;");
+    EXPECT_EQ(point.utf8(Bytecode::read_u16(annotation_data, 6)), "La/b;");
+
+    // A renamed entry must not replace one that already has the name.
+    Remapper clash;
+    clash.add_relocation("org/other/", "org/example/");
+    JARFile clashing;
+    clashing.classes.emplace("org/example/A.class", make_class("org/example/A", "java/lang/Object", {}));
+    clashing.classes.emplace("org/other/A.class", make_class("org/other/A", "java/lang/Object", {}));
+    std::string provider = "org.other.A\n";
+    std::vector<uint8_t> service(provider.begin(), provider.end());
+    clashing.others.emplace("META-INF/services/org.other.Service", service);
+    EXPECT_THROW(clash.apply(clashing), std::runtime_error);
+
+    // The rename is refused before anything is changed.
+    ASSERT_EQ(clashing.classes.size(), 2u);
+    for (const auto *name: {"org/example/A", "org/other/A"}) {
+        const auto &class_file = clashing.classes.at(std::string(name) + ".class");
+        EXPECT_EQ(class_file.class_name(class_file.this_class), name);
+    }
+    ASSERT_EQ(clashing.others.size(), 1u);
+    EXPECT_EQ(clashing.others.at("META-INF/services/org.other.Service"), service);
+
+    // Streamed entries share the names with the loaded ones.
+    JARFile streaming;
+    streaming.others.emplace("org/other/data.bin", service);
+    streaming.streamed.emplace("org/example/data.bin", JARFile::StreamedEntry{"data.bin", -1, 1});
+    EXPECT_THROW(clash.apply(streaming), std::runtime_error);
+    EXPECT_TRUE(streaming.others.contains("org/other/data.bin"));
+    EXPECT_TRUE(streaming.streamed.contains("org/example/data.bin"));
+
+    auto written = JARFile::read_class(jar_file.classes.at("x/Main.class").byte_code, true);
+    EXPECT_EQ(written.class_name(written.this_class), "x/Main");
+    EXPECT_TRUE(BytecodeVerifier::verify(written).empty());
+}
+
+TEST(JARMerger, MergesDuplicatesAndServices) {
+    auto directory = std::filesystem::temp_directory_path();
+    auto first_path = (directory / "aresbc_merge_first.jar").string();
+    auto second_path = (directory / "aresbc_merge_second.jar").string();
+    auto merged_path = (directory / "aresbc_merged.jar").string();
+
+    auto bytes = [](std::string_view value) {
+        return std::vector<uint8_t>(value.begin(), value.end());
+    };
+
+    auto first = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    first.others.emplace("config.properties", bytes("a=1"));
+    first.others.emplace("META-INF/services/a.Service", bytes("a.First\n"));
+    first.write_file(first_path);
+
+    auto second = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    second.others.emplace("config.properties", bytes("a=2"));
+    second.others.emplace("META-INF/services/a.Service", bytes("# providers\na.Second\na.First\n"));
+    second.manifest = {};
+    second.manifest.set("Manifest-Version", "1.0");
+    second.manifest.set("Automatic-Module-Name", "second");
+    second.write_file(second_path);
+
+    auto result = JARMerger::merge({first_path, second_path}, {});
+    EXPECT_EQ(result.identical_duplicates, 1u);
+    ASSERT_EQ(result.conflicts.size(), 1u);
+    EXPECT_EQ(result.conflicts[0].name, "config.properties");
+    EXPECT_EQ(result.conflicts[0].kept, first_path);
+    EXPECT_EQ(result.jar_file.manifest.value("Main-Class"), "org.example.Main");
+    EXPECT_EQ(result.jar_file.manifest.value("Automatic-Module-Name"), "second");
+
+    result.jar_file.write_file(merged_path);
+    auto merged = JARFile::read_file(merged_path);
+    EXPECT_TRUE(merged.classes.contains("org/example/Main.class"));
+    EXPECT_EQ(merged.others.at("config.properties"), bytes("a=1"));
+    EXPECT_EQ(merged.others.at("META-INF/services/a.Service"), bytes("a.First\na.Second\n"));
+
+    JARMerger::Options options;
+    options.compare_contents = true;
+    auto compared = JARMerger::merge({first_path, second_path}, options);
+    EXPECT_EQ(compared.identical_duplicates, 1u);
+    EXPECT_EQ(compared.conflicts.size(), 1u);
+
+    options.duplicates = JARMerger::FAIL;
+    EXPECT_THROW((void) JARMerger::merge({first_path, second_path}, options), std::runtime_error);
+
+    std::filesystem::remove(first_path);
+    std::filesystem::remove(second_path);
+    std::filesystem::remove(merged_path);
+}
+
+TEST(StringSearch, FindsPatternsInConstants) {
+    StringSearch search({"java/io/", "io/Print", "Hello", "missing"});
+    EXPECT_EQ(search.pattern_count(), 4u);
+    EXPECT_THROW(StringSearch({""}), std::invalid_argument);
+
+    auto count = [](const std::vector<StringSearch::Match> &matches, uint32_t pattern) {
+        return std::count_if(matches.begin(), matches.end(), [&](const StringSearch::Match &match) {
+            return match.pattern == pattern;
+        });
+    };
+
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto matches = search.search(jar_file);
+    EXPECT_EQ(count(matches, 0), 2);
+    EXPECT_EQ(count(matches, 1), 2);
+    EXPECT_EQ(count(matches, 2), 1);
+    EXPECT_EQ(count(matches, 3), 0);
+    EXPECT_EQ(matches.front().class_name, "org/example/Main.class");
+
+    // A constant long enough for the vector kernel, with overlapping matches behind a block without candidates.
+    auto &class_file = jar_file.classes.at("org/example/Main.class");
+    std::string text = std::string(40, 'x') + "java/io/PrintStream";
+
+    ConstantPoolInfo info;
+    info.tag = ConstantPoolInfo::UTF_8;
+    info.info.utf8_info = {static_cast<uint16_t>(text.size()), reinterpret_cast<uint8_t *>(text.data())};
+    class_file.constant_pool.push_back(info);
+
+    matches = search.search(class_file);
+    ASSERT_EQ(matches.size(), 7u);
+    EXPECT_EQ(matches[5].constant_index, class_file.constant_pool.size());
+    EXPECT_EQ(matches[5].pattern, 0u);
+    EXPECT_EQ(matches[5].offset, 40u);
+    EXPECT_EQ(matches[6].pattern, 1u);
+    EXPECT_EQ(matches[6].offset, 45u);
+}
+
+TEST(DependencyExtractor, MatchesClassSummaries) {
+    auto graph = DependencyExtractor::extract_jar(TEST_PATH "/resources/hello_world_in.jar", 2);
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto loaded_graph = DependencyExtractor::extract_jar(jar_file);
+    EXPECT_EQ(graph.classes, loaded_graph.classes);
+    EXPECT_EQ(graph.class_edges, loaded_graph.class_edges);
+    EXPECT_EQ(graph.package_edges, loaded_graph.package_edges);
+
+    // The constant pool alone yields the same classes as a full parse.
+    const auto &class_file = jar_file.classes.at("org/example/Main.class");
+    auto summary = ClassSummary::from_class(class_file);
+    auto main_id = graph.find_class("org/example/Main");
+    ASSERT_NE(main_id, DependencyGraph::MISSING);
+
+    std::vector<std::string> referenced;
+    for (auto edge: graph.class_edges) {
+        if (edge.from == main_id) referenced.push_back(graph.classes[edge.to]);
+    }
+    EXPECT_EQ(referenced, summary.referenced_classes);
+
+    auto from = graph.find_package("org/example");
+    auto to = graph.find_package("java/lang");
+    EXPECT_TRUE(std::binary_search(graph.package_edges.begin(), graph.package_edges.end(),
+                                   DependencyGraph::Edge{from, to}));
+    EXPECT_EQ(graph.find_package("org"), DependencyGraph::MISSING);
+
+    const auto &byte_code = class_file.byte_code;
+    auto dependencies = DependencyExtractor::extract_class(byte_code.data(), byte_code.size());
+    ASSERT_TRUE(dependencies.has_value());
+    EXPECT_EQ(dependencies->name, "org/example/Main");
+    EXPECT_FALSE(DependencyExtractor::extract_class(byte_code.data(), 64).has_value());
+}
+
+TEST(JARDiff, ComparesConstantsSemantically) {
+    auto directory = std::filesystem::temp_directory_path();
+    auto old_path = (directory / "aresbc_diff_old.jar").string();
+    auto new_path = (directory / "aresbc_diff_new.jar").string();
+
+    auto bytes = [](std::string_view value) {
+        return std::vector<uint8_t>(value.begin(), value.end());
+    };
+    auto find_attribute = [](ClassFile &class_file, std::string_view name) -> AttributeInfo & {
+        auto &attributes = class_file.attributes;
+        return *std::find_if(attributes.begin(), attributes.end(), [&](const AttributeInfo &info) {
+            return class_file.utf8(info.attribute_name_index) == name;
+        });
+    };
+    auto set_u16 = [](uint8_t *data, uint16_t value) {
+        data[0] = value >> 8;
+        data[1] = value & 0xFF;
+    };
+
+    auto old_jar = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    old_jar.others.emplace("config.properties", bytes("a=1"));
+    old_jar.others.emplace("removed.txt", bytes("x"));
+    old_jar.write_file(old_path);
+
+    // Pointing SourceFile at a copy of its constant changes the bytes, but not the meaning.
+    auto new_jar = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    new_jar.others.emplace("config.properties", bytes("a=2"));
+    auto &class_file = new_jar.classes.at("org/example/Main.class");
+    set_u16(find_attribute(class_file, "SourceFile").info, add_utf8(class_file, "Main.java"));
+    class_file.methods.back().access_flags |= MethodInfo::FINAL;
+    new_jar.write_file(new_path);
+
+    std::vector<JARDiff::Change> expected{
+            {JARDiff::REMOVED, "removed.txt", "", ""},
+            {JARDiff::CHANGED, "config.properties", "", ""},
+            {JARDiff::CHANGED, "org/example/Main.class", "main([Ljava/lang/String;)V", "access_flags"},
+    };
+    EXPECT_EQ(JARDiff::diff_files(old_path, new_path, 2), expected);
+    EXPECT_EQ(JARDiff::diff(JARFile::read_file(old_path), JARFile::read_file(new_path)), expected);
+    EXPECT_TRUE(JARDiff::diff_files(old_path, old_path).empty());
+    EXPECT_EQ(JARDiff::format({expected[0]}), "REMOVED\tremoved.txt\t\t\n");
+
+    const auto &old_class = old_jar.classes.at("org/example/Main.class");
+    set_u16(find_attribute(class_file, "SourceFile").info, add_utf8(class_file, "Other.java"));
+    class_file.methods.erase(class_file.methods.begin());
+
+    auto changes = JARDiff::diff_class("Main.class", old_class, class_file);
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].member, "<init>()V");
+    EXPECT_EQ(changes[0].kind, JARDiff::REMOVED);
+    EXPECT_EQ(changes[1].detail, "attribute SourceFile");
+    EXPECT_EQ(changes[2].detail, "access_flags");
+
+    std::filesystem::remove(old_path);
+    std::filesystem::remove(new_path);
+}
+
+TEST(ABIFingerprint, IgnoresImplementationChanges) {
+    auto jar_file = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    auto &class_file = jar_file.classes.at("org/example/Main.class");
+
+    auto hash_of = [](ClassFile &class_file) {
+        ClassWriter writer;
+        writer.visit_class(class_file);
+        return ABIFingerprint::hash_class(writer.byte_code().data(), writer.byte_code().size());
+    };
+
+    auto original = ABIFingerprint::hash_class(class_file.byte_code.data(), class_file.byte_code.size());
+    ASSERT_TRUE(original.has_value());
+    EXPECT_TRUE(original->exported);
+    EXPECT_FALSE(ABIFingerprint::hash_class(class_file.byte_code.data(), 64).has_value());
+
+    // Constants only used by code and debug attributes aren't part of the ABI.
+    auto byte_code = class_file.byte_code;
+    for (std::string_view text: {"Hello, World!", "Main.java"}) {
+        auto found = std::search(byte_code.begin(), byte_code.end(), text.begin(), text.end());
+        ASSERT_NE(found, byte_code.end());
+        *found = 'X';
+    }
+    EXPECT_EQ(ABIFingerprint::hash_class(byte_code.data(), byte_code.size())->hash, original->hash);
+
+    auto &constructor = class_file.methods.front();
+    constructor.access_flags = MethodInfo::PRIVATE;
+    auto private_hash = hash_of(class_file)->hash;
+    EXPECT_NE(private_hash, original->hash);
+
+    constructor.descriptor_index = add_utf8(class_file, "(I)V");
+    EXPECT_EQ(hash_of(class_file)->hash, private_hash);
+
+    class_file.methods.back().access_flags |= MethodInfo::SYNCHRONIZED;
+    EXPECT_EQ(hash_of(class_file)->hash, private_hash);
+    class_file.methods.back().access_flags |= MethodInfo::FINAL;
+    EXPECT_NE(hash_of(class_file)->hash, private_hash);
+
+    auto jar_hash = ABIFingerprint::hash_jar(TEST_PATH "/resources/hello_world_in.jar", 2);
+    auto unchanged = JARFile::read_file(TEST_PATH "/resources/hello_world_in.jar");
+    unchanged.others.emplace("config.properties", std::vector<uint8_t>{'a'});
+    EXPECT_EQ(ABIFingerprint::hash_jar(unchanged), jar_hash);
+    EXPECT_NE(ABIFingerprint::hash_jar(JARFile{}), jar_hash);
+}
+
 //==============================================================================
 // BSD 3-Clause License
 //